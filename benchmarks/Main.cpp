@@ -0,0 +1,11 @@
+#include "common/Benchmark.hpp"
+
+#include <cero/driver/Environment.hpp>
+
+int main(int argc, char* argv[]) {
+	cero::initialize_environment();
+
+	// benchmarks are selected by a part of their name, since running all of them takes a while
+	std::string_view filter = argc > 1 ? argv[1] : "";
+	return benchmarks::run_benchmarks(filter);
+}
@@ -0,0 +1,65 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <vector>
+
+namespace benchmarks {
+
+Timing measure(cero::FunctionRef<void()> work, uint32_t num_runs) {
+	work();
+
+	std::vector<double> durations;
+	for (uint32_t i = 0; i != num_runs; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		work();
+		const auto end = std::chrono::steady_clock::now();
+		durations.emplace_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	std::ranges::sort(durations);
+	return Timing {durations.front(), durations[durations.size() / 2]};
+}
+
+void print_timing(std::string_view label, Timing timing, size_t num_bytes) {
+	fmt::print("  {:<40} best {:8.2f} ms  median {:8.2f} ms", label, timing.best, timing.median);
+	if (num_bytes != 0) {
+		fmt::print("  {:8.1f} MB/s", static_cast<double>(num_bytes) / timing.best / 1000.0);
+	}
+	fmt::print("\n");
+}
+
+void CountingReporter::handle_report(cero::MessageLevel, cero::CodeLocation, std::string) {
+	++num_reports;
+}
+
+static std::map<std::string_view, void (*)()>& get_benchmarks() {
+	static std::map<std::string_view, void (*)()> benchmarks;
+	return benchmarks;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(std::string_view name, void (*function)()) {
+	get_benchmarks().emplace(name, function);
+}
+
+int run_benchmarks(std::string_view filter) {
+	uint32_t num_run = 0;
+	for (auto& [name, function] : get_benchmarks()) {
+		if (name.find(filter) == std::string_view::npos) {
+			continue;
+		}
+
+		fmt::print("{}\n", name);
+		function();
+		++num_run;
+	}
+
+	if (num_run == 0) {
+		fmt::print("No benchmark matches \"{}\".\n", filter);
+		return 1;
+	}
+	return 0;
+}
+
+} // namespace benchmarks
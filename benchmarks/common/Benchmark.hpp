@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cero/io/Reporter.hpp>
+#include <cero/util/FunctionRef.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+namespace benchmarks {
+
+/// Durations of repeated runs of the same work, in milliseconds.
+struct Timing {
+	double best = 0;
+	double median = 0;
+};
+
+/// Runs the work once to warm up, then the given number of times, measuring how long each of those runs takes.
+Timing measure(cero::FunctionRef<void()> work, uint32_t num_runs = 7);
+
+/// Prints one measurement of the running benchmark. If the number of processed bytes is given, the throughput is printed too.
+void print_timing(std::string_view label, Timing timing, size_t num_bytes = 0);
+
+/// A reporter that only counts the reports, so that printing diagnostics does not distort the measurements.
+class CountingReporter : public cero::Reporter {
+public:
+	uint32_t num_reports = 0;
+
+private:
+	void handle_report(cero::MessageLevel message_level, cero::CodeLocation location, std::string message_text) override;
+};
+
+/// Registers a benchmark, so that it is run by run_benchmarks.
+struct BenchmarkRegistration {
+	BenchmarkRegistration(std::string_view name, void (*function)());
+};
+
+/// Runs every registered benchmark whose name contains the filter, in the order of their names. Returns the exit code.
+int run_benchmarks(std::string_view filter);
+
+/// Creates and registers a benchmark.
+#define CERO_BENCHMARK(NAME)                                                                                                   \
+	static void NAME();                                                                                                        \
+	static const benchmarks::BenchmarkRegistration NAME##Registration(#NAME, NAME);                                            \
+	static void NAME()
+
+} // namespace benchmarks
@@ -0,0 +1,46 @@
+#include "Sources.hpp"
+
+namespace benchmarks {
+
+std::string make_regular_source_text(size_t length) {
+	std::string text;
+	text.reserve(length + 512);
+	for (uint32_t i = 0; text.length() < length; ++i) {
+		text += fmt::format(R"_____(public f{0}(Point a, ^var Point b = Point(), in int32 c) -> float64 {{
+	let s = "text with \"escapes\"";
+	let n = 0x3 + 4.5 + 'c';
+	var x = a.x - b.x * 2;
+	if x > 0 {{
+		return List<int32>(x);
+	}}
+	// a comment
+	return (x, y);
+}}
+)_____",
+							i);
+	}
+	return text;
+}
+
+std::string make_punctuation_source_text(size_t length) {
+	constexpr std::string_view lines[] {
+		"( ) { } ; , = + * -> += < [ ]\n",
+		"a <<= b >>= c != d == e && f || g ** h\n",
+		"x += y -= z *= w /= v %= u ^= t &= s |= r\n",
+		"p.q :: r => s ... t -- u ++ v ! w ~ x ^ y\n",
+	};
+
+	std::string text;
+	text.reserve(length + 64);
+	for (size_t i = 0; text.length() < length; ++i) {
+		text += lines[i % std::size(lines)];
+	}
+	return text;
+}
+
+cero::SourceGuard make_source(std::string_view text) {
+	cero::Configuration config;
+	return cero::Source::from_string("benchmark", text, config).lock().or_throw();
+}
+
+} // namespace benchmarks
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cero/io/Source.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace benchmarks {
+
+/// Generates source code of at least the given length out of function definitions like those of typical code, each with its
+/// own name.
+std::string make_regular_source_text(size_t length);
+
+/// Generates source code of at least the given length that consists mostly of operators and punctuation, which stresses the
+/// lexing of operators. It is not meant to be parsed.
+std::string make_punctuation_source_text(size_t length);
+
+/// Creates a source from the given text, which is locked for as long as the returned guard lives.
+cero::SourceGuard make_source(std::string_view text);
+
+} // namespace benchmarks
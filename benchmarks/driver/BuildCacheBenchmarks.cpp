@@ -0,0 +1,47 @@
+#include "common/Benchmark.hpp"
+#include "common/Sources.hpp"
+
+#include <cero/driver/BuildCache.hpp>
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/Parse.hpp>
+#include <cero/util/Fail.hpp>
+
+#include <filesystem>
+
+namespace benchmarks {
+
+// Builds a source the way the build command does without the cache, with a cache that has no entry for it yet, which lexes and
+// parses the source and stores an entry, and with a cache that already has one, which only loads it.
+CERO_BENCHMARK(BuildWithCache) {
+	const auto directory = std::filesystem::temp_directory_path() / "cero-benchmark-cache";
+	std::filesystem::remove_all(directory);
+
+	const auto text = make_regular_source_text(9 * 1000 * 1000);
+	const auto source = make_source(text);
+	const cero::Configuration config;
+	const cero::BuildCache cache(directory.string());
+
+	CountingReporter reporter;
+	auto timing = measure([&] { std::ignore = cero::parse(source, reporter); });
+	print_timing("build without cache", timing, text.length());
+
+	timing = measure([&] {
+		const auto key = cero::CacheKey::of(source, config);
+		const auto token_stream = cero::lex(source, reporter, cero::CommentMode::Discard);
+		const auto ast = cero::parse(token_stream, source, reporter);
+		cero::check(cache.store(key, source, token_stream, ast), "entry must be stored");
+	});
+	print_timing("build storing an entry", timing, text.length());
+
+	timing = measure([&] {
+		const auto key = cero::CacheKey::of(source, config);
+		cero::check(cache.load(key, source).has_value(), "entry must be loaded");
+	});
+	print_timing("build loading an entry", timing, text.length());
+
+	const auto entry_path = directory / cero::CacheKey::of(source, config).to_string();
+	fmt::print("  entry of {} bytes for {} bytes of source\n", std::filesystem::file_size(entry_path), text.length());
+	std::filesystem::remove_all(directory);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,112 @@
+#include "common/Benchmark.hpp"
+
+#include <cero/io/Source.hpp>
+#include <cero/io/SourceLoader.hpp>
+#include <cero/util/Fail.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace benchmarks {
+
+// Loads many small files, once by always mapping them and once by reading the ones below the default threshold into buffers
+// from the read buffer pool. The files stay in the page cache between runs, so this measures the cost of loading a file rather
+// than that of the disk.
+CERO_BENCHMARK(LoadSmallFiles) {
+	const auto directory = std::filesystem::temp_directory_path() / "cero-benchmark-small-files";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	std::mt19937 random(1);
+	std::vector<std::string> paths;
+	for (uint32_t i = 0; i != 20000; ++i) {
+		auto path = (directory / fmt::format("{}.ce", i)).string();
+		std::ofstream(path) << std::string(100 + random() % 8192, 'a');
+		paths.emplace_back(std::move(path));
+	}
+	fmt::print("  {} files of 100 to 8291 bytes\n", paths.size());
+
+	for (uint32_t mmap_threshold : {0u, cero::Configuration::DefaultMmapThreshold}) {
+		cero::Configuration config;
+		config.mmap_threshold = mmap_threshold;
+
+		auto timing = measure([&] {
+			size_t sum = 0;
+			for (auto& path : paths) {
+				auto source = cero::Source::from_file(path, config);
+				auto guard = source.lock().or_throw();
+				for (char c : guard.get_text()) {
+					sum += static_cast<unsigned char>(c);
+				}
+			}
+			cero::check(sum != 0, "sources must not be empty");
+		});
+		print_timing(fmt::format("load with mmap threshold {}", mmap_threshold), timing);
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+// Loads many small files in list order, once by locking them one after another and once through a SourceLoader with each of
+// its methods. The files stay in the page cache between runs, so this measures the overhead of loading ahead of time rather
+// than what is gained by overlapping processing with waiting on the disk.
+CERO_BENCHMARK(LoadSourcesAhead) {
+	const auto directory = std::filesystem::temp_directory_path() / "cero-benchmark-load-ahead";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	std::mt19937 random(1);
+	std::vector<std::string> paths;
+	for (uint32_t i = 0; i != 20000; ++i) {
+		auto path = (directory / fmt::format("{}.ce", i)).string();
+		std::ofstream(path) << std::string(100 + random() % 8192, 'a');
+		paths.emplace_back(std::move(path));
+	}
+
+	cero::Configuration config;
+	std::vector<cero::Source> sources;
+	for (auto& path : paths) {
+		sources.emplace_back(cero::Source::from_file(path, config));
+	}
+	fmt::print("  {} files of 100 to 8291 bytes\n", paths.size());
+
+	auto sum_text = [](const cero::SourceGuard& guard) {
+		size_t sum = 0;
+		for (char c : guard.get_text()) {
+			sum += static_cast<unsigned char>(c);
+		}
+		return sum;
+	};
+
+	auto timing = measure([&] {
+		size_t sum = 0;
+		for (auto& source : sources) {
+			sum += sum_text(source.lock().or_throw());
+		}
+		cero::check(sum != 0, "sources must not be empty");
+	});
+	print_timing("lock one after another", timing);
+
+	for (auto method : {cero::SourceLoadMethod::IoRing, cero::SourceLoadMethod::Threads}) {
+		const auto name = method == cero::SourceLoadMethod::IoRing ? "io_uring" : "threads";
+		if (cero::SourceLoader(sources, method).get_method() != method) {
+			fmt::print("  {} not available\n", name);
+			continue;
+		}
+
+		timing = measure([&] {
+			size_t sum = 0;
+			cero::SourceLoader loader(sources, method);
+			while (loader.has_next()) {
+				sum += sum_text(loader.next().or_throw());
+			}
+			cero::check(sum != 0, "sources must not be empty");
+		});
+		print_timing(fmt::format("load ahead with {}", name), timing);
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,45 @@
+#include "common/Benchmark.hpp"
+#include "common/Sources.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/util/ThreadPool.hpp>
+
+namespace benchmarks {
+
+// Lexes regular code, where names and literals make up most of the tokens, and text made only of operators and brackets,
+// which exercises the lexing of operators.
+CERO_BENCHMARK(LexThroughput) {
+	const std::pair<std::string_view, std::string> inputs[] {
+		{"lex regular code", make_regular_source_text(15 * 1000 * 1000)},
+		{"lex punctuation", make_punctuation_source_text(15 * 1000 * 1000)},
+	};
+
+	CountingReporter reporter;
+	for (auto& [label, text] : inputs) {
+		const auto source = make_source(text);
+		auto timing = measure([&] { std::ignore = cero::lex(source, reporter, cero::CommentMode::Discard); });
+		print_timing(label, timing, text.length());
+	}
+}
+
+// Compares lexing on the calling thread with lexing in parallel on pools of growing size. With fewer cores than threads, the
+// parallel timings only show the overhead of splitting the source and stitching the chunks back together.
+CERO_BENCHMARK(LexParallelScaling) {
+	const auto text = make_regular_source_text(15 * 1000 * 1000);
+	const auto source = make_source(text);
+	fmt::print("  source of {} bytes, {} hardware threads\n", text.length(), std::thread::hardware_concurrency());
+
+	CountingReporter reporter;
+	auto sequential = measure([&] { std::ignore = cero::lex(source, reporter, cero::CommentMode::Discard); });
+	print_timing("lex", sequential, text.length());
+
+	for (uint32_t num_threads : {1u, 2u, 4u, 8u}) {
+		cero::ThreadPool thread_pool(num_threads);
+		auto parallel = measure([&] {
+			std::ignore = cero::lex_parallel(source, reporter, cero::CommentMode::Discard, thread_pool);
+		});
+		print_timing(fmt::format("lex_parallel with {} threads", num_threads), parallel, text.length());
+	}
+}
+
+} // namespace benchmarks
@@ -0,0 +1,53 @@
+#include "common/Benchmark.hpp"
+#include "common/Sources.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/Parse.hpp>
+#include <cero/syntax/TokenCursor.hpp>
+#include <cero/util/ThreadPool.hpp>
+
+namespace benchmarks {
+
+// Parses token streams of a compact source and of a source that spans several source segments, whose token cursors have to
+// keep track of the segment they are in.
+CERO_BENCHMARK(ParseTokenStream) {
+	fmt::print("  token cursor of {} bytes\n", sizeof(cero::TokenCursor));
+
+	const std::pair<std::string_view, std::string> inputs[] {
+		{"parse compact source", make_regular_source_text(15 * 1000 * 1000)},
+		{"parse source of 3 segments", make_regular_source_text(40 * 1000 * 1000)},
+	};
+
+	CountingReporter reporter;
+	for (auto& [label, text] : inputs) {
+		const auto source = make_source(text);
+		const auto token_stream = cero::lex(source, reporter, cero::CommentMode::Discard);
+		auto timing = measure([&] { std::ignore = cero::parse(token_stream, source, reporter); });
+		print_timing(label, timing, text.length());
+	}
+}
+
+// Compares parsing on the calling thread with parsing in parallel on pools of growing size. The source holds a for-loop in a
+// function that the parser skips while recovering from an error, which used to make parallel parsing give up on the entire
+// token stream. With fewer cores than threads, the parallel timings only show the overhead of parsing in chunks and stitching
+// them back together.
+CERO_BENCHMARK(ParseParallelScaling) {
+	auto text = make_regular_source_text(15 * 1000 * 1000);
+	text += "public e( { } f() {\n\tfor x in y { }\n}\n";
+	text += make_regular_source_text(1000);
+	const auto source = make_source(text);
+	fmt::print("  source of {} bytes, {} hardware threads\n", text.length(), std::thread::hardware_concurrency());
+
+	CountingReporter reporter;
+	const auto token_stream = cero::lex(source, reporter, cero::CommentMode::Discard);
+	auto sequential = measure([&] { std::ignore = cero::parse(token_stream, source, reporter); });
+	print_timing("parse", sequential, text.length());
+
+	for (uint32_t num_threads : {1u, 2u, 4u, 8u}) {
+		cero::ThreadPool thread_pool(num_threads);
+		auto parallel = measure([&] { std::ignore = cero::parse_parallel(token_stream, source, reporter, thread_pool); });
+		print_timing(fmt::format("parse_parallel with {} threads", num_threads), parallel, text.length());
+	}
+}
+
+} // namespace benchmarks
@@ -0,0 +1,155 @@
+#include "BuildCache.hpp"
+
+#include "cero/util/BinaryStream.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+namespace cero {
+
+// identifies cache entries, so that unrelated files that happen to be in the cache directory are never read as entries
+static constexpr uint32_t EntryMagic = 0x43524543; // "CERC" in little-endian byte order
+
+// seed of the second hash of the source in each entry, which is independent of the one in the key, so that an entry is never
+// used for another source whose key merely collides with the key of the one the entry was stored for
+static constexpr uint64_t SourceCheckSeed = 0x9E3779B185EBCA8D;
+
+/// The length and the second hash of a source, which are stored after the key of an entry and compared when it is loaded.
+struct SourceCheck {
+	uint64_t length = 0;
+	ContentHash hash;
+
+	static SourceCheck of(const SourceGuard& source) {
+		const auto text = source.get_text();
+		return SourceCheck {text.length(), ContentHash::of(text, SourceCheckSeed)};
+	}
+
+	bool operator==(const SourceCheck&) const = default;
+};
+
+// the temporary file of an entry is named after the entry, followed by this many random hexadecimal digits and TempExtension
+static constexpr size_t TempSuffixDigits = 16;
+static constexpr std::string_view TempExtension = ".tmp";
+
+/// Whether the file name consists of the given number of lowercase hexadecimal digits at the given position.
+static bool has_hex_digits(std::string_view name, size_t position, size_t num_digits) {
+	return name.length() >= position + num_digits && std::ranges::all_of(name.substr(position, num_digits), [](char c) {
+			   return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+		   });
+}
+
+/// Whether the file name is that of an entry, or that of the temporary file that an entry is written to before it is renamed.
+static bool is_entry_file_name(std::string_view name) {
+	const auto entry_length = CacheKey().to_string().length();
+	if (name.length() == entry_length) {
+		return has_hex_digits(name, 0, entry_length);
+	}
+
+	const auto temp_length = entry_length + 1 + TempSuffixDigits + TempExtension.length();
+	return name.length() == temp_length && has_hex_digits(name, 0, entry_length) && name[entry_length] == '.'
+		   && has_hex_digits(name, entry_length + 1, TempSuffixDigits) && name.ends_with(TempExtension);
+}
+
+BuildCache::BuildCache(std::string_view directory) :
+	directory_(directory) {
+}
+
+std::optional<CachedSyntax> BuildCache::load(const CacheKey& key, const SourceGuard& source) const {
+	// entries are always mapped, since their contents are viewed in place
+	auto mapping = FileMapping::from(get_entry_path(key).string(), 0);
+	if (!mapping) {
+		return std::nullopt;
+	}
+
+	BinaryReader reader(mapping.value()->get_text());
+	uint32_t magic, format_version;
+	CacheKey stored_key;
+	SourceCheck stored_check;
+	if (!reader.read(magic) || !reader.read(format_version) || !reader.read(stored_key) || !reader.read(stored_check)
+		|| magic != EntryMagic || format_version != CacheKey::FormatVersion || stored_key != key
+		|| stored_check != SourceCheck::of(source)) {
+		return std::nullopt;
+	}
+
+	auto token_stream = TokenStreamBinaryView::from(reader);
+	if (!token_stream) {
+		return std::nullopt;
+	}
+	auto ast = AstBinaryView::from(reader, source);
+	if (!ast || reader.num_remaining_bytes() != 0) {
+		return std::nullopt;
+	}
+	return CachedSyntax {std::move(*mapping.value()), *token_stream, *ast};
+}
+
+bool BuildCache::store(const CacheKey& key,
+					   const SourceGuard& source,
+					   const TokenStream& token_stream,
+					   const Ast& ast) const {
+	// entries take up about twice as many bytes as the source, so reserving that much keeps the writer from reallocating
+	BinaryWriter writer;
+	writer.reserve(source.get_length() * 2);
+	writer.write(EntryMagic);
+	writer.write(CacheKey::FormatVersion);
+	writer.write(key);
+	writer.write(SourceCheck::of(source));
+	write_binary_token_stream(writer, token_stream);
+	write_binary_ast(writer, ast);
+
+	std::error_code error;
+	std::filesystem::create_directories(directory_, error);
+	if (error) {
+		return false;
+	}
+
+	// the temporary name must be unique across builds running at the same time, even ones that store the same entry
+	std::random_device random;
+	const auto suffix = fmt::format(".{:08x}{:08x}{}", random(), random(), TempExtension);
+	const auto entry_path = get_entry_path(key);
+	auto temp_path = entry_path;
+	temp_path += suffix;
+
+	const auto bytes = writer.get_bytes();
+	std::ofstream file(temp_path, std::ios::binary);
+	file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	file.close();
+	if (!file) {
+		std::filesystem::remove(temp_path, error);
+		return false;
+	}
+
+	std::filesystem::rename(temp_path, entry_path, error);
+	if (error) {
+		std::filesystem::remove(temp_path, error);
+		return false;
+	}
+	return true;
+}
+
+bool BuildCache::purge(std::string_view directory) {
+	std::error_code error;
+	std::filesystem::directory_iterator entries(directory, error);
+	if (error) {
+		return error == std::errc::no_such_file_or_directory;
+	}
+
+	bool has_removed_all = true;
+	for (auto& entry : entries) {
+		if (entry.is_regular_file(error) && is_entry_file_name(entry.path().filename().string())) {
+			std::filesystem::remove(entry.path(), error);
+			has_removed_all &= !error;
+		}
+	}
+
+	if (std::filesystem::is_empty(directory, error)) {
+		std::filesystem::remove(directory, error);
+	}
+	return has_removed_all;
+}
+
+std::filesystem::path BuildCache::get_entry_path(const CacheKey& key) const {
+	return directory_ / key.to_string();
+}
+
+} // namespace cero
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cero/driver/CacheKey.hpp"
+#include "cero/io/Source.hpp"
+#include "cero/syntax/Ast.hpp"
+#include "cero/syntax/AstBinary.hpp"
+#include "cero/syntax/TokenStream.hpp"
+#include "cero/syntax/TokenStreamBinary.hpp"
+#include "cero/util/FileMapping.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace cero {
+
+/// Results of lexing and parsing a source that an earlier build stored in the cache, which are viewed in place in the mapped
+/// entry, so that loading them costs no more than validating them. They are only copied out when they are needed as a
+/// TokenStream or an Ast.
+struct CachedSyntax {
+	FileMapping mapping;
+	TokenStreamBinaryView token_stream;
+	AstBinaryView ast;
+};
+
+/// Stores the token stream and AST of each source in a directory, under the cache key of the source, so that later builds can
+/// skip lexing and parsing sources that have not changed. Entries are written to a temporary file first, which is then renamed
+/// to the entry's name, so that a build never sees an entry that another build is still writing.
+class BuildCache {
+public:
+	/// Creates a cache that stores its entries in the given directory, which is created once the first entry is stored.
+	explicit BuildCache(std::string_view directory);
+
+	/// Reads back the results stored under the given key, or returns nothing if there is no valid entry for the key.
+	std::optional<CachedSyntax> load(const CacheKey& key, const SourceGuard& source) const;
+
+	/// Stores the results for the given key, replacing any entry stored under it before. Returns false if the entry could not
+	/// be written, in which case the cache is left as it was.
+	bool store(const CacheKey& key, const SourceGuard& source, const TokenStream& token_stream, const Ast& ast) const;
+
+	/// Removes the entries in the given cache directory, along with temporary files left behind by builds that were stopped
+	/// while storing an entry, and then the directory itself if nothing else is in it. Other files are never touched, so that
+	/// pointing the cache at a directory that holds anything else cannot lose it. Returns false if any of the entries or
+	/// temporary files could not be removed.
+	static bool purge(std::string_view directory);
+
+private:
+	std::filesystem::path directory_;
+
+	std::filesystem::path get_entry_path(const CacheKey& key) const;
+};
+
+} // namespace cero
@@ -1,6 +1,9 @@
 #include "BuildCommand.hpp"
 
+#include "cero/driver/BuildCache.hpp"
+#include "cero/driver/CacheKey.hpp"
 #include "cero/io/ConsoleReporter.hpp"
+#include "cero/io/SourceLoader.hpp"
 #include "cero/syntax/Lex.hpp"
 #include "cero/syntax/Parse.hpp"
 #include "cero/util/SystemError.hpp"
@@ -8,10 +11,18 @@
 namespace cero {
 
 bool run_build_command(const Configuration& config) {
-	auto source = Source::from_file(config.path, config);
+	std::vector<Source> sources;
+	for (auto path : config.paths) {
+		sources.emplace_back(Source::from_file(path, config));
+	}
+
+	// without any paths, the build reports the missing file the same way it does for any path that does not exist
+	if (sources.empty()) {
+		sources.emplace_back(Source::from_file("", config));
+	}
 
 	ConsoleReporter reporter(config);
-	build_source(source, config, reporter);
+	build_sources(sources, config, reporter);
 
 	return !reporter.has_errors();
 }
@@ -21,19 +32,53 @@ static void build_locked_source(const SourceGuard& source, const Configuration&
 		fmt::println("{}", source.get_text());
 	}
 
-	auto token_stream = lex(source, reporter, false);
-	if (config.print_tokens) {
-		fmt::println("{}", token_stream.to_string(source));
+	std::optional<TokenStream> token_stream;
+	std::optional<Ast> ast;
+	std::optional<CacheKey> cache_key;
+	std::optional<CachedSyntax> cached;
+	if (config.use_cache) {
+		cache_key = CacheKey::of(source, config);
+		cached = BuildCache(config.cache_dir).load(*cache_key, source);
+	}
+
+	// cached results are only copied out of their entry when they are printed, and otherwise the token stream is only
+	// materialized when it is printed or cached, since the parser can lex tokens as it consumes them
+	if (cached) {
+		if (config.verbose || config.print_tokens) {
+			token_stream = cached->token_stream.to_token_stream();
+		}
+		if (config.print_ast) {
+			ast = cached->ast.to_ast(source);
+		}
+	} else if (config.use_cache || config.verbose || config.print_tokens) {
+		token_stream = lex(source, reporter, CommentMode::Discard);
+		ast = parse(*token_stream, source, reporter);
+
+		// results with diagnostics are not cached, since reusing them would skip reporting the diagnostics again
+		if (cache_key && !token_stream->has_errors() && !ast->has_errors()) {
+			BuildCache(config.cache_dir).store(*cache_key, source, *token_stream, *ast);
+		}
+	} else {
+		ast = parse(source, reporter);
 	}
 
-	auto ast = parse(token_stream, source, reporter);
+	if (config.verbose) {
+		const auto stats = token_stream->get_storage_stats();
+		fmt::println("Token storage: {} bytes used, {} bytes reserved, {} bytes peak", stats.used_bytes, stats.reserved_bytes,
+					 stats.peak_reserved_bytes);
+	}
+	if (config.print_tokens) {
+		fmt::println("{}", token_stream->to_string(source));
+	}
 	if (config.print_ast) {
-		fmt::println("{}", ast.to_string(source));
+		fmt::println("{}", ast->to_string(source));
 	}
 }
 
-void build_source(const Source& source, const Configuration& config, Reporter& reporter) {
-	auto lock_result = source.lock();
+static void build_lock_result(const Source& source,
+							  const Result<SourceGuard, std::error_condition>& lock_result,
+							  const Configuration& config,
+							  Reporter& reporter) {
 	if (auto locked_source = lock_result.value()) {
 		build_locked_source(*locked_source, config, reporter);
 	} else {
@@ -49,4 +94,15 @@ void build_source(const Source& source, const Configuration& config, Reporter& r
 	}
 }
 
+void build_source(const Source& source, const Configuration& config, Reporter& reporter) {
+	build_lock_result(source, source.lock(), config, reporter);
+}
+
+void build_sources(std::span<const Source> sources, const Configuration& config, Reporter& reporter) {
+	SourceLoader loader(sources);
+	for (auto& source : sources) {
+		build_lock_result(source, loader.next(), config, reporter);
+	}
+}
+
 } // namespace cero
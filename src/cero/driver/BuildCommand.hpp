@@ -4,6 +4,8 @@
 #include "cero/io/Reporter.hpp"
 #include "cero/io/Source.hpp"
 
+#include <span>
+
 namespace cero {
 
 /// Perform a build with the given configuration.
@@ -12,4 +14,8 @@ bool run_build_command(const Configuration& config);
 /// Build a single source input with the given configuration and reporter.
 void build_source(const Source& source, const Configuration& config, Reporter& reporter);
 
+/// Build the given source inputs one after another, with the given configuration and reporter. Each source is loaded ahead of
+/// time by a SourceLoader while the ones before it are being built.
+void build_sources(std::span<const Source> sources, const Configuration& config, Reporter& reporter);
+
 } // namespace cero
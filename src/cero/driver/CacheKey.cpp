@@ -0,0 +1,24 @@
+#include "CacheKey.hpp"
+
+#include "cero/driver/Version.hpp"
+
+namespace cero {
+
+CacheKey CacheKey::of(const SourceGuard& source, const Configuration& config) {
+	const auto content_hash = source.get_content_hash();
+
+	// only options that change the results belong here, unlike for example those that only decide what gets printed
+	const uint64_t fields[] {
+		content_hash.low, content_hash.high, version::Major, version::Minor, version::Patch, FormatVersion, config.tab_size,
+	};
+
+	char bytes[sizeof(fields)];
+	std::memcpy(bytes, fields, sizeof(fields));
+	return CacheKey {ContentHash::of(std::string_view(bytes, sizeof(bytes)))};
+}
+
+std::string CacheKey::to_string() const {
+	return hash.to_string();
+}
+
+} // namespace cero
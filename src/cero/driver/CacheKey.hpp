@@ -0,0 +1,30 @@
+#pragma once
+
+#include "cero/io/Configuration.hpp"
+#include "cero/io/Source.hpp"
+#include "cero/util/ContentHash.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace cero {
+
+/// Identifies the results of processing a source, such as its token stream and AST, by everything they depend on: the source
+/// code, the compiler version and the configuration options that affect them. Results stored under a key can be reused by any
+/// later build that computes the same key.
+struct CacheKey {
+	/// Version of the format that results are cached in, which must be incremented whenever that format changes.
+	static constexpr uint32_t FormatVersion = 4;
+
+	ContentHash hash;
+
+	/// Computes the key for processing the given source with the given configuration.
+	static CacheKey of(const SourceGuard& source, const Configuration& config);
+
+	/// Creates a string of hexadecimal digits that can be used as a file name.
+	std::string to_string() const;
+
+	bool operator==(const CacheKey&) const = default;
+};
+
+} // namespace cero
@@ -1,5 +1,6 @@
 #include "Run.hpp"
 
+#include "cero/driver/BuildCache.hpp"
 #include "cero/driver/BuildCommand.hpp"
 #include "cero/driver/Environment.hpp"
 #include "cero/driver/Version.hpp"
@@ -24,6 +25,8 @@ options:
     -h, --help          Show this message
     -v, --verbose       Give verbose output
     -V, --version       Show version and build info for the compiler
+    --cache             Reuse lexing and parsing results of unchanged files
+    --cache-dir=<path>  Keep the cache in the given directory, implies --cache
 )_____";
 
 	fmt::println(help, version::Major, version::Minor, version::Patch);
@@ -39,8 +42,12 @@ static bool run_install_command() {
 	to_do();
 }
 
-static bool run_clean_command() {
-	to_do();
+static bool run_clean_command(const Configuration& config) {
+	if (!BuildCache::purge(config.cache_dir)) {
+		fmt::println("Could not remove the cache entries in '{}'.", config.cache_dir);
+		return false;
+	}
+	return true;
 }
 
 static bool run_run_command() {
@@ -57,7 +64,7 @@ bool run(std::span<char*> args) {
 			case Version: return run_version_command();
 			case Build:	  return run_build_command(*config);
 			case Install: return run_install_command();
-			case Clean:	  return run_clean_command();
+			case Clean:	  return run_clean_command(*config);
 			case Run:	  return run_run_command();
 		}
 		fail_unreachable();
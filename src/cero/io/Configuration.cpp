@@ -50,12 +50,22 @@ bool Configuration::parse_option(std::string_view arg) {
 	if (arg.starts_with("--tab-size=")) {
 		return parse_tab_size(arg);
 	}
+	if (arg.starts_with("--mmap-threshold=")) {
+		return parse_mmap_threshold(arg);
+	}
+	if (arg.starts_with("--cache-dir=")) {
+		cache_dir = get_arg_value_string(arg);
+		use_cache = true;
+		return true;
+	}
 	// check for all other value-based options here in the future
 
 	if (arg == "-v" || arg == "--verbose") {
 		verbose = true;
 	} else if (arg == "-Werror") {
 		warnings_as_errors = true;
+	} else if (arg == "--cache") {
+		use_cache = true;
 	} else if (arg == "--print-source") {
 		print_source = true;
 	} else if (arg == "--print-tokens") {
@@ -65,7 +75,7 @@ bool Configuration::parse_option(std::string_view arg) {
 	}
 	// check for all other boolean options here in the future
 	else {
-		path = arg;
+		paths.emplace_back(arg);
 	}
 
 	return true;
@@ -85,4 +95,18 @@ bool Configuration::parse_tab_size(std::string_view arg) {
 	}
 }
 
+bool Configuration::parse_mmap_threshold(std::string_view arg) {
+	auto str = get_arg_value_string(arg);
+
+	uint32_t mmap_threshold_value;
+	auto result = std::from_chars(str.data(), str.data() + str.size(), mmap_threshold_value);
+	if (result.ec == std::errc()) {
+		mmap_threshold = mmap_threshold_value;
+		return true;
+	} else {
+		fmt::println("--mmap-threshold must be specified with a number of bytes.");
+		return false;
+	}
+}
+
 } // namespace cero
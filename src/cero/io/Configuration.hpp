@@ -4,6 +4,7 @@
 #include <optional>
 #include <span>
 #include <string_view>
+#include <vector>
 
 namespace cero {
 
@@ -24,12 +25,23 @@ struct Configuration {
 	/// What the compiler should mainly do for a given execution.
 	Command command = Command::Help;
 
-	/// Temporary, before a proper build system exists. Holds the path of the file to compile.
-	std::string_view path;
+	/// Temporary, before a proper build system exists. Holds the paths of the files to compile, in the order they are given.
+	std::vector<std::string_view> paths;
 
 	/// The tab size of the source code as intended by the author, to make the locations in diagnostic messages accurate.
 	uint8_t tab_size = DefaultTabSize;
 
+	/// Source files of at least this many bytes are memory-mapped, smaller ones are read into a reused buffer instead, which
+	/// avoids the cost of mapping and unmapping when building many small files.
+	uint32_t mmap_threshold = DefaultMmapThreshold;
+
+	/// Directory where the results of lexing and parsing each source are cached between builds. Removed by the clean command.
+	std::string_view cache_dir = DefaultCacheDir;
+
+	/// Decides whether the results of lexing and parsing are reused from and stored in the cache directory. Off by default,
+	/// since the cache trades disk space for build time.
+	bool use_cache = false;
+
 	/// Decides whether verbose output is enabled.
 	bool verbose = false;
 
@@ -49,12 +61,15 @@ struct Configuration {
 	static std::optional<Configuration> from(std::span<char*> args);
 
 	static constexpr uint8_t DefaultTabSize = 4;
+	static constexpr uint32_t DefaultMmapThreshold = 64 * 1024;
+	static constexpr std::string_view DefaultCacheDir = ".cero-cache";
 
 private:
 	bool parse_command(std::string_view arg);
 	bool parse_option(std::string_view arg);
 
 	bool parse_tab_size(std::string_view arg);
+	bool parse_mmap_threshold(std::string_view arg);
 };
 
 } // namespace cero
@@ -8,7 +8,11 @@ void MessageArgs::store_args(fmt::format_args args) {
 	int i = 0;
 	while (auto arg = args.get(i++)) {
 		arg.visit([&]<typename T>(const T& value) {
-			if constexpr (fmt::is_formattable<T>::value) {
+			// The store does not copy string views, but arguments must outlive the strings they were created from, since
+			// reports can be held back and replayed later.
+			if constexpr (std::is_same_v<T, fmt::string_view>) {
+				store.push_back(std::string(value.data(), value.size()));
+			} else if constexpr (fmt::is_formattable<T>::value) {
 				store.push_back(value);
 			}
 		});
@@ -15,17 +15,17 @@ std::string_view SourceGuard::get_name() const {
 }
 
 CodeLocation SourceGuard::locate(SourceOffset offset) const {
-	auto range = source_code_.substr(0, offset);
+	offset = static_cast<SourceOffset>(std::min<size_t>(offset, source_code_.length()));
 
-	const auto line = static_cast<uint32_t>(std::count(range.begin(), range.end(), '\n') + 1);
+	auto& line_starts = get_line_starts();
 
-	const size_t line_index = range.find_last_of('\n');
-	if (line_index != std::string_view::npos) {
-		range = range.substr(line_index + 1);
-	}
+	// the first line start is always 0, so there is always a line start before the found one
+	const auto next_line_start = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+	const auto line_start = *(next_line_start - 1);
+	const auto line = static_cast<uint32_t>(next_line_start - line_starts.begin());
 
 	uint32_t column = 1;
-	for (char c : range) {
+	for (char c : source_code_.substr(line_start, offset - line_start)) {
 		if (c == '\t') {
 			column += tab_size_;
 		} else {
@@ -35,31 +35,55 @@ CodeLocation SourceGuard::locate(SourceOffset offset) const {
 	return {name_, line, column};
 }
 
+ContentHash SourceGuard::get_content_hash() const {
+	std::call_once(lazy_data_->content_hash_once, [&] {
+		lazy_data_->content_hash = ContentHash::of(source_code_);
+	});
+	return lazy_data_->content_hash;
+}
+
+const std::vector<SourceOffset>& SourceGuard::get_line_starts() const {
+	std::call_once(lazy_data_->line_starts_once, [&] {
+		auto& line_starts = lazy_data_->line_starts;
+		line_starts.push_back(0);
+
+		// find is implemented with memchr by all major standard libraries, which is vectorized
+		size_t newline = source_code_.find('\n');
+		while (newline != std::string_view::npos) {
+			line_starts.push_back(static_cast<SourceOffset>(newline + 1));
+			newline = source_code_.find('\n', newline + 1);
+		}
+	});
+	return lazy_data_->line_starts;
+}
+
 SourceGuard::SourceGuard(std::string_view text, std::string_view source_code, uint8_t tab_size) :
 	mapping_(std::nullopt),
 	source_code_(text),
 	name_(source_code),
-	tab_size_(tab_size) {
+	tab_size_(tab_size),
+	lazy_data_(std::make_unique<LazyData>()) {
 }
 
 SourceGuard::SourceGuard(FileMapping&& mapping, std::string_view source_code, uint8_t tab_size) :
 	mapping_(std::move(mapping)),
 	source_code_(mapping_->get_text()),
 	name_(source_code),
-	tab_size_(tab_size) {
+	tab_size_(tab_size),
+	lazy_data_(std::make_unique<LazyData>()) {
 }
 
 Source Source::from_file(std::string_view path, const Configuration& config) {
-	return Source(path, {}, config.tab_size);
+	return Source(path, {}, config);
 }
 
 Source Source::from_string(std::string_view name, std::string_view source_code, const Configuration& config) {
-	return Source(name, source_code, config.tab_size);
+	return Source(name, source_code, config);
 }
 
 Result<SourceGuard, std::error_condition> Source::lock() const {
-	if (source_code_.data() == nullptr) {
-		return FileMapping::from(name_).map([&](FileMapping&& file_mapping) -> SourceGuard {
+	if (is_file()) {
+		return FileMapping::from(name_, mmap_threshold_).map([&](FileMapping&& file_mapping) -> SourceGuard {
 			return SourceGuard(std::move(file_mapping), name_, tab_size_);
 		});
 	} else {
@@ -67,14 +91,27 @@ Result<SourceGuard, std::error_condition> Source::lock() const {
 	}
 }
 
+SourceGuard Source::lock_loaded(FileMapping&& contents) const {
+	return SourceGuard(std::move(contents), name_, tab_size_);
+}
+
+bool Source::is_file() const {
+	return source_code_.data() == nullptr;
+}
+
+uint32_t Source::get_mmap_threshold() const {
+	return mmap_threshold_;
+}
+
 std::string_view Source::get_name() const {
 	return name_;
 }
 
-Source::Source(std::string_view name, std::string_view source_code, uint8_t tab_size) :
+Source::Source(std::string_view name, std::string_view source_code, const Configuration& config) :
 	name_(name),
 	source_code_(source_code),
-	tab_size_(tab_size) {
+	mmap_threshold_(config.mmap_threshold),
+	tab_size_(config.tab_size) {
 }
 
 } // namespace cero
@@ -2,24 +2,37 @@
 
 #include "cero/io/CodeLocation.hpp"
 #include "cero/io/Configuration.hpp"
+#include "cero/util/ContentHash.hpp"
 #include "cero/util/FileMapping.hpp"
 #include "cero/util/Result.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 namespace cero {
 
-/// Minimum number of bits required to represent any offset into a Cero source input. It is 24 bits so that an offset value can
-/// fit into a 32-bit integer, leaving 8 bits available for metadata serving various purposes.
+/// Number of bits that a token stores of its source offset. It is 24 bits so that a token fits into a 32-bit integer, leaving
+/// 8 bits for its kind.
 constexpr inline size_t SourceOffsetBits = 24;
 
 /// Recommended type to use for values and bit fields representing offsets into source code.
 using SourceOffset = uint32_t;
 
-/// Maximum allowed byte size of a Cero source file (circa 16 MiB), derived from the number of bits needed to represent the
-/// source offset of any valid token including the end-of-file token, whose offset equals the source length.
-constexpr inline SourceOffset MaxSourceLength = (1 << SourceOffsetBits) - 1;
+/// Length of the segments that sources longer than MaxCompactSourceLength are divided into. Tokens then only store their offset
+/// within a segment, and the token stream records which token each segment begins with.
+constexpr inline size_t SourceSegmentLength = size_t(1) << SourceOffsetBits;
+
+/// Maximum byte size of a source (circa 16 MiB) whose token offsets, including that of the end-of-file token, all fit into
+/// SourceOffsetBits. Such sources are lexed into a single segment and can be parsed while they are being lexed.
+constexpr inline SourceOffset MaxCompactSourceLength = SourceSegmentLength - 1;
+
+/// Maximum allowed byte size of a Cero source file (circa 4 GiB), so that the offset of any valid token including the
+/// end-of-file token, whose offset equals the source length, fits into a SourceOffset.
+constexpr inline SourceOffset MaxSourceLength = UINT32_MAX;
 
 /// Allows access to the source code for processing, possibly from a memory-mapped file. Closes the memory-mapped file when
 /// going out of scope.
@@ -34,14 +47,32 @@ public:
 	/// Gets the name of the original source input.
 	std::string_view get_name() const;
 
-	/// Determine the line and column that a given source offset corresponds to.
+	/// Determine the line and column that a given source offset corresponds to. The first call builds an index of line starts,
+	/// after which any offset can be located with a binary search and a scan of only the line it is on. Safe to call from
+	/// multiple threads.
 	CodeLocation locate(SourceOffset offset) const;
 
+	/// Gets the fingerprint of the source code, which is computed on the first call. Safe to call from multiple threads.
+	ContentHash get_content_hash() const;
+
 private:
+	/// Data derived from the source code on first use.
+	struct LazyData {
+		/// Offsets of the first character of every line, built on the first call to locate.
+		std::once_flag line_starts_once;
+		std::vector<SourceOffset> line_starts;
+
+		std::once_flag content_hash_once;
+		ContentHash content_hash;
+	};
+
 	std::optional<FileMapping> mapping_;
 	std::string_view source_code_;
 	std::string_view name_;
 	uint8_t tab_size_;
+	std::unique_ptr<LazyData> lazy_data_;
+
+	const std::vector<SourceOffset>& get_line_starts() const;
 
 	SourceGuard(std::string_view source_code, std::string_view name, uint8_t tab_size);
 	SourceGuard(FileMapping&& mapping, std::string_view name, uint8_t tab_size);
@@ -62,19 +93,29 @@ public:
 	static Source from_string(std::string_view name, std::string_view source_code, const Configuration& config);
 
 	/// If the source represents a file, tries to open it as a memory-mapped file that will be closed when the guard goes out of
-	/// scope. If the operation fails, the system error code is returned. Locking source objects created directly from strings
-	/// will never fail.
+	/// scope, or to read it if it is smaller than the configured mmap threshold. If the operation fails, the system error code
+	/// is returned. Locking source objects created directly from strings will never fail.
 	Result<SourceGuard, std::error_condition> lock() const;
 
+	/// Gives access to the contents of the source's file that were loaded by other means than lock, such as by a SourceLoader.
+	SourceGuard lock_loaded(FileMapping&& contents) const;
+
+	/// Whether the source represents a file, as opposed to a string of source code.
+	bool is_file() const;
+
+	/// Files of the source of at least this many bytes are memory-mapped when locking the source, smaller ones are read.
+	uint32_t get_mmap_threshold() const;
+
 	/// Gets the name of the source input.
 	std::string_view get_name() const;
 
 private:
 	std::string_view name_;
 	std::string_view source_code_;
+	uint32_t mmap_threshold_;
 	uint8_t tab_size_;
 
-	Source(std::string_view name, std::string_view text, uint8_t tab_size);
+	Source(std::string_view name, std::string_view text, const Configuration& config);
 };
 
 } // namespace cero
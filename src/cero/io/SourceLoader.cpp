@@ -0,0 +1,117 @@
+#include "SourceLoader.hpp"
+
+#include "cero/util/Fail.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace cero {
+
+/// Loads sources on background threads by locking them, which opens, sizes and reads each file with blocking system calls.
+class SourceLoader::ThreadQueue final : public SourceLoader::Queue {
+public:
+	ThreadQueue(std::span<const Source> sources, uint32_t max_ahead) :
+		sources_(sources),
+		results_(sources.size()),
+		max_ahead_(max_ahead) {
+		const auto num_threads = std::min(NumLoadingThreads, static_cast<uint32_t>(sources.size()));
+		threads_.reserve(num_threads);
+		for (uint32_t i = 0; i != num_threads; ++i) {
+			threads_.emplace_back(&ThreadQueue::run_thread, this);
+		}
+	}
+
+	~ThreadQueue() override {
+		{
+			std::lock_guard lock(mutex_);
+			stopping_ = true;
+		}
+		source_taken_.notify_all();
+
+		for (auto& thread : threads_) {
+			thread.join();
+		}
+	}
+
+	Result<SourceGuard, std::error_condition> take(uint32_t index) override {
+		std::unique_lock lock(mutex_);
+		auto& result = results_[index];
+		source_loaded_.wait(lock, [&] {
+			return result.has_value();
+		});
+
+		auto taken = std::move(*result);
+		result.reset();
+		next_to_take_ = index + 1;
+		lock.unlock();
+
+		source_taken_.notify_all();
+		return taken;
+	}
+
+private:
+	std::span<const Source> sources_;
+	std::vector<std::optional<Result<SourceGuard, std::error_condition>>> results_;
+	std::vector<std::thread> threads_;
+	std::mutex mutex_;
+	std::condition_variable source_loaded_;
+	std::condition_variable source_taken_;
+	uint32_t max_ahead_;
+	uint32_t next_to_load_ = 0;
+	uint32_t next_to_take_ = 0;
+	bool stopping_ = false;
+
+	void run_thread() {
+		std::unique_lock lock(mutex_);
+		while (true) {
+			source_taken_.wait(lock, [&] {
+				return stopping_ || next_to_load_ == sources_.size() || next_to_load_ < next_to_take_ + max_ahead_;
+			});
+			if (stopping_ || next_to_load_ == sources_.size()) {
+				return;
+			}
+
+			const uint32_t index = next_to_load_++;
+			lock.unlock();
+
+			auto result = sources_[index].lock();
+
+			lock.lock();
+			results_[index].emplace(std::move(result));
+			source_loaded_.notify_all();
+		}
+	}
+};
+
+SourceLoader::SourceLoader(std::span<const Source> sources, SourceLoadMethod method, uint32_t max_ahead) :
+	sources_(sources),
+	method_(method) {
+	max_ahead = std::max(max_ahead, 1u);
+	if (method == SourceLoadMethod::IoRing) {
+		queue_ = make_ring_queue(sources, max_ahead);
+	}
+	if (queue_ == nullptr) {
+		queue_ = std::make_unique<ThreadQueue>(sources, max_ahead);
+		method_ = SourceLoadMethod::Threads;
+	}
+}
+
+SourceLoader::~SourceLoader() = default;
+
+SourceLoadMethod SourceLoader::get_method() const {
+	return method_;
+}
+
+bool SourceLoader::has_next() const {
+	return next_to_take_ != sources_.size();
+}
+
+Result<SourceGuard, std::error_condition> SourceLoader::next() {
+	check(has_next(), "all sources have already been handed out");
+	return queue_->take(next_to_take_++);
+}
+
+} // namespace cero
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "cero/io/Source.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace cero {
+
+/// Ways in which a SourceLoader can load sources ahead of time.
+enum class SourceLoadMethod : uint8_t {
+	/// Submits the system calls that open, size and read many sources at once through an io_uring, which the kernel completes
+	/// while the thread that takes the sources is busy with them. Only available on Linux.
+	IoRing,
+
+	/// Loads sources on a few background threads, each of which opens, sizes and reads one source at a time with blocking
+	/// system calls. Works everywhere.
+	Threads,
+};
+
+/// Loads a list of sources ahead of when they are needed, so that processing one source overlaps with opening and reading the
+/// ones after it. Sources are handed out in list order, and only a bounded number of them are loaded ahead of the one that is
+/// handed out next, which bounds how much memory loaded but unprocessed sources can take up. Files below the mmap threshold
+/// of their source are read into buffers from the ReadBufferPool, larger ones are mapped once they are handed out, just like
+/// locking the source would do.
+class SourceLoader {
+public:
+	/// Number of threads that load sources with SourceLoadMethod::Threads. Loading mostly waits on the file system, so it pays
+	/// to have more loads in flight than there are cores.
+	static constexpr uint32_t NumLoadingThreads = 4;
+
+	/// Most sources that are loaded ahead of the one handed out next by default.
+	static constexpr uint32_t DefaultMaxAhead = 16;
+
+	/// Starts loading the given sources, which must outlive the loader. Falls back to SourceLoadMethod::Threads if the given
+	/// method is not available on this system.
+	explicit SourceLoader(std::span<const Source> sources,
+						  SourceLoadMethod method = SourceLoadMethod::IoRing,
+						  uint32_t max_ahead = DefaultMaxAhead);
+
+	/// Stops loading. Sources that were loaded but not handed out yet are closed.
+	~SourceLoader();
+
+	/// The method that the loader actually uses.
+	SourceLoadMethod get_method() const;
+
+	/// Whether there are sources left that have not been handed out yet.
+	bool has_next() const;
+
+	/// Waits until the next source in list order is loaded and returns the result of locking it, which fails with the same
+	/// errors as locking the source directly would.
+	Result<SourceGuard, std::error_condition> next();
+
+	SourceLoader(SourceLoader&&) = delete;
+	SourceLoader& operator=(SourceLoader&&) = delete;
+
+private:
+	/// Loads the sources in the background in one of the ways of SourceLoadMethod.
+	class Queue {
+	public:
+		virtual ~Queue() = default;
+
+		/// Waits until the source at the given index is loaded and takes its result. Called once for every index, in order.
+		virtual Result<SourceGuard, std::error_condition> take(uint32_t index) = 0;
+	};
+
+	class RingQueue;
+	class ThreadQueue;
+
+	std::span<const Source> sources_;
+	std::unique_ptr<Queue> queue_;
+	SourceLoadMethod method_;
+	uint32_t next_to_take_ = 0;
+
+	/// Creates a queue that loads the sources through an io_uring, or returns null if that is not available on this system.
+	static std::unique_ptr<Queue> make_ring_queue(std::span<const Source> sources, uint32_t max_ahead);
+};
+
+} // namespace cero
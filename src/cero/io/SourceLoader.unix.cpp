@@ -0,0 +1,357 @@
+#include "SourceLoader.hpp"
+
+#ifdef __linux__
+	#include "cero/util/Fail.hpp"
+	#include "cero/util/ReadBufferPool.hpp"
+	#include "cero/util/SystemError.hpp"
+
+	#include <atomic>
+	#include <bit>
+	#include <string>
+	#include <vector>
+
+	#include <fcntl.h>
+	#include <linux/io_uring.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+namespace cero {
+
+#ifdef __linux__
+
+/// Loads sources through an io_uring, which is driven by the thread that takes the sources. For every source in the window
+/// ahead of the one taken next, the ring opens the file and determines its size at the same time, and once both completed,
+/// reads the whole file into a buffer of that size. Operations for all sources that enter the window are submitted with a
+/// single system call, and the kernel carries them out while the taking thread is busy with the sources before them. The ring
+/// is used through its system calls directly, so that there is no dependency on liburing.
+class SourceLoader::RingQueue final : public SourceLoader::Queue {
+public:
+	static std::unique_ptr<RingQueue> create(std::span<const Source> sources, uint32_t max_ahead) {
+		// every source in the window has at most two operations in flight, and one more source enters it before the
+		// operations of the previous ones are submitted
+		io_uring_params params {};
+		const int ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, std::bit_ceil(2 * max_ahead + 2), &params));
+		if (ring_fd < 0) {
+			return nullptr; // io_uring is not supported by the kernel or not permitted for this process
+		}
+
+		auto queue = std::unique_ptr<RingQueue>(new RingQueue(sources, max_ahead, ring_fd));
+
+		// the operations used here were added in the same kernel version as this feature
+		if ((params.features & IORING_FEAT_RW_CUR_POS) == 0 || !queue->map_rings(params)) {
+			return nullptr;
+		}
+		return queue;
+	}
+
+	~RingQueue() override {
+		// the kernel writes into the loads until their operations complete, so they have to be waited for
+		stopping_ = true;
+		if (sqes_ != MAP_FAILED) {
+			submit();
+			while (num_in_flight_ != 0) {
+				wait_for_completion();
+				reap_completions();
+			}
+		}
+		for (auto& load : loads_) {
+			finish(load, false);
+		}
+
+		if (sqes_ != MAP_FAILED) {
+			::munmap(sqes_, sqes_size_);
+		}
+		if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+			::munmap(cq_ring_, cq_ring_size_);
+		}
+		if (sq_ring_ != MAP_FAILED) {
+			::munmap(sq_ring_, sq_ring_size_);
+		}
+		int ret = ::close(ring_fd_);
+		check(ret != -1, fmt::format("could not close io_uring, system error: {}", get_last_system_error().message()));
+	}
+
+	Result<SourceGuard, std::error_condition> take(uint32_t index) override {
+		start_loads(index);
+		submit();
+
+		auto& load = loads_[index % loads_.size()];
+		while (!load.is_done) {
+			wait_for_completion();
+			reap_completions();
+			submit();
+		}
+
+		const auto& source = sources_[index];
+		auto result = load.is_read ? Result<SourceGuard, std::error_condition>(
+										 source.lock_loaded(FileMapping::from_read_buffer(std::move(load.buffer))))
+								   : source.lock();
+		load = Load();
+
+		// the window moves on by one source, which can start loading while the taken one is being processed
+		start_loads(index + 1);
+		submit();
+		return result;
+	}
+
+private:
+	enum class Operation : uint8_t {
+		Open,
+		Stat,
+		Read,
+	};
+
+	/// State of loading one source in the window.
+	struct Load {
+		std::string path; // null-terminated name of the source, which the kernel reads until the operations complete
+		struct statx stats = {};
+		std::unique_ptr<std::vector<char>> buffer;
+		size_t num_read = 0;
+		int fd = -1;
+		uint8_t num_in_flight = 0;
+		bool has_failed = false;
+		bool is_read = false; // whether the contents are in the buffer, otherwise the source is locked when it is taken
+		bool is_done = false;
+	};
+
+	std::span<const Source> sources_;
+	std::vector<Load> loads_; // for every source in the window, at the index of the source modulo the window size
+	uint32_t next_to_start_ = 0;
+	uint32_t num_in_flight_ = 0;
+	uint32_t num_unsubmitted_ = 0;
+	bool stopping_ = false;
+
+	int ring_fd_;
+	void* sq_ring_ = MAP_FAILED;
+	void* cq_ring_ = MAP_FAILED;
+	void* sqes_ = MAP_FAILED;
+	size_t sq_ring_size_ = 0;
+	size_t cq_ring_size_ = 0;
+	size_t sqes_size_ = 0;
+	uint32_t* sq_head_ = nullptr;
+	uint32_t* sq_tail_ = nullptr;
+	uint32_t* sq_array_ = nullptr;
+	uint32_t sq_mask_ = 0;
+	uint32_t sq_entries_ = 0;
+	uint32_t sq_local_tail_ = 0; // tail including the entries that were prepared but not made visible to the kernel yet
+	uint32_t* cq_head_ = nullptr;
+	uint32_t* cq_tail_ = nullptr;
+	io_uring_cqe* cqes_ = nullptr;
+	uint32_t cq_mask_ = 0;
+
+	RingQueue(std::span<const Source> sources, uint32_t max_ahead, int ring_fd) :
+		sources_(sources),
+		loads_(max_ahead),
+		ring_fd_(ring_fd) {
+	}
+
+	bool map_rings(const io_uring_params& params) {
+		sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		const bool is_single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (is_single_mapping) {
+			sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+		}
+
+		constexpr int prot = PROT_READ | PROT_WRITE;
+		constexpr int flags = MAP_SHARED | MAP_POPULATE;
+		sq_ring_ = ::mmap(nullptr, sq_ring_size_, prot, flags, ring_fd_, IORING_OFF_SQ_RING);
+		if (sq_ring_ == MAP_FAILED) {
+			return false;
+		}
+		cq_ring_ = is_single_mapping ? sq_ring_ : ::mmap(nullptr, cq_ring_size_, prot, flags, ring_fd_, IORING_OFF_CQ_RING);
+		if (cq_ring_ == MAP_FAILED) {
+			return false;
+		}
+		sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+		sqes_ = ::mmap(nullptr, sqes_size_, prot, flags, ring_fd_, IORING_OFF_SQES);
+		if (sqes_ == MAP_FAILED) {
+			return false;
+		}
+
+		auto sq = static_cast<char*>(sq_ring_);
+		sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+		sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+		sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+		sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+		sq_entries_ = params.sq_entries;
+		sq_local_tail_ = *sq_tail_;
+
+		auto cq = static_cast<char*>(cq_ring_);
+		cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+		cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+		cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+		return true;
+	}
+
+	/// Starts opening and sizing the files of the sources that are within the window ahead of the one taken next.
+	void start_loads(uint32_t next_to_take) {
+		while (next_to_start_ != sources_.size() && next_to_start_ < next_to_take + loads_.size()) {
+			const uint32_t index = next_to_start_++;
+			const auto& source = sources_[index];
+			auto& load = loads_[index % loads_.size()];
+			if (!source.is_file()) {
+				load.is_done = true;
+				continue;
+			}
+
+			load.path = source.get_name();
+			const auto path = reinterpret_cast<uint64_t>(load.path.c_str());
+
+			auto& open = prepare(IORING_OP_OPENAT, index, Operation::Open, load);
+			open.fd = AT_FDCWD;
+			open.addr = path;
+			open.open_flags = O_RDONLY;
+
+			auto& stat = prepare(IORING_OP_STATX, index, Operation::Stat, load);
+			stat.fd = AT_FDCWD;
+			stat.addr = path;
+			stat.len = STATX_TYPE | STATX_SIZE;
+			stat.off = reinterpret_cast<uint64_t>(&load.stats);
+		}
+	}
+
+	/// Continues loading once all operations of the load have completed.
+	void continue_load(Load& load, const Source& source) {
+		if (load.has_failed || stopping_) {
+			finish(load, false);
+			return;
+		}
+
+		if (load.buffer == nullptr) {
+			// anything but a regular file is left to mapping to accept or reject, just like locking the source would do
+			if (!S_ISREG(load.stats.stx_mode) || load.stats.stx_size >= source.get_mmap_threshold()) {
+				finish(load, false);
+				return;
+			}
+			load.buffer = ReadBufferPool::acquire(load.stats.stx_size);
+		}
+
+		if (load.num_read == load.buffer->size()) {
+			finish(load, true);
+			return;
+		}
+
+		const auto index = static_cast<uint32_t>(&source - sources_.data());
+		auto& read = prepare(IORING_OP_READ, index, Operation::Read, load);
+		read.fd = load.fd;
+		read.addr = reinterpret_cast<uint64_t>(load.buffer->data() + load.num_read);
+		read.len = static_cast<uint32_t>(std::min<size_t>(load.buffer->size() - load.num_read, INT32_MAX));
+		read.off = load.num_read;
+	}
+
+	void finish(Load& load, bool is_read) {
+		if (load.fd != -1) {
+			int ret = ::close(std::exchange(load.fd, -1));
+			check(ret != -1, fmt::format("could not close file, system error: {}", get_last_system_error().message()));
+		}
+		if (!is_read && load.buffer != nullptr) {
+			ReadBufferPool::release(std::move(load.buffer));
+		}
+		load.is_read = is_read;
+		load.is_done = true;
+	}
+
+	io_uring_sqe& prepare(uint8_t opcode, uint32_t index, Operation operation, Load& load) {
+		if (sq_local_tail_ - std::atomic_ref(*sq_head_).load(std::memory_order_acquire) == sq_entries_) {
+			submit();
+		}
+
+		const uint32_t slot = sq_local_tail_ & sq_mask_;
+		auto& sqe = static_cast<io_uring_sqe*>(sqes_)[slot];
+		sqe = {};
+		sqe.opcode = opcode;
+		sqe.user_data = uint64_t(index) << 2 | static_cast<uint64_t>(operation);
+		sq_array_[slot] = slot;
+		++sq_local_tail_;
+
+		++num_unsubmitted_;
+		++num_in_flight_;
+		++load.num_in_flight;
+		return sqe;
+	}
+
+	/// Hands all prepared operations to the kernel without waiting for any of them to complete.
+	void submit() {
+		if (num_unsubmitted_ == 0) {
+			return;
+		}
+
+		while (num_unsubmitted_ != 0) {
+			std::atomic_ref(*sq_tail_).store(sq_local_tail_, std::memory_order_release);
+			const auto ret = ::syscall(__NR_io_uring_enter, ring_fd_, num_unsubmitted_, 0, 0, nullptr, 0);
+			if (ret == -1) {
+				check(errno == EINTR || errno == EAGAIN || errno == EBUSY,
+					  fmt::format("could not submit to io_uring, system error: {}", get_last_system_error().message()));
+				reap_completions(); // makes room in the completion queue in case it is full
+				continue;
+			}
+			num_unsubmitted_ -= static_cast<uint32_t>(ret);
+		}
+	}
+
+	void wait_for_completion() {
+		const auto ret = ::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+		check(ret != -1 || errno == EINTR,
+			  fmt::format("could not wait for io_uring, system error: {}", get_last_system_error().message()));
+	}
+
+	void reap_completions() {
+		uint32_t head = *cq_head_;
+		const uint32_t tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+		for (; head != tail; ++head) {
+			const auto cqe = cqes_[head & cq_mask_];
+			std::atomic_ref(*cq_head_).store(head + 1, std::memory_order_release);
+			complete(cqe.user_data, cqe.res);
+		}
+	}
+
+	void complete(uint64_t user_data, int32_t result) {
+		const auto index = static_cast<uint32_t>(user_data >> 2);
+		auto& load = loads_[index % loads_.size()];
+		--load.num_in_flight;
+		--num_in_flight_;
+
+		switch (static_cast<Operation>(user_data & 3)) {
+			case Operation::Open:
+				if (result >= 0) {
+					load.fd = result;
+				} else {
+					load.has_failed = true;
+				}
+				break;
+			case Operation::Stat:
+				load.has_failed |= result < 0;
+				break;
+			case Operation::Read:
+				if (result > 0) {
+					load.num_read += static_cast<size_t>(result);
+				} else if (result == 0) {
+					load.buffer->resize(load.num_read); // the file was truncated since its size was determined
+				} else if (result != -EINTR && result != -EAGAIN) {
+					load.has_failed = true;
+				}
+				break;
+		}
+
+		if (load.num_in_flight == 0) {
+			continue_load(load, sources_[index]);
+		}
+	}
+};
+
+#endif
+
+std::unique_ptr<SourceLoader::Queue> SourceLoader::make_ring_queue(std::span<const Source> sources, uint32_t max_ahead) {
+#ifdef __linux__
+	return RingQueue::create(sources, max_ahead);
+#else
+	return nullptr;
+#endif
+}
+
+} // namespace cero
@@ -0,0 +1,9 @@
+#include "SourceLoader.hpp"
+
+namespace cero {
+
+std::unique_ptr<SourceLoader::Queue> SourceLoader::make_ring_queue(std::span<const Source>, uint32_t) {
+	return nullptr; // Windows has I/O rings too, but they cannot open files, so loading through one would hardly save anything
+}
+
+} // namespace cero
@@ -0,0 +1,48 @@
+#include "SourceManager.hpp"
+
+#include "cero/util/Fail.hpp"
+
+#include <algorithm>
+
+namespace cero {
+
+std::optional<GlobalSourceOffset> SourceManager::add(SourceGuard&& source) {
+	// the range includes the end-of-file offset, so that it stays distinct from the first offset of the next source
+	const uint64_t range_length = uint64_t(source.get_length()) + 1;
+	if (next_base_ + range_length > uint64_t(UINT32_MAX) + 1) {
+		return std::nullopt;
+	}
+
+	const auto base = static_cast<GlobalSourceOffset>(next_base_);
+	sources_.emplace_back(std::move(source));
+	bases_.emplace_back(base);
+	next_base_ += range_length;
+	return base;
+}
+
+uint32_t SourceManager::num_sources() const {
+	return static_cast<uint32_t>(sources_.size());
+}
+
+const SourceGuard& SourceManager::get_source(uint32_t index) const {
+	return sources_[index];
+}
+
+GlobalSourceOffset SourceManager::get_base(uint32_t index) const {
+	return bases_[index];
+}
+
+uint32_t SourceManager::find_source(GlobalSourceOffset offset) const {
+	check(offset < next_base_, "global offset lies beyond the ranges of all sources");
+
+	// the first base is always 0, so there is always a base before the found one
+	const auto next_base = std::upper_bound(bases_.begin(), bases_.end(), offset);
+	return static_cast<uint32_t>(next_base - bases_.begin() - 1);
+}
+
+CodeLocation SourceManager::locate(GlobalSourceOffset offset) const {
+	const uint32_t index = find_source(offset);
+	return sources_[index].locate(offset - bases_[index]);
+}
+
+} // namespace cero
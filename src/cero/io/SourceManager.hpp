@@ -0,0 +1,48 @@
+#pragma once
+
+#include "cero/io/CodeLocation.hpp"
+#include "cero/io/Source.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace cero {
+
+/// Offset into the global offset space of a source manager, in which every source occupies its own contiguous range. A single
+/// global offset therefore identifies both a source and a position in it.
+using GlobalSourceOffset = uint32_t;
+
+/// Owns the sources of a build and assigns each of them a contiguous range of global offsets, in the order they are added. The
+/// range of a source covers every offset into it including its length, which is the offset of its end-of-file token. Sources
+/// cannot be added while other threads use the manager, but everything else is safe to call from multiple threads. Nothing
+/// uses it yet, since tokens, AST nodes and diagnostics still carry offsets that are local to their source.
+class SourceManager {
+public:
+	/// Takes ownership of a locked source and returns the global offset its range begins at. Returns null without adding the
+	/// source if there is not enough room left in the global offset space.
+	std::optional<GlobalSourceOffset> add(SourceGuard&& source);
+
+	/// Number of sources added so far.
+	uint32_t num_sources() const;
+
+	/// Gets the source at the given index, in the order of adding. Adding more sources does not invalidate the reference.
+	const SourceGuard& get_source(uint32_t index) const;
+
+	/// Gets the global offset that the range of the source at the given index begins at.
+	GlobalSourceOffset get_base(uint32_t index) const;
+
+	/// Finds the index of the source whose range contains the given global offset, which must lie within a source's range.
+	uint32_t find_source(GlobalSourceOffset offset) const;
+
+	/// Determines the source, line and column that a global offset corresponds to.
+	CodeLocation locate(GlobalSourceOffset offset) const;
+
+private:
+	std::deque<SourceGuard> sources_;
+	std::vector<GlobalSourceOffset> bases_;
+	uint64_t next_base_ = 0;
+};
+
+} // namespace cero
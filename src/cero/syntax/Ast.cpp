@@ -1,9 +1,18 @@
 #include "Ast.hpp"
 
+#include "cero/syntax/AstNodeFields.hpp"
 #include "cero/syntax/AstToString.hpp"
 
+#include <numeric>
+
 namespace cero {
 
+/// Whether the node holds a name, which its compact form keeps in both values.
+template<typename Node>
+static constexpr bool has_name = []<typename... Field>(std::type_identity<std::tuple<Field&...>>) {
+	return (std::is_same_v<std::remove_const_t<Field>, StringId> || ...);
+}(std::type_identity<decltype(get_node_fields(std::declval<Node&>()))>());
+
 uint32_t Ast::num_nodes() const {
 	return static_cast<uint32_t>(nodes_.size());
 }
@@ -16,32 +25,226 @@ std::span<const AstNode> Ast::raw() const {
 	return {nodes_};
 }
 
+uint32_t Ast::num_generic_lookaheads() const {
+	return num_generic_lookaheads_;
+}
+
+void Ast::visit(const AstNode& node, AstVisitor& visitor) const {
+	switch (node.get_kind()) {
+#define CERO_AST_NODE_KIND(X)                                                                                                  \
+	case AstNodeKind::X: visitor.visit(decode<Ast##X>(node)); break;
+		CERO_AST_NODE_KINDS
+#undef CERO_AST_NODE_KIND
+	}
+}
+
+bool Ast::has_skipped_body(const AstFunctionDefinition& definition) const {
+	return find_skipped_body(definition) != nullptr;
+}
+
 std::string Ast::to_string(const SourceGuard& source) const {
 	return AstToString(*this, source).make_string();
 }
 
-Ast::Ast(const TokenStream& token_stream) {
-	nodes_.reserve(token_stream.num_tokens());
+Ast::Ast(std::string_view source_text, size_t num_tokens) :
+	source_text_(source_text) {
+	nodes_.reserve(num_tokens);
+}
+
+void Ast::reserve_by_progress(SourceOffset parsed_offset) {
+	// growing a little before the storage is full keeps the nodes of the next definition from making the vector double
+	const size_t num_nodes = nodes_.size();
+	if (num_nodes + num_nodes / 32 < nodes_.capacity() || parsed_offset == 0) {
+		return;
+	}
+
+	// the estimate leaves some room for the rest of the source to be denser, and still grows geometrically if it is too low
+	const size_t estimate = num_nodes * source_text_.length() / parsed_offset;
+	nodes_.reserve(std::max(estimate + estimate / 16, num_nodes + num_nodes / 4 + 1));
+}
+
+AstNode Ast::encode_function_definition(const AstFunctionDefinition& node, uint32_t rest_index) {
+	auto& rest = function_definition_rests_[rest_index];
+	rest.name_offset = locate_name(node.name);
+	rest.name_length = static_cast<uint32_t>(node.name.length());
+	rest.num_outputs = node.num_outputs;
+
+	AstNode encoded;
+	encoded.kind_ = AstNodeKind::FunctionDefinition;
+	encoded.detail_ = static_cast<uint8_t>(node.access);
+	encoded.short_count_ = node.num_parameters;
+	encoded.offset_ = node.header.offset;
+	encoded.values_[0] = node.num_children();
+	encoded.values_[1] = rest_index;
+	return encoded;
+}
+
+AstFunctionDefinition Ast::decode_function_definition(const AstNode& node) const {
+	auto& rest = function_definition_rests_[node.values_[1]];
+
+	AstFunctionDefinition decoded {node.offset_};
+	decoded.access = static_cast<AccessSpecifier>(node.detail_);
+	decoded.name = rest.name_length == 0 ? StringId() : StringId(source_text_.data() + rest.name_offset, rest.name_length);
+	decoded.num_parameters = node.short_count_;
+	decoded.num_outputs = rest.num_outputs;
+	decoded.num_statements = node.values_[0] - node.short_count_ - rest.num_outputs;
+	return decoded;
+}
+
+SourceOffset Ast::locate_name(StringId name) const {
+	if (name.empty()) {
+		return 0;
+	}
+	const auto offset = static_cast<size_t>(name.data() - source_text_.data());
+	CERO_ASSERT_DEBUG(offset + name.length() <= source_text_.length(), "name must be part of the source text");
+	return static_cast<SourceOffset>(offset);
 }
 
-Ast::NodeIndex Ast::store(AstNode&& node) {
+Ast::NodeIndex Ast::store(AstNode node) {
 	auto index = static_cast<NodeIndex>(nodes_.size());
-	nodes_.emplace_back(std::move(node));
+	nodes_.emplace_back(node);
+	if (!is_in_pre_order_) [[unlikely]] {
+		link_as_last_in_pre_order(index);
+	}
 	return index;
 }
 
-Ast::NodeIndex Ast::store_parent_of(NodeIndex first_child, AstNode&& node) {
-	nodes_.insert(nodes_.begin() + static_cast<ptrdiff_t>(first_child), std::move(node));
-	// after the insert, the index of the first_child is now the index of the newly inserted parent node
+Ast::NodeIndex Ast::store_parent_of(NodeIndex first_child, AstNode node) {
+	const auto end = static_cast<NodeIndex>(nodes_.size());
+	if (end - first_child <= MaxShiftedNodes && (is_in_pre_order_ || first_child >= pre_order_tail_start_)) {
+		// after the insert, the index of the first_child is now the index of the newly inserted parent node
+		nodes_.insert(nodes_.begin() + static_cast<ptrdiff_t>(first_child), node);
+		if (!is_in_pre_order_) {
+			next_in_pre_order_.emplace_back();
+			next_in_pre_order_[end - 1] = end;
+			last_in_pre_order_ = end;
+		}
+		return first_child;
+	}
+
+	if (is_in_pre_order_) {
+		start_linking_in_pre_order();
+	}
+
+	// the child moves to the end of the storage and the parent takes its place, so the child's index refers to the parent
+	nodes_.emplace_back(node);
+	std::swap(nodes_[first_child], nodes_[end]);
+
+	// the moved child follows right after the parent, with the child's descendants still following after it
+	if (first_child == last_in_pre_order_) {
+		next_in_pre_order_.emplace_back();
+		last_in_pre_order_ = end;
+	} else {
+		next_in_pre_order_.emplace_back(next_in_pre_order_[first_child]);
+		pre_order_tail_start_ = end + 1;
+	}
+	next_in_pre_order_[first_child] = end;
 	return first_child;
 }
 
-AstNode& Ast::get(Ast::NodeIndex index) {
+const AstNode& Ast::get(Ast::NodeIndex index) const {
 	return nodes_[index];
 }
 
-void Ast::undo_nodes_from_lookahead(NodeIndex first) {
-	nodes_.erase(nodes_.begin() + static_cast<ptrdiff_t>(first), nodes_.end());
+const Ast::SkippedBody* Ast::find_skipped_body(const AstFunctionDefinition& definition) const {
+	const auto offset = definition.header.offset;
+	auto body = std::ranges::lower_bound(skipped_bodies_, offset, {}, &SkippedBody::definition_offset);
+	if (body != skipped_bodies_.end() && body->definition_offset == offset) {
+		return &*body;
+	}
+	return nullptr;
+}
+
+void Ast::store_copies(const Ast& other, std::span<const AstNode> nodes, SourceOffset shift) {
+	// only what refers outside the node needs to be adjusted: names are moved along with the source text, while the values of
+	// string literals and the rest of function definitions are copied over from the other AST
+	auto copy_node = [&]<typename Node>(AstNode copy) {
+		copy.offset_ += shift;
+		if constexpr (std::is_same_v<Node, AstFunctionDefinition>) {
+			auto rest = other.function_definition_rests_[copy.values_[1]];
+			rest.name_offset += rest.name_length == 0 ? 0 : shift;
+			copy.values_[1] = static_cast<uint32_t>(function_definition_rests_.size());
+			function_definition_rests_.emplace_back(rest);
+		} else if constexpr (std::is_same_v<Node, AstStringLiteralExpr>) {
+			const auto offset = static_cast<uint32_t>(string_values_.size());
+			string_values_.append(other.string_values_, copy.values_[0], copy.values_[1]);
+			copy.values_[0] = offset;
+		} else if constexpr (has_name<Node>) {
+			copy.values_[0] += copy.values_[1] == 0 ? 0 : shift;
+		}
+		return copy;
+	};
+
+	if (is_in_pre_order_) {
+		nodes_.reserve(nodes_.size() + nodes.size());
+	}
+	for (auto node : nodes) {
+		switch (node.get_kind()) {
+#define CERO_AST_NODE_KIND(X)                                                                                                  \
+	case AstNodeKind::X: store(copy_node.operator()<Ast##X>(node)); break;
+			CERO_AST_NODE_KINDS
+#undef CERO_AST_NODE_KIND
+		}
+	}
+}
+
+Ast::Checkpoint Ast::save_checkpoint() const {
+	const auto num_string_bytes = static_cast<uint32_t>(string_values_.size());
+	return Checkpoint {static_cast<NodeIndex>(nodes_.size()), last_in_pre_order_, pre_order_tail_start_, num_string_bytes,
+					   is_in_pre_order_};
+}
+
+void Ast::undo_nodes_from_lookahead(Checkpoint checkpoint) {
+	// nodes stored during the lookahead only ever become parents of each other, so the nodes before it are left as they were
+	nodes_.erase(nodes_.begin() + static_cast<ptrdiff_t>(checkpoint.num_nodes), nodes_.end());
+	string_values_.resize(checkpoint.num_string_bytes);
+	next_in_pre_order_.resize(checkpoint.is_in_pre_order ? 0 : checkpoint.num_nodes);
+	last_in_pre_order_ = checkpoint.last_in_pre_order;
+	pre_order_tail_start_ = checkpoint.pre_order_tail_start;
+	is_in_pre_order_ = checkpoint.is_in_pre_order;
+}
+
+void Ast::start_linking_in_pre_order() {
+	const auto num_nodes = static_cast<NodeIndex>(nodes_.size());
+	next_in_pre_order_.resize(num_nodes);
+	std::iota(next_in_pre_order_.begin(), next_in_pre_order_.end(), 1);
+	last_in_pre_order_ = num_nodes - 1;
+	pre_order_tail_start_ = 0;
+	is_in_pre_order_ = false;
+}
+
+void Ast::link_as_last_in_pre_order(NodeIndex index) {
+	next_in_pre_order_.emplace_back();
+	if (last_in_pre_order_ != index - 1) {
+		pre_order_tail_start_ = index;
+	}
+	next_in_pre_order_[last_in_pre_order_] = index;
+	last_in_pre_order_ = index;
+}
+
+void Ast::finish_pre_order() {
+	if (!is_in_pre_order_) {
+		// turn the links into the position of each node in pre-order, then move every node to its position by following the
+		// cycles of the permutation, which moves each node at most once into its final place
+		auto& positions = next_in_pre_order_;
+		NodeIndex index = 0;
+		for (NodeIndex position = 0; position != nodes_.size(); ++position) {
+			const auto next = positions[index];
+			positions[index] = position;
+			index = next;
+		}
+
+		for (NodeIndex i = 0; i != nodes_.size(); ++i) {
+			while (positions[i] != i) {
+				const auto target = positions[i];
+				std::swap(nodes_[i], nodes_[target]);
+				std::swap(positions[i], positions[target]);
+			}
+		}
+		is_in_pre_order_ = true;
+	}
+
+	next_in_pre_order_ = {};
 }
 
 } // namespace cero
@@ -4,15 +4,19 @@
 #include "cero/syntax/AstNode.hpp"
 #include "cero/syntax/AstVisitor.hpp"
 #include "cero/syntax/TokenStream.hpp"
+#include "cero/util/BinaryStream.hpp"
 
+#include <optional>
 #include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace cero {
 
 /// Stores the abstract syntax tree for one source file. Contains no type information and is immutable. The underlying dynamic
-/// array stores the AST nodes in pre-order.
+/// array stores the AST nodes in pre-order, in their compact form. Names in the AST are views into the source text that it
+/// was parsed from, which must outlive it.
 class Ast {
 public:
 	/// Number of AST nodes.
@@ -24,36 +28,214 @@ public:
 	/// Get a view of the underlying storage.
 	std::span<const AstNode> raw() const;
 
+	/// Number of times the parser looked ahead to find out whether a left angle bracket begins generic arguments while
+	/// building this AST, including the lookaheads whose nodes were discarded. Zero for an AST copied out of the binary
+	/// format.
+	uint32_t num_generic_lookaheads() const;
+
+	/// Decodes the given node of this AST into the struct of its kind, which must be the given type.
+	template<typename Node>
+	Node as(const AstNode& node) const {
+		if (node.get_kind() != decltype(Node::header)::Kind) {
+			fail_check("node does not hold expected type");
+		}
+		return decode<Node>(node);
+	}
+
+	/// Decodes the given node of this AST into the struct of its kind if that is the given type, or returns nothing otherwise.
+	template<typename Node>
+	std::optional<Node> get(const AstNode& node) const {
+		if (node.get_kind() != decltype(Node::header)::Kind) {
+			return std::nullopt;
+		}
+		return decode<Node>(node);
+	}
+
+	/// Calls the visitor with the given node of this AST, decoded into the struct of its kind.
+	void visit(const AstNode& node, AstVisitor& visitor) const;
+
+	/// Whether the body of the given function definition in this AST was skipped while parsing signatures only, so that it can
+	/// be parsed on demand with parse_function_body.
+	bool has_skipped_body(const AstFunctionDefinition& definition) const;
+
 	/// Creates a tree-like string representation of the AST.
 	std::string to_string(const SourceGuard& source) const;
 
 private:
+	using NodeIndex = uint32_t;
+
 	std::vector<AstNode> nodes_;
+	std::string_view source_text_;
+	std::string string_values_; // values of the string literals, one after another
 	bool has_errors_ = false;
+	uint32_t num_generic_lookaheads_ = 0;
 	uint16_t current_num_children_ = 0;
 	uint32_t current_num_descendants_ = 0;
 
-	using NodeIndex = uint32_t;
+	// A parent that is only known after its first child was stored is normally inserted in front of the child, which shifts
+	// the nodes of the child's subtree. When that subtree is large, the parent is swapped into the child's place instead, and
+	// from then on the nodes are linked in pre-order until finish_pre_order puts them back in that order. This keeps building
+	// the AST linear even for long operator chains, while ASTs without such chains never pay for the links.
+	std::vector<NodeIndex> next_in_pre_order_;
+	NodeIndex last_in_pre_order_ = 0;
+	NodeIndex pre_order_tail_start_ = 0; // nodes from here to the end are stored in pre-order, as the last ones in it
+	bool is_in_pre_order_ = true;
+
+	/// Tokens of a function body that was skipped while parsing signatures only.
+	struct SkippedBody {
+		SourceOffset definition_offset = 0;
+		uint32_t begin = 0; // index of the opening brace
+		uint32_t end = 0;	// index of the token after the closing brace
+	};
+
+	std::vector<SkippedBody> skipped_bodies_; // in source order
+
+	/// Tokens and nodes of one step of parsing the top-level definitions, which parses either a definition or the tokens that
+	/// are skipped to recover from a syntax error in one. Parsing a step only depends on the tokens it inspects, so reparsing
+	/// after an edit can reuse every step whose tokens the edit did not change.
+	struct DefinitionSpan {
+		uint32_t first_token = 0;
+		uint32_t end_token = 0; // one past the last token that the parser inspected, which can lie beyond the step
+		NodeIndex first_node = 0;
+		bool is_definition = false; // whether the step parsed a definition that counts as a child of the root
+		bool has_errors = false;
+	};
+
+	std::vector<DefinitionSpan> definition_spans_; // recorded only when parsing from a token stream
+
+	/// Members of a function definition that do not fit into its node, which refers to them by their index in place of its
+	/// name and keeps its number of children in place of its number of statements.
+	struct FunctionDefinitionRest {
+		SourceOffset name_offset = 0;
+		uint32_t name_length = 0;
+		uint16_t num_outputs = 0;
+	};
+
+	std::vector<FunctionDefinitionRest> function_definition_rests_;
+
+	/// Most nodes that inserting a parent may shift. Subtrees of more nodes get their parent swapped into place instead.
+	static constexpr NodeIndex MaxShiftedNodes = 64;
+
+	/// State of the AST before a lookahead, which the AST can be reset to after the lookahead.
+	struct Checkpoint {
+		NodeIndex num_nodes = 0;
+		NodeIndex last_in_pre_order = 0;
+		NodeIndex pre_order_tail_start = 0;
+		uint32_t num_string_bytes = 0;
+		bool is_in_pre_order = true;
+	};
+
+	/// Reserves storage for the AST of the given source text based on the number of tokens.
+	Ast(std::string_view source_text, size_t num_tokens);
+
+	/// Reserves more storage once the nodes have almost used it up, as much as the source text from the given offset onward is
+	/// expected to need when it has as many nodes per byte as the text before it. Lets the AST of a source whose number of
+	/// tokens is not known up front grow with few reallocations and little unused storage.
+	void reserve_by_progress(SourceOffset parsed_offset);
+
+	template<typename Node>
+	AstNode encode(const Node& node) {
+		if constexpr (std::is_same_v<Node, AstFunctionDefinition>) {
+			const auto rest_index = static_cast<uint32_t>(function_definition_rests_.size());
+			function_definition_rests_.emplace_back();
+			return encode_function_definition(node, rest_index);
+		} else {
+			return AstNode::encode(node, [&](const auto& field) {
+				using Field = std::remove_cvref_t<decltype(field)>;
+				if constexpr (std::is_same_v<Field, StringId>) {
+					return std::pair(locate_name(field), static_cast<uint32_t>(field.length()));
+				} else {
+					const auto offset = static_cast<uint32_t>(string_values_.size());
+					check(offset + field.length() <= UINT32_MAX, "string literals exceed the AST's limits");
+					string_values_ += field;
+					return std::pair(offset, static_cast<uint32_t>(field.length()));
+				}
+			});
+		}
+	}
+
+	template<typename Node>
+	Node decode(const AstNode& node) const {
+		if constexpr (std::is_same_v<Node, AstFunctionDefinition>) {
+			return decode_function_definition(node);
+		} else {
+			return node.decode<Node>([&](auto& field, uint32_t offset, uint32_t length) {
+				using Field = std::remove_cvref_t<decltype(field)>;
+				if constexpr (std::is_same_v<Field, StringId>) {
+					field = length == 0 ? StringId() : StringId(source_text_.data() + offset, length);
+				} else {
+					field.assign(string_values_, offset, length);
+				}
+			});
+		}
+	}
 
-	/// Reserves storage for the AST based on the number of tokens.
-	explicit Ast(const TokenStream& token_stream);
+	AstNode encode_function_definition(const AstFunctionDefinition& node, uint32_t rest_index);
+	AstFunctionDefinition decode_function_definition(const AstNode& node) const;
+
+	/// Gets the offset of a name in the source text.
+	SourceOffset locate_name(StringId name) const;
 
 	/// Stores a new node in the AST, positioning it as the rightmost child of the currently rightmost node. TODO: Not true
-	NodeIndex store(AstNode&& node);
+	template<typename Node>
+	NodeIndex store(const Node& node) {
+		return store(encode(node));
+	}
 
-	/// Stores a new node in the AST as the parent of a node already in the AST. For performance reasons, should only be used
-	/// when it cannot be known that a node must be the parent of an already stored node until after the child node was stored.
-	NodeIndex store_parent_of(NodeIndex first_child, AstNode&& node);
+	NodeIndex store(AstNode node);
 
-	AstNode& get(NodeIndex index);
+	/// Stores a new node in the AST as the parent of a node already in the AST, in amortized constant time. Must only be used
+	/// with the first node of the last subtree stored so far. Afterward, the index of the child refers to the parent, and the
+	/// indices of the child and its descendants are no longer valid.
+	template<typename Node>
+	NodeIndex store_parent_of(NodeIndex first_child, const Node& node) {
+		return store_parent_of(first_child, encode(node));
+	}
 
-	NodeIndex next_index() const {
-		return static_cast<NodeIndex>(nodes_.size());
+	NodeIndex store_parent_of(NodeIndex first_child, AstNode node);
+
+	/// Replaces the node at the given index with a node of the same kind, such as one decoded from it with updated members.
+	template<typename Node>
+	void replace(NodeIndex index, const Node& node) {
+		auto& stored = nodes_[index];
+		if (stored.get_kind() != decltype(Node::header)::Kind) {
+			fail_check("node does not hold expected type");
+		}
+
+		if constexpr (std::is_same_v<Node, AstFunctionDefinition>) {
+			stored = encode_function_definition(node, stored.values_[1]);
+		} else {
+			stored = encode(node);
+		}
 	}
 
-	void undo_nodes_from_lookahead(NodeIndex first);
+	const AstNode& get(NodeIndex index) const;
+
+	const SkippedBody* find_skipped_body(const AstFunctionDefinition& definition) const;
+
+	/// Stores copies of complete subtrees from another AST of the same source, after all nodes stored so far. When the other
+	/// AST is of the source before an edit, their offsets are shifted by the given amount, which wraps around for edits that
+	/// shorten the source, so that they and their names refer to the same text in the source after the edit.
+	void store_copies(const Ast& other, std::span<const AstNode> nodes, SourceOffset shift);
+
+	Checkpoint save_checkpoint() const;
 
+	void undo_nodes_from_lookahead(Checkpoint checkpoint);
+
+	/// Starts linking the nodes in pre-order, since they are about to no longer be stored in that order.
+	void start_linking_in_pre_order();
+
+	/// Links a newly stored node as the last one in pre-order.
+	void link_as_last_in_pre_order(NodeIndex index);
+
+	/// Puts the nodes in pre-order with a single pass, if they are not already. Must be called once all nodes are stored.
+	void finish_pre_order();
+
+	template<typename Cursor>
 	friend class Parser;
+
+	friend class AstBinaryView;
+	friend void write_binary_ast(BinaryWriter& writer, const Ast& ast);
 };
 
 } // namespace cero
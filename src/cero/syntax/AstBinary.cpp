@@ -0,0 +1,105 @@
+#include "AstBinary.hpp"
+
+namespace cero {
+
+void write_binary_ast(BinaryWriter& writer, const Ast& ast) {
+	AstBinaryHeader header;
+	header.has_errors = ast.has_errors();
+	writer.write(header);
+	writer.write_aligned_span(ast.raw());
+	writer.write_aligned_span(std::span(ast.function_definition_rests_));
+	writer.write_aligned_span(std::span(ast.string_values_.data(), ast.string_values_.size()));
+}
+
+std::optional<AstBinaryView> AstBinaryView::from(BinaryReader& reader, const SourceGuard& source) {
+	AstBinaryHeader header;
+	if (!reader.read(header) || header.magic != AstBinaryHeader::Magic
+		|| header.format_version != AstBinaryHeader::FormatVersion || header.has_errors > 1) {
+		return std::nullopt;
+	}
+
+	AstBinaryView view;
+	view.has_errors_ = header.has_errors == 1;
+	std::span<const char> string_values;
+	if (!reader.view_span(view.nodes_) || !reader.view_span(view.function_definition_rests_)
+		|| !reader.view_span(string_values) || view.nodes_.empty() || view.nodes_.size() > UINT32_MAX) {
+		return std::nullopt;
+	}
+	view.string_values_ = {string_values.data(), string_values.size()};
+
+	// in pre-order, the nodes form a single complete tree exactly when no node is left without its parent's subtree being
+	// complete, and every subtree is complete at the end
+	const size_t source_length = source.get_length();
+	uint64_t num_pending_subtrees = 1;
+	for (auto& node : view.nodes_) {
+		std::optional<uint32_t> num_children;
+		switch (node.get_kind()) {
+#define CERO_AST_NODE_KIND(X)                                                                                                  \
+	case AstNodeKind::X: num_children = view.validate_node<Ast##X>(node, source_length); break;
+			CERO_AST_NODE_KINDS
+#undef CERO_AST_NODE_KIND
+		}
+		if (num_pending_subtrees == 0 || !num_children) {
+			return std::nullopt;
+		}
+		num_pending_subtrees = num_pending_subtrees - 1 + *num_children;
+	}
+	if (num_pending_subtrees != 0 || view.nodes_[0].get_kind() != AstNodeKind::Root) {
+		return std::nullopt;
+	}
+	return view;
+}
+
+uint32_t AstBinaryView::num_nodes() const {
+	return static_cast<uint32_t>(nodes_.size());
+}
+
+bool AstBinaryView::has_errors() const {
+	return has_errors_;
+}
+
+std::span<const AstNode> AstBinaryView::raw() const {
+	return nodes_;
+}
+
+Ast AstBinaryView::to_ast(const SourceGuard& source) const {
+	Ast ast(source.get_text(), 0);
+	ast.nodes_.assign(nodes_.begin(), nodes_.end());
+	ast.function_definition_rests_.assign(function_definition_rests_.begin(), function_definition_rests_.end());
+	ast.string_values_ = string_values_;
+	ast.has_errors_ = has_errors_;
+	return ast;
+}
+
+template<typename Node>
+std::optional<uint32_t> AstBinaryView::validate_node(const AstNode& node, size_t source_length) const {
+	auto lies_within = [](uint32_t offset, uint32_t length, size_t limit) {
+		return length == 0 || uint64_t(offset) + length <= limit;
+	};
+
+	// a function definition refers to the rest of its members, and its number of statements is derived from its children
+	if constexpr (std::is_same_v<Node, AstFunctionDefinition>) {
+		if (node.values_[1] >= function_definition_rests_.size()) {
+			return std::nullopt;
+		}
+		auto& rest = function_definition_rests_[node.values_[1]];
+		if (!lies_within(rest.name_offset, rest.name_length, source_length)
+			|| node.values_[0] < uint32_t(node.short_count_) + rest.num_outputs) {
+			return std::nullopt;
+		}
+		return node.values_[0];
+	} else {
+		bool is_valid = true;
+		auto decoded = node.decode<Node>([&](auto& field, uint32_t offset, uint32_t length) {
+			using Field = std::remove_cvref_t<decltype(field)>;
+			const size_t limit = std::is_same_v<Field, StringId> ? source_length : string_values_.size();
+			is_valid &= lies_within(offset, length, limit);
+		});
+		if (!is_valid) {
+			return std::nullopt;
+		}
+		return decoded.num_children();
+	}
+}
+
+} // namespace cero
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "cero/io/Source.hpp"
+#include "cero/syntax/Ast.hpp"
+#include "cero/util/BinaryStream.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace cero {
+
+/// Leads every AST in the binary format. The header is followed by the nodes in the same 16-byte compact form that an Ast
+/// stores them in, then by the members of function definitions that do not fit into their nodes, and then by the values of
+/// all string literals, each written as an aligned span. Names are stored as ranges of the source, like an Ast stores them.
+struct AstBinaryHeader {
+	/// Identifies the format. Also rejects data written with the other byte order, since it is read as a single integer.
+	static constexpr uint32_t Magic = 0x54534143; // "CAST" in little-endian byte order
+
+	/// Version of the format, which must be incremented whenever the layout or meaning of any part of it changes.
+	static constexpr uint32_t FormatVersion = 2;
+
+	uint32_t magic = Magic;
+	uint32_t format_version = FormatVersion;
+	uint8_t has_errors = 0;
+	uint8_t reserved[3] = {};
+};
+
+/// Appends the AST in the binary format to the given writer. Since the format is the AST's own storage, this only copies it.
+void write_binary_ast(BinaryWriter& writer, const Ast& ast);
+
+/// Gives access to an AST in the binary format by reading from the bytes in place, so that an AST can be loaded by mapping a
+/// file, without decoding or allocating anything per node. Creating the view validates all of the bytes, so that reading
+/// from the view never fails: every node has a known kind, its names lie within the source and its string literal within the
+/// string literal values, and the nodes form a single tree.
+class AstBinaryView {
+public:
+	/// Views the AST that the reader is at, which must have been written for the given source, or returns nothing if the
+	/// bytes do not hold an AST in the binary format of this version. The bytes must outlive the view.
+	static std::optional<AstBinaryView> from(BinaryReader& reader, const SourceGuard& source);
+
+	/// Number of AST nodes.
+	uint32_t num_nodes() const;
+
+	/// Whether syntax errors were encountered during parsing.
+	bool has_errors() const;
+
+	/// Get a view of the nodes, which lie in the bytes that the view was created from.
+	std::span<const AstNode> raw() const;
+
+	/// Copies the AST out of the bytes, for the source that the view was created for.
+	Ast to_ast(const SourceGuard& source) const;
+
+private:
+	std::span<const AstNode> nodes_;
+	std::span<const Ast::FunctionDefinitionRest> function_definition_rests_;
+	std::string_view string_values_;
+	bool has_errors_ = false;
+
+	AstBinaryView() = default;
+
+	/// Checks the parts of a stored node that could otherwise make reading it fail, and returns its number of children, or
+	/// nothing if it is invalid.
+	template<typename Node>
+	std::optional<uint32_t> validate_node(const AstNode& node, size_t source_length) const;
+};
+
+} // namespace cero
@@ -6,13 +6,14 @@
 namespace cero {
 
 AstCursor::AstCursor(const Ast& ast) :
+	ast_(ast),
 	it_(ast.raw().begin()),
 	num_children_to_visit_(it_->num_children()) {
 }
 
 void AstCursor::visit_all(AstVisitor& visitor) {
 	ScopedAssign _(num_children_to_visit_, it_->num_children());
-	it_++->visit(visitor);
+	ast_.visit(*it_++, visitor);
 
 	while (num_children_to_visit_ > 0) {
 		visit_all(visitor);
@@ -26,6 +26,7 @@ public:
 	uint32_t num_children_to_visit() const;
 
 private:
+	const Ast& ast_;
 	std::span<const AstNode>::iterator it_;
 	uint32_t num_children_to_visit_;
 };
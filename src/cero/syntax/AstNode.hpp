@@ -1,136 +1,162 @@
 #pragma once
 
 #include "cero/io/Source.hpp"
+#include "cero/syntax/AstNodeFields.hpp"
 #include "cero/syntax/AstNodeKind.hpp"
-#include "cero/syntax/AstVisitor.hpp"
 #include "cero/util/Macros.hpp"
 #include "cero/util/Traits.hpp"
 
+#include <type_traits>
+
 namespace cero {
 
-union AstNode {
+/// An AST node in the compact form that an Ast stores, which takes up the same 16 bytes for every kind of node, so that nodes
+/// can be copied as plain bytes. The members of a node besides its header are stored by type, each in declaration order: the
+/// enumeration and the flags share one byte, the first 16-bit count is the short count, and the remaining counts take up the
+/// two values. A name takes up both values, as its offset and its length in the source text, and the value of a string literal
+/// does the same with the string storage of the Ast. A function definition has more members than fit, so the Ast keeps its
+/// name and its number of outputs separately. Use the Ast that stores a node to decode it into the struct of its kind.
+class AstNode {
 public:
 	AstNodeKind get_kind() const {
-		return Root_.header.kind;
+		return kind_;
 	}
 
-	uint32_t get_offset() const {
-		return Root_.header.offset;
+	SourceOffset get_offset() const {
+		return offset_;
 	}
 
 	uint32_t num_children() const {
-		switch (Root_.header.kind) {
+		switch (kind_) {
 #define CERO_AST_NODE_KIND(X)                                                                                                  \
-	case AstNodeKind::X: return X##_.num_children();
+	case AstNodeKind::X: return num_children_of<Ast##X>();
 			CERO_AST_NODE_KINDS
 #undef CERO_AST_NODE_KIND
 		}
 		fail_unreachable();
 	}
 
-	void visit(AstVisitor& visitor) const {
-		switch (Root_.header.kind) {
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	case AstNodeKind::X: visitor.visit(X##_); break;
-			CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
-		}
-	}
-
-	template<typename T>
-	T& as() {
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	if constexpr (std::is_same_v<T, Ast##X>) {                                                                                 \
-		if (Root_.header.kind == AstNodeKind::X) return X##_;                                                                  \
-                                                                                                                               \
-		fail_check("node does not hold expected type");                                                                        \
-	} else
-		CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
-		{
-			static_assert(always_false<T>, "T must be an AST node type.");
-		}
-	}
-
-	template<typename T>
-	const T& as() const {
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	if constexpr (std::is_same_v<T, Ast##X>) {                                                                                 \
-		if (Root_.header.kind == AstNodeKind::X) return X##_;                                                                  \
-                                                                                                                               \
-		fail_check("node does not hold expected type");                                                                        \
-	} else
-		CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
-		{
-			static_assert(always_false<T>, "T must be an AST node type.");
-		}
-	}
-
-	template<typename T>
-	T* get() {
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	if constexpr (std::is_same_v<T, Ast##X>) {                                                                                 \
-		return Root_.header.kind == AstNodeKind::X ? &X##_ : nullptr;                                                          \
-	} else
-		CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
-		{
-			static_assert(always_false<T>, "T must be an AST node type.");
-		}
-	}
-
-	template<typename T>
-	const T* get() const {
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	if constexpr (std::is_same_v<T, Ast##X>) {                                                                                 \
-		return Root_.header.kind == AstNodeKind::X ? &X##_ : nullptr;                                                          \
-	} else
-		CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
-		{
-			static_assert(always_false<T>, "T must be an AST node type.");
-		}
-	}
-
-	~AstNode() {
-		switch (Root_.header.kind) {
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	case AstNodeKind::X: X##_.~Ast##X(); break;
-			CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
-		}
+private:
+	AstNodeKind kind_ = AstNodeKind::Root;
+	uint8_t detail_ = 0; // enumeration in the low bits, flags in the high bits
+	uint16_t short_count_ = 0;
+	SourceOffset offset_ = 0;
+	uint32_t values_[2] = {};
+
+	static constexpr uint32_t FlagsShift = 6;
+
+	/// Whether the members of the given kind of node fit into the compact form.
+	template<typename Node>
+	static constexpr bool fits() {
+		using Fields = decltype(get_node_fields(std::declval<Node&>()));
+		return []<typename... Field>(std::type_identity<std::tuple<Field&...>>) {
+			uint32_t num_enums = 0;
+			uint32_t num_flags = 0;
+			uint32_t num_values = 0;
+			bool has_short_count = false;
+			auto count_field = [&]<typename F>(std::type_identity<F>) {
+				if constexpr (std::is_enum_v<F>) {
+					++num_enums;
+				} else if constexpr (std::is_same_v<F, bool>) {
+					++num_flags;
+				} else if constexpr (std::is_same_v<F, StringId> || std::is_same_v<F, std::string>) {
+					num_values += 2;
+				} else if constexpr (std::is_same_v<F, uint16_t>) {
+					num_values += has_short_count ? 1 : 0;
+					has_short_count = true;
+				} else {
+					++num_values;
+				}
+			};
+			(count_field(std::type_identity<std::remove_const_t<Field>>()), ...);
+			return num_enums <= 1 && num_flags <= 8 - FlagsShift && num_values <= std::extent_v<decltype(values_)>;
+		}(std::type_identity<Fields>());
 	}
 
-	AstNode(AstNode&& other) noexcept {
-		switch (other.Root_.header.kind) {
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	case AstNodeKind::X: new (&X##_) Ast##X(std::move(other.X##_)); break;
-			CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
+	template<typename Node>
+	uint32_t num_children_of() const {
+		if constexpr (std::is_same_v<Node, AstFunctionDefinition>) {
+			return values_[0]; // the Ast stores the number of children in place of the number of statements
+		} else {
+			return decode<Node>([](auto&, uint32_t, uint32_t) {}).num_children();
 		}
 	}
 
-	AstNode& operator=(AstNode&& other) noexcept {
-		this->~AstNode();
-		new (this) AstNode(std::move(other));
-		return *this;
+	/// Stores the members of the node, letting the given function turn a name or a string into the pair of values for it.
+	template<typename Node>
+	static AstNode encode(const Node& node, auto&& encode_string) {
+		static_assert(fits<Node>(), "members of the node must fit into the compact form");
+
+		AstNode encoded;
+		encoded.kind_ = node.header.kind;
+		encoded.offset_ = node.header.offset;
+
+		uint32_t num_flags = 0;
+		uint32_t num_values = 0;
+		bool has_short_count = false;
+		auto encode_field = [&](const auto& field) {
+			using Field = std::remove_cvref_t<decltype(field)>;
+			if constexpr (std::is_enum_v<Field>) {
+				CERO_ASSERT_DEBUG(static_cast<uint32_t>(field) < 1u << FlagsShift, "enumeration value does not fit");
+				encoded.detail_ = static_cast<uint8_t>(encoded.detail_ | static_cast<uint8_t>(field));
+			} else if constexpr (std::is_same_v<Field, bool>) {
+				encoded.detail_ = static_cast<uint8_t>(encoded.detail_ | field << (FlagsShift + num_flags++));
+			} else if constexpr (std::is_same_v<Field, StringId> || std::is_same_v<Field, std::string>) {
+				auto [offset, length] = encode_string(field);
+				encoded.values_[num_values++] = offset;
+				encoded.values_[num_values++] = length;
+			} else if constexpr (std::is_same_v<Field, uint16_t>) {
+				if (has_short_count) {
+					encoded.values_[num_values++] = field;
+				} else {
+					encoded.short_count_ = field;
+					has_short_count = true;
+				}
+			} else {
+				encoded.values_[num_values++] = field;
+			}
+		};
+		std::apply([&](auto&... fields) { (encode_field(fields), ...); }, get_node_fields(node));
+		return encoded;
 	}
 
-private:
-#define CERO_AST_NODE_KIND(X) Ast##X X##_;
-	CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
-
-#define CERO_AST_NODE_KIND(X)                                                                                                  \
-	AstNode(Ast##X&& node) :                                                                                                   \
-		X##_(std::move(node)) {                                                                                                \
+	/// Recreates the node from its members, letting the given function set a name or a string from its pair of values.
+	template<typename Node>
+	Node decode(auto&& decode_string) const {
+		Node node {offset_};
+
+		uint32_t num_flags = 0;
+		uint32_t num_values = 0;
+		bool has_short_count = false;
+		auto decode_field = [&](auto& field) {
+			using Field = std::remove_cvref_t<decltype(field)>;
+			if constexpr (std::is_enum_v<Field>) {
+				field = static_cast<Field>(detail_ & ((1u << FlagsShift) - 1));
+			} else if constexpr (std::is_same_v<Field, bool>) {
+				field = (detail_ >> (FlagsShift + num_flags++) & 1) != 0;
+			} else if constexpr (std::is_same_v<Field, StringId> || std::is_same_v<Field, std::string>) {
+				decode_string(field, values_[num_values], values_[num_values + 1]);
+				num_values += 2;
+			} else if constexpr (std::is_same_v<Field, uint16_t>) {
+				if (has_short_count) {
+					field = static_cast<uint16_t>(values_[num_values++]);
+				} else {
+					field = short_count_;
+					has_short_count = true;
+				}
+			} else {
+				field = values_[num_values++];
+			}
+		};
+		std::apply([&](auto&... fields) { (decode_field(fields), ...); }, get_node_fields(node));
+		return node;
 	}
-	CERO_AST_NODE_KINDS
-#undef CERO_AST_NODE_KIND
 
-	friend class Parser;
 	friend class Ast;
+	friend class AstBinaryView;
 };
 
+static_assert(sizeof(AstNode) == 16);
+static_assert(std::is_trivially_copyable_v<AstNode>);
+
 } // namespace cero
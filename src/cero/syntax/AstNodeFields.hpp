@@ -0,0 +1,66 @@
+#pragma once
+
+#include "cero/syntax/AstNodeKind.hpp"
+#include "cero/util/Traits.hpp"
+
+#include <tuple>
+#include <type_traits>
+
+namespace cero {
+
+/// Gets references to the members of an AST node besides its header, in declaration order. This lets code that handles every
+/// member in the same way, such as serialization, be written once for all kinds of nodes.
+inline auto get_node_fields(auto& node) {
+	using Node = std::remove_const_t<std::remove_reference_t<decltype(node)>>;
+	if constexpr (std::is_same_v<Node, AstRoot>) {
+		return std::tie(node.num_definitions);
+	} else if constexpr (std::is_same_v<Node, AstStructDefinition> || std::is_same_v<Node, AstEnumDefinition>) {
+		return std::tie(node.access, node.name);
+	} else if constexpr (std::is_same_v<Node, AstFunctionDefinition>) {
+		return std::tie(node.access, node.name, node.num_parameters, node.num_outputs, node.num_statements);
+	} else if constexpr (std::is_same_v<Node, AstFunctionParameter>) {
+		return std::tie(node.specifier, node.name, node.has_default_argument);
+	} else if constexpr (std::is_same_v<Node, AstFunctionOutput> || std::is_same_v<Node, AstNameExpr>) {
+		return std::tie(node.name);
+	} else if constexpr (std::is_same_v<Node, AstBlockStatement> || std::is_same_v<Node, AstWhileLoop>
+						 || std::is_same_v<Node, AstForLoop>) {
+		return std::tie(node.num_statements);
+	} else if constexpr (std::is_same_v<Node, AstBindingStatement>) {
+		return std::tie(node.specifier, node.has_type, node.name, node.has_initializer);
+	} else if constexpr (std::is_same_v<Node, AstIfExpr>) {
+		return std::tie(node.num_then_statements, node.num_else_statements);
+	} else if constexpr (std::is_same_v<Node, AstGenericNameExpr>) {
+		return std::tie(node.name, node.num_generic_args);
+	} else if constexpr (std::is_same_v<Node, AstMemberExpr>) {
+		return std::tie(node.member, node.num_generic_args);
+	} else if constexpr (std::is_same_v<Node, AstGroupExpr> || std::is_same_v<Node, AstCallExpr>
+						 || std::is_same_v<Node, AstIndexExpr>) {
+		return std::tie(node.num_args);
+	} else if constexpr (std::is_same_v<Node, AstArrayLiteralExpr>) {
+		return std::tie(node.num_elements);
+	} else if constexpr (std::is_same_v<Node, AstUnaryExpr> || std::is_same_v<Node, AstBinaryExpr>) {
+		return std::tie(node.op);
+	} else if constexpr (std::is_same_v<Node, AstReturnExpr>) {
+		return std::tie(node.num_expressions);
+	} else if constexpr (std::is_same_v<Node, AstThrowExpr>) {
+		return std::tie(node.has_expression);
+	} else if constexpr (std::is_same_v<Node, AstBreakExpr> || std::is_same_v<Node, AstContinueExpr>) {
+		return std::tie(node.has_label);
+	} else if constexpr (std::is_same_v<Node, AstNumericLiteralExpr>) {
+		return std::tie(node.kind);
+	} else if constexpr (std::is_same_v<Node, AstStringLiteralExpr>) {
+		return std::tie(node.value);
+	} else if constexpr (std::is_same_v<Node, AstPermissionExpr>) {
+		return std::tie(node.specifier, node.num_args);
+	} else if constexpr (std::is_same_v<Node, AstPointerTypeExpr>) {
+		return std::tie(node.has_permission);
+	} else if constexpr (std::is_same_v<Node, AstArrayTypeExpr>) {
+		return std::tie(node.has_bound);
+	} else if constexpr (std::is_same_v<Node, AstFunctionTypeExpr>) {
+		return std::tie(node.num_parameters, node.num_outputs);
+	} else {
+		static_assert(always_false<Node>, "Node must be an AST node type.");
+	}
+}
+
+} // namespace cero
@@ -38,7 +38,7 @@ using StringId = std::string_view;
 	CERO_AST_NODE_KIND(ArrayTypeExpr)                                                                                          \
 	CERO_AST_NODE_KIND(FunctionTypeExpr)
 
-enum class AstNodeKind {
+enum class AstNodeKind : uint8_t {
 #define CERO_AST_NODE_KIND(X) X,
 	CERO_AST_NODE_KINDS
 #undef CERO_AST_NODE_KIND
@@ -46,13 +46,15 @@ enum class AstNodeKind {
 
 template<AstNodeKind K>
 struct AstNodeHeader {
+	static constexpr AstNodeKind Kind = K;
+
 	const AstNodeKind kind : 8 = K;
-	const SourceOffset offset : SourceOffsetBits = 0;
+	const SourceOffset offset = 0; // full source offset, since nodes have room for it unlike tokens
 
 	AstNodeHeader() = default;
 
 	AstNodeHeader(SourceOffset source_offset) :
-		offset(source_offset & 0x00ffffffu) {
+		offset(source_offset) {
 	}
 
 	CodeLocation locate_in(const SourceGuard& source) const {
@@ -78,7 +80,7 @@ enum class AccessSpecifier : uint8_t {
 struct AstStructDefinition {
 	AstNodeHeader<AstNodeKind::StructDefinition> header;
 	AccessSpecifier access = {};
-	StringId name;
+	StringId name = {};
 
 	static uint32_t num_children() {
 		return 0;
@@ -88,7 +90,7 @@ struct AstStructDefinition {
 struct AstEnumDefinition {
 	AstNodeHeader<AstNodeKind::EnumDefinition> header;
 	AccessSpecifier access = {};
-	StringId name;
+	StringId name = {};
 
 	static uint32_t num_children() {
 		return 0;
@@ -98,7 +100,7 @@ struct AstEnumDefinition {
 struct AstFunctionDefinition {
 	AstNodeHeader<AstNodeKind::FunctionDefinition> header;
 	AccessSpecifier access = {};
-	StringId name;
+	StringId name = {};
 	uint16_t num_parameters = 0;
 	uint16_t num_outputs = 0;
 	uint32_t num_statements = 0;
@@ -117,7 +119,7 @@ enum class ParameterSpecifier : uint8_t {
 struct AstFunctionParameter {
 	AstNodeHeader<AstNodeKind::FunctionParameter> header;
 	ParameterSpecifier specifier = {};
-	StringId name;
+	StringId name = {};
 	bool has_default_argument = false;
 
 	uint32_t num_children() const {
@@ -127,7 +129,7 @@ struct AstFunctionParameter {
 
 struct AstFunctionOutput {
 	AstNodeHeader<AstNodeKind::FunctionOutput> header;
-	StringId name;
+	StringId name = {};
 
 	static uint32_t num_children() {
 		return 1;
@@ -155,7 +157,7 @@ struct AstBindingStatement {
 	AstNodeHeader<AstNodeKind::BindingStatement> header;
 	BindingSpecifier specifier = {};
 	bool has_type = false;
-	StringId name;
+	StringId name = {};
 	bool has_initializer = false;
 
 	uint32_t num_children() const {
@@ -193,7 +195,7 @@ struct AstForLoop {
 
 struct AstNameExpr {
 	AstNodeHeader<AstNodeKind::NameExpr> header;
-	StringId name;
+	StringId name = {};
 
 	static uint32_t num_children() {
 		return 0;
@@ -202,7 +204,7 @@ struct AstNameExpr {
 
 struct AstGenericNameExpr {
 	AstNodeHeader<AstNodeKind::GenericNameExpr> header;
-	StringId name;
+	StringId name = {};
 	uint16_t num_generic_args = 0;
 
 	uint32_t num_children() const {
@@ -212,7 +214,7 @@ struct AstGenericNameExpr {
 
 struct AstMemberExpr {
 	AstNodeHeader<AstNodeKind::MemberExpr> header;
-	StringId member;
+	StringId member = {};
 	uint16_t num_generic_args = 0;
 
 	uint32_t num_children() const {
@@ -381,7 +383,7 @@ struct AstNumericLiteralExpr {
 
 struct AstStringLiteralExpr {
 	AstNodeHeader<AstNodeKind::StringLiteralExpr> header;
-	std::string value;
+	std::string value = {};
 
 	static uint32_t num_children() {
 		return 0;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "cero/syntax/AstNode.hpp"
+#include "cero/syntax/AstNodeKind.hpp"
 
 namespace cero {
 
@@ -2,21 +2,6 @@
 
 namespace cero {
 
-struct CodePointRange {
-	uint32_t begin = 0;
-	uint32_t end = 0;
-
-	friend std::strong_ordering operator<=>(CodePointRange range, uint32_t code_point) {
-		if (range.begin > code_point) {
-			return std::strong_ordering::greater;
-		}
-		if (range.end < code_point) {
-			return std::strong_ordering::less;
-		}
-		return std::strong_ordering::equal;
-	}
-};
-
 static constexpr inline CodePointRange XID_START_RANGES[] {
 	{0x41, 0x5a},		{0x61, 0x7a},		{0xaa, 0xaa},		{0xb5, 0xb5},		{0xba, 0xba},		{0xc0, 0xd6},
 	{0xd8, 0xf6},		{0xf8, 0x2c1},		{0x2c6, 0x2d1},		{0x2e0, 0x2e4},		{0x2ec, 0x2ec},		{0x2ee, 0x2ee},
@@ -264,7 +249,103 @@ static constexpr inline CodePointRange XID_CONTINUE_RANGES[] {
 	{0xe0100, 0xe01ef},
 };
 
-static bool search_range_table(std::span<const CodePointRange> table, uint32_t encoded) {
+/// Number of low bits of a code point that select a bit within a bitmap block.
+constexpr inline uint32_t TrieBlockBits = 8;
+
+/// Number of code points covered by one bitmap block.
+constexpr inline uint32_t TrieBlockSize = 1 << TrieBlockBits;
+
+/// A bitmap with one bit per code point of a block.
+using TrieBlock = std::array<uint64_t, TrieBlockSize / 64>;
+
+/// Two-stage lookup table answering whether a code point is contained in a set of code points. The first stage maps the high
+/// bits of a code point to a bitmap block in the second stage, which is indexed with the low bits. Blocks that are entirely
+/// inside or outside of the set are shared, so only blocks on the border of a range need their own bitmap.
+template<size_t NumIndices, size_t NumBlocks>
+struct CodePointTrie {
+	std::array<uint16_t, NumIndices> block_indices = {};
+	std::array<TrieBlock, NumBlocks> blocks = {};
+
+	bool contains(uint32_t code_point) const {
+		const uint32_t high = code_point >> TrieBlockBits;
+		if (high >= NumIndices) {
+			return false;
+		}
+
+		const uint32_t low = code_point & (TrieBlockSize - 1);
+		return (blocks[block_indices[high]][low / 64] >> (low % 64)) & 1;
+	}
+};
+
+constexpr inline TrieBlock EmptyTrieBlock = {};
+constexpr inline TrieBlock FullTrieBlock = {UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX};
+
+/// Gets the number of first-stage indices needed to cover every code point in the range table.
+consteval size_t count_trie_indices(std::span<const CodePointRange> ranges) {
+	return (ranges.back().end >> TrieBlockBits) + 1;
+}
+
+/// Expands the range table into one bitmap block for every first-stage index.
+template<size_t NumIndices>
+consteval std::array<TrieBlock, NumIndices> make_trie_bitmaps(std::span<const CodePointRange> ranges) {
+	std::array<TrieBlock, NumIndices> bitmaps = {};
+	for (auto range : ranges) {
+		// set as many bits as fit into the current 64-bit word at once
+		for (uint32_t code_point = range.begin; code_point <= range.end;) {
+			const uint32_t bit = code_point % 64;
+			const uint32_t count = std::min(64 - bit, range.end - code_point + 1);
+			const uint64_t mask = (count == 64 ? UINT64_MAX : (uint64_t(1) << count) - 1) << bit;
+
+			bitmaps[code_point >> TrieBlockBits][(code_point & (TrieBlockSize - 1)) / 64] |= mask;
+			code_point += count;
+		}
+	}
+	return bitmaps;
+}
+
+/// Gets the number of distinct blocks needed for the given bitmaps, where the empty and the full block come first.
+template<size_t NumIndices>
+consteval size_t count_trie_blocks(const std::array<TrieBlock, NumIndices>& bitmaps) {
+	size_t num_blocks = 2;
+	for (auto& bitmap : bitmaps) {
+		if (bitmap != EmptyTrieBlock && bitmap != FullTrieBlock) {
+			++num_blocks;
+		}
+	}
+	return num_blocks;
+}
+
+template<size_t NumIndices, size_t NumBlocks>
+consteval CodePointTrie<NumIndices, NumBlocks> make_trie(const std::array<TrieBlock, NumIndices>& bitmaps) {
+	static_assert(NumBlocks <= UINT16_MAX, "Block indices must fit into the first stage of the trie.");
+
+	CodePointTrie<NumIndices, NumBlocks> trie;
+	trie.blocks[0] = EmptyTrieBlock;
+	trie.blocks[1] = FullTrieBlock;
+
+	uint16_t next_block = 2;
+	for (size_t i = 0; i != NumIndices; ++i) {
+		if (bitmaps[i] == EmptyTrieBlock) {
+			trie.block_indices[i] = 0;
+		} else if (bitmaps[i] == FullTrieBlock) {
+			trie.block_indices[i] = 1;
+		} else {
+			trie.blocks[next_block] = bitmaps[i];
+			trie.block_indices[i] = next_block++;
+		}
+	}
+	return trie;
+}
+
+static constexpr auto XID_START_BITMAPS = make_trie_bitmaps<count_trie_indices(XID_START_RANGES)>(XID_START_RANGES);
+static constexpr auto XID_START_TRIE =
+	make_trie<XID_START_BITMAPS.size(), count_trie_blocks(XID_START_BITMAPS)>(XID_START_BITMAPS);
+
+static constexpr auto XID_CONTINUE_BITMAPS = make_trie_bitmaps<count_trie_indices(XID_CONTINUE_RANGES)>(XID_CONTINUE_RANGES);
+static constexpr auto XID_CONTINUE_TRIE =
+	make_trie<XID_CONTINUE_BITMAPS.size(), count_trie_blocks(XID_CONTINUE_BITMAPS)>(XID_CONTINUE_BITMAPS);
+
+static uint32_t decode_utf8(uint32_t encoded) {
 	static constexpr uint8_t Lengths[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
 										  0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 3, 3, 4, 0};
 	static constexpr uint32_t Masks[] = {0x00, 0x7f, 0x1f, 0x0f, 0x07};
@@ -280,15 +361,23 @@ static bool search_range_table(std::span<const CodePointRange> table, uint32_t e
 	code_point |= (byte_ptr[3] & 0x3fu) << 0;
 	code_point >>= Shifts[length];
 
-	return std::binary_search(table.begin(), table.end(), code_point);
+	return code_point;
 }
 
 bool is_utf8_xid_start(uint32_t encoded) {
-	return search_range_table(XID_START_RANGES, encoded);
+	return XID_START_TRIE.contains(decode_utf8(encoded));
 }
 
 bool is_utf8_xid_continue(uint32_t encoded) {
-	return search_range_table(XID_CONTINUE_RANGES, encoded);
+	return XID_CONTINUE_TRIE.contains(decode_utf8(encoded));
+}
+
+std::span<const CodePointRange> get_xid_start_ranges() {
+	return XID_START_RANGES;
+}
+
+std::span<const CodePointRange> get_xid_continue_ranges() {
+	return XID_CONTINUE_RANGES;
 }
 
 } // namespace cero
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 namespace cero {
 
@@ -27,4 +28,16 @@ inline bool is_whitespace(char c) {
 bool is_utf8_xid_start(uint32_t encoded);
 bool is_utf8_xid_continue(uint32_t encoded);
 
+/// Inclusive range of code points. The range tables are sorted and their ranges don't overlap.
+struct CodePointRange {
+	uint32_t begin = 0;
+	uint32_t end = 0;
+};
+
+/// Gets the range table of the code points with the XID_Start property, from which is_utf8_xid_start's lookup is built.
+std::span<const CodePointRange> get_xid_start_ranges();
+
+/// Gets the range table of the code points with the XID_Continue property, from which is_utf8_xid_continue's lookup is built.
+std::span<const CodePointRange> get_xid_continue_ranges();
+
 } // namespace cero
@@ -3,17 +3,122 @@
 #include "cero/io/Message.hpp"
 #include "cero/syntax/Encoding.hpp"
 #include "cero/syntax/SourceCursor.hpp"
+#include "cero/util/Fail.hpp"
 
 namespace cero {
 
+// Keywords are recognized with a table that is derived at compile time from the fixed lexemes of their token kinds, so a new
+// keyword only needs its token kind and lexeme.
+
+constexpr TokenKind FirstKeywordKind = TokenKind::Break;
+constexpr TokenKind LastKeywordKind = TokenKind::While;
+
+struct KeywordEntry {
+	std::string_view lexeme;
+	TokenKind kind = TokenKind::Name;
+};
+
+constexpr size_t KeywordTableBits = 6;
+
+/// Hashes a word by its first and last character and its length, which together already tell all keywords apart.
+constexpr size_t hash_keyword(std::string_view word, uint32_t multiplier) {
+	const uint32_t key = static_cast<uint32_t>(static_cast<uint8_t>(word.front())) << 16
+						 | static_cast<uint32_t>(static_cast<uint8_t>(word.back())) << 8
+						 | static_cast<uint32_t>(word.length());
+	return (key * multiplier) >> (32 - KeywordTableBits);
+}
+
+/// Searches for a hash multiplier that maps every keyword to its own slot, making the keyword table a perfect hash table.
+consteval uint32_t find_keyword_hash_multiplier() {
+	for (uint32_t multiplier = 0x9e3779b1; multiplier != 0x9e3779b1 + 100'000; multiplier += 2) {
+		std::array<bool, 1 << KeywordTableBits> taken {};
+		bool collided = false;
+		for (auto kind = FirstKeywordKind; kind <= LastKeywordKind; kind = static_cast<TokenKind>(static_cast<int>(kind) + 1)) {
+			auto& slot = taken[hash_keyword(get_fixed_length_lexeme(kind), multiplier)];
+			collided |= slot;
+			slot = true;
+		}
+		if (!collided) {
+			return multiplier;
+		}
+	}
+	return 0;
+}
+
+constexpr uint32_t KeywordHashMultiplier = find_keyword_hash_multiplier();
+static_assert(KeywordHashMultiplier != 0, "no perfect hash found for the keywords, try a bigger table");
+
+consteval std::array<KeywordEntry, 1 << KeywordTableBits> make_keyword_table() {
+	std::array<KeywordEntry, 1 << KeywordTableBits> table {};
+	for (auto kind = FirstKeywordKind; kind <= LastKeywordKind; kind = static_cast<TokenKind>(static_cast<int>(kind) + 1)) {
+		const auto lexeme = get_fixed_length_lexeme(kind);
+		table[hash_keyword(lexeme, KeywordHashMultiplier)] = {lexeme, kind};
+	}
+	return table;
+}
+
+constexpr auto KEYWORD_TABLE = make_keyword_table();
+
+constexpr auto KEYWORD_LENGTHS = [] {
+	size_t min = SIZE_MAX, max = 0;
+	for (auto& entry : KEYWORD_TABLE) {
+		if (!entry.lexeme.empty()) {
+			min = std::min(min, entry.lexeme.length());
+			max = std::max(max, entry.lexeme.length());
+		}
+	}
+	return std::pair(min, max);
+}();
+
+/// Whether the token at the given index might be the second token of a pair, which is lexed together with the token before it
+/// instead of on its own.
+constexpr bool may_be_second_of_pair(std::span<const Token> tokens, size_t index) {
+	if (index == 0 || tokens[index - 1].kind != tokens[index].kind || tokens[index - 1].offset + 1 != tokens[index].offset) {
+		return false;
+	}
+	// ".." and ">>" are always split into two single-character tokens
+	return tokens[index].kind == TokenKind::Dot || tokens[index].kind == TokenKind::RAngle;
+}
+
+/// Diagnostic from a chunk lexed in parallel, held back until the chunks are stitched together in source order.
+struct PendingReport {
+	Message message;
+	SourceOffset offset;
+	MessageArgs args;
+};
+
+/// Tokens and held back diagnostics from lexing one chunk of a source under the assumption that the chunk starts where a
+/// token starts.
+struct LexedChunk {
+	TokenStream stream;
+	std::vector<PendingReport> reports;
+	std::vector<SourceOffset> sync_offsets; // start offsets of the tokens near the beginning of the chunk
+	std::vector<uint32_t> bracket_tokens;	// indices of the brackets, which are matched up once the chunk is stitched
+	SourceOffset end = 0;					// offset at which the next chunk begins
+	SourceOffset stop = 0;					// offset of the first token at or after the end, or the source length
+};
+
+/// How far into a chunk token offsets are remembered to find the point where stitching can switch over to the chunk.
+constexpr SourceOffset ChunkSyncWindow = 16 * 1024;
+
 class Lexer {
 public:
-	Lexer(const SourceGuard& source, Reporter& reporter, bool lex_comments) :
+	Lexer(const SourceGuard& source, Reporter& reporter, CommentMode comment_mode, ScanMode scan_mode) :
+		Lexer(source, reporter, comment_mode, scan_mode, 0, source.get_length()) {
+	}
+
+	Lexer(const SourceGuard& source,
+		  Reporter& reporter,
+		  CommentMode comment_mode,
+		  ScanMode scan_mode,
+		  SourceOffset begin,
+		  size_t expected_length) :
 		source_(source),
 		reporter_(reporter),
-		cursor_(source),
-		stream_(source),
-		lex_comments_(lex_comments) {
+		scanner_(Scanner::get(scan_mode)),
+		cursor_(source, begin),
+		stream_(expected_length),
+		comment_mode_(comment_mode) {
 	}
 
 	TokenStream lex() && {
@@ -24,80 +129,311 @@ public:
 			lex_source();
 		}
 
-		stream_.add_token(TokenKind::EndOfFile, cursor_.offset());
+		stream_.add_token(TokenKind::EndOfFile, cursor_.offset(), 0);
+		finish_brackets();
+		stream_.finish();
+		return std::move(stream_);
+	}
+
+	/// Lexes from the current position up to the first token that starts at or after the given end offset. Diagnostics are
+	/// held back instead of reported, because the chunk might not actually begin at a token boundary.
+	LexedChunk lex_chunk(SourceOffset end) && {
+		holds_reports_ = true;
+		defers_brackets_ = true;
+
+		std::vector<SourceOffset> sync_offsets;
+		const auto sync_window_end = cursor_.offset() + ChunkSyncWindow;
+		while (skip_whitespace()) {
+			const auto offset = cursor_.offset();
+			if (offset >= end) {
+				break;
+			}
+			if (offset < sync_window_end) {
+				sync_offsets.emplace_back(offset);
+			}
+			lex_token();
+		}
+
+		stream_.join_segments(); // the tokens are copied into the stitched stream anyway, so shrinking would be wasted work
+		return LexedChunk {std::move(stream_), std::move(pending_reports_), std::move(sync_offsets),
+						   std::move(bracket_tokens_), end, cursor_.offset()};
+	}
+
+	/// Combines chunks lexed in parallel into a single token stream, reporting their diagnostics in source order. Since the
+	/// lexer carries no state from one token to the next, a chunk's results are correct from the first token it shares with
+	/// the sequential lexing of the source. Wherever a chunk did not begin at a token boundary, for example because it begins
+	/// inside a block comment, its start is relexed here until the two agree again.
+	TokenStream stitch(std::span<LexedChunk> chunks) && {
+		for (auto& chunk : chunks) {
+			while (skip_whitespace() && cursor_.offset() < chunk.end) {
+				const auto offset = cursor_.offset();
+				if (std::binary_search(chunk.sync_offsets.begin(), chunk.sync_offsets.end(), offset)) {
+					splice(chunk, offset);
+					break;
+				}
+				lex_token();
+			}
+		}
+
+		stream_.add_token(TokenKind::EndOfFile, cursor_.offset(), 0);
+		finish_brackets();
+		stream_.finish();
+		return std::move(stream_);
+	}
+
+	/// Lexes tokens into the given buffers until they have no room for two more tokens or the end of the source is reached.
+	/// Every bracket that was closed, or that is known to stay unclosed, since the last call is appended to the given pairs.
+	uint32_t lex_into(std::span<Token> tokens, std::span<uint32_t> lengths, std::vector<BracketPair>& resolved_brackets) {
+		if (has_reached_end_) {
+			return 0;
+		}
+		resolved_brackets_ = &resolved_brackets;
+
+		// the stream serves as a staging buffer, reserved so that no token ever has to go into another segment
+		stream_.stream_.clear();
+		stream_.lengths_.clear();
+		stream_.stream_.reserve(tokens.size());
+		stream_.lengths_.reserve(tokens.size());
+
+		while (!has_reached_end_ && stream_.stream_.size() + 2 <= tokens.size()) {
+			if (skip_whitespace()) {
+				lex_token();
+			} else {
+				stream_.add_token(TokenKind::EndOfFile, cursor_.offset(), 0);
+				finish_brackets();
+				has_reached_end_ = true;
+			}
+		}
+
+		std::copy(stream_.stream_.begin(), stream_.stream_.end(), tokens.begin());
+		std::copy(stream_.lengths_.begin(), stream_.lengths_.end(), lengths.begin());
+		const auto num_lexed = static_cast<uint32_t>(stream_.stream_.size());
+		num_batched_tokens_ += num_lexed;
+		return num_lexed;
+	}
+
+	bool has_errors() const {
+		return stream_.has_errors();
+	}
+
+	/// Lexes the source after an edit, reusing the tokens that the edit cannot have changed from the stream lexed before it.
+	TokenStream relex(const TokenStream& old_stream, SourceEdit edit) && {
+		const auto old_tokens = old_stream.raw().first(old_stream.num_tokens() - 1); // without the end-of-file token
+		auto offset_less = [](Token token, SourceOffset value) {
+			return token.offset < value;
+		};
+
+		// a token can look ahead past its lexeme up to the first character of the token after the next one, like a number does
+		// to find out whether a fraction follows, so a token is only kept if that character lies before the edit
+		auto edited = std::lower_bound(old_tokens.begin(), old_tokens.end(), edit.offset, offset_less);
+		auto num_kept = static_cast<uint32_t>(std::max(edited - old_tokens.begin() - 2, ptrdiff_t(0)));
+		while (may_be_second_of_pair(old_tokens, num_kept)) {
+			--num_kept;
+		}
+		const SourceOffset restart = num_kept == 0 ? 0 : old_tokens[num_kept].offset;
+
+		stream_.add_tokens(old_tokens.first(num_kept), old_stream.raw_lengths().first(num_kept));
+		for (uint32_t i = 0; i != num_kept; ++i) {
+			match_bracket(old_tokens[i].kind, i);
+		}
+		for (auto& trivia : old_stream.raw_trivia()) {
+			if (trivia.offset < restart) {
+				stream_.add_trivia(trivia);
+			}
+		}
+		for (auto error_offset : old_stream.error_offsets_) {
+			if (error_offset < restart) {
+				stream_.add_error(error_offset);
+			}
+		}
+		cursor_ = SourceCursor(source_, restart);
+
+		// behind the edit, the lexer is back in sync once it is about to lex a token where one was lexed on its own before,
+		// since the lexer carries no state from one token to the next and the text from there on is unchanged
+		const SourceOffset edit_end = edit.offset + edit.new_length;
+		const SourceOffset shift = edit.new_length - edit.old_length; // wraps around when the edit shortens the source
+		auto old_token = std::lower_bound(edited, old_tokens.end(), edit.offset + edit.old_length, offset_less);
+		while (skip_whitespace()) {
+			const auto offset = cursor_.offset();
+			if (offset >= edit_end) {
+				const SourceOffset old_offset = offset - shift;
+				while (old_token != old_tokens.end() && old_token->offset < old_offset) {
+					++old_token;
+				}
+				const auto index = static_cast<uint32_t>(old_token - old_tokens.begin());
+				if (old_token != old_tokens.end() && old_token->offset == old_offset
+					&& !may_be_second_of_pair(old_tokens, index)) {
+					splice_shifted(old_stream, index, shift);
+					finish_brackets();
+					stream_.finish();
+					return std::move(stream_);
+				}
+			}
+			lex_token();
+		}
+
+		stream_.add_token(TokenKind::EndOfFile, cursor_.offset(), 0);
+		finish_brackets();
+		stream_.finish();
 		return std::move(stream_);
 	}
 
 private:
+	/// Opening bracket that no token closed yet.
+	struct OpenBracket {
+		uint32_t token_index = 0;
+		uint32_t kind_index = 0; // 0 for braces, 1 for parentheses and 2 for square brackets
+	};
+
 	const SourceGuard& source_;
 	Reporter& reporter_;
+	const Scanner& scanner_;
 	SourceCursor cursor_;
 	TokenStream stream_;
-	const bool lex_comments_;
+	std::vector<PendingReport> pending_reports_;
+
+	// the number of open brackets of each kind tells right away whether a closing token matches any, so that searching
+	// through the open brackets for its match always ends at one
+	std::vector<OpenBracket> open_brackets_;
+	std::array<uint32_t, 3> num_open_brackets_ = {};
+	std::vector<uint32_t> bracket_tokens_;					// brackets of a chunk, whose matches are not known yet
+	std::vector<BracketPair>* resolved_brackets_ = nullptr; // where brackets go when lexing in batches
+	uint32_t num_batched_tokens_ = 0;						// tokens handed out by earlier batches
+
+	const CommentMode comment_mode_;
+	bool holds_reports_ = false;
+	bool defers_brackets_ = false;
+	bool has_reached_end_ = false;
 
 	void lex_source() {
+		while (skip_whitespace()) {
+			lex_token();
+		}
+	}
+
+	/// Advances past any whitespace and returns whether a token follows.
+	bool skip_whitespace() {
 		while (auto next = cursor_.peek()) {
-			const char character = *next;
-			if (is_whitespace(character)) {
-				cursor_.advance();
-				continue;
+			if (!is_whitespace(*next)) {
+				return true;
 			}
+			cursor_.advance_by(scanner_.count_whitespace(cursor_.remaining()));
+		}
+		return false;
+	}
 
-			const auto offset = cursor_.offset();
-			cursor_.advance();
-			switch (character) {
-					// clang-format off
-				case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H': case 'I':
-				case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P': case 'Q': case 'R':
-				case 'S': case 'T': case 'U': case 'V': case 'W': case 'X': case 'Y': case 'Z': case '_':
-
-				case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i':
-				case 'j': case 'k': case 'l': case 'm': case 'n': case 'o': case 'p': case 'q': case 'r':
-				case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
-					lex_word(offset); break;
-					// clang-format on
-
-				case '0': lex_zero(offset); break;
-				case '1':
-				case '2':
-				case '3':
-				case '4':
-				case '5':
-				case '6':
-				case '7':
-				case '8':
-				case '9': lex_number(offset); break;
-
-				case '(':  stream_.add_token(TokenKind::LParen, offset); break;
-				case ')':  stream_.add_token(TokenKind::RParen, offset); break;
-				case '[':  stream_.add_token(TokenKind::LBracket, offset); break;
-				case ']':  stream_.add_token(TokenKind::RBracket, offset); break;
-				case '{':  stream_.add_token(TokenKind::LBrace, offset); break;
-				case '}':  stream_.add_token(TokenKind::RBrace, offset); break;
-				case ',':  stream_.add_token(TokenKind::Comma, offset); break;
-				case ';':  stream_.add_token(TokenKind::Semicolon, offset); break;
-				case '^':  stream_.add_token(TokenKind::Caret, offset); break;
-				case '?':  stream_.add_token(TokenKind::Quest, offset); break;
-				case '@':  stream_.add_token(TokenKind::At, offset); break;
-				case '#':  stream_.add_token(TokenKind::Hash, offset); break;
-				case '$':  stream_.add_token(TokenKind::Dollar, offset); break;
-				case '+':  stream_.add_token(lex_plus(), offset); break;
-				case '-':  stream_.add_token(lex_minus(), offset); break;
-				case '*':  stream_.add_token(lex_star(), offset); break;
-				case '/':  lex_slash(offset); break;
-				case '%':  stream_.add_token(lex_percent(), offset); break;
-				case '&':  stream_.add_token(lex_ampersand(), offset); break;
-				case '|':  stream_.add_token(lex_pipe(), offset); break;
-				case '~':  stream_.add_token(lex_tilde(), offset); break;
-				case '!':  stream_.add_token(lex_bang(), offset); break;
-				case ':':  stream_.add_token(lex_colon(), offset); break;
-				case '=':  stream_.add_token(lex_equal(), offset); break;
-				case '<':  stream_.add_token(lex_left_angle(), offset); break;
-				case '>':  lex_right_angle(offset); break;
-				case '.':  lex_dot(offset); break;
-				case '"':  lex_quoted_sequence(TokenKind::StringLiteral, offset, '"'); break;
-				case '\'': lex_quoted_sequence(TokenKind::CharLiteral, offset, '\''); break;
-				default:   lex_unicode_name(character, offset); break;
+	void lex_token() {
+		const auto offset = cursor_.offset();
+		const char character = *cursor_.next();
+		switch (character) {
+				// clang-format off
+			case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H': case 'I':
+			case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P': case 'Q': case 'R':
+			case 'S': case 'T': case 'U': case 'V': case 'W': case 'X': case 'Y': case 'Z': case '_':
+
+			case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i':
+			case 'j': case 'k': case 'l': case 'm': case 'n': case 'o': case 'p': case 'q': case 'r':
+			case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
+				lex_word(offset); break;
+				// clang-format on
+
+			case '0': lex_zero(offset); break;
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9': lex_number(offset); break;
+
+			case '(':  add_opening_bracket(TokenKind::LParen, offset); break;
+			case ')':  add_closing_bracket(TokenKind::RParen, offset); break;
+			case '[':  add_opening_bracket(TokenKind::LBracket, offset); break;
+			case ']':  add_closing_bracket(TokenKind::RBracket, offset); break;
+			case '{':  add_opening_bracket(TokenKind::LBrace, offset); break;
+			case '}':  add_closing_bracket(TokenKind::RBrace, offset); break;
+			case ',':  add_token(TokenKind::Comma, offset); break;
+			case ';':  add_token(TokenKind::Semicolon, offset); break;
+			case '^':  add_token(TokenKind::Caret, offset); break;
+			case '?':  add_token(TokenKind::Quest, offset); break;
+			case '@':  add_token(TokenKind::At, offset); break;
+			case '#':  add_token(TokenKind::Hash, offset); break;
+			case '$':  add_token(TokenKind::Dollar, offset); break;
+			case '+':  add_token(lex_plus(), offset); break;
+			case '-':  add_token(lex_minus(), offset); break;
+			case '*':  add_token(lex_star(), offset); break;
+			case '/':  lex_slash(offset); break;
+			case '%':  add_token(lex_percent(), offset); break;
+			case '&':  add_token(lex_ampersand(), offset); break;
+			case '|':  add_token(lex_pipe(), offset); break;
+			case '~':  add_token(lex_tilde(), offset); break;
+			case '!':  add_token(lex_bang(), offset); break;
+			case ':':  add_token(lex_colon(), offset); break;
+			case '=':  add_token(lex_equal(), offset); break;
+			case '<':  add_token(lex_left_angle(), offset); break;
+			case '>':  lex_right_angle(offset); break;
+			case '.':  lex_dot(offset); break;
+			case '"':  lex_quoted_sequence(TokenKind::StringLiteral, offset, '"'); break;
+			case '\'': lex_quoted_sequence(TokenKind::CharLiteral, offset, '\''); break;
+			default:   lex_unicode_name(character, offset); break;
+		}
+	}
+
+	/// Continues with the chunk's tokens and diagnostics from the given offset, at which the chunk has a token start.
+	void splice(LexedChunk& chunk, SourceOffset offset) {
+		auto tokens = chunk.stream.raw();
+		auto first = std::lower_bound(tokens.begin(), tokens.end(), offset, [](Token token, SourceOffset value) {
+			return token.offset < value;
+		});
+		const auto first_index = static_cast<uint32_t>(first - tokens.begin());
+		const auto base_index = stream_.count_tokens();
+		stream_.add_tokens(tokens.subspan(first_index), chunk.stream.raw_lengths().subspan(first_index));
+
+		auto bracket = std::lower_bound(chunk.bracket_tokens.begin(), chunk.bracket_tokens.end(), first_index);
+		for (; bracket != chunk.bracket_tokens.end(); ++bracket) {
+			match_bracket(tokens[*bracket].kind, *bracket - first_index + base_index);
+		}
+
+		for (auto trivia : chunk.stream.raw_trivia()) {
+			if (trivia.offset >= offset) {
+				trivia.next_token = trivia.next_token - first_index + base_index;
+				stream_.add_trivia(trivia);
+			}
+		}
+
+		for (auto& pending : chunk.reports) {
+			if (pending.offset >= offset) {
+				report(pending.message, pending.offset, std::move(pending.args));
+			}
+		}
+
+		cursor_ = SourceCursor(source_, chunk.stop);
+	}
+
+	/// Continues with the tokens from before an edit, starting at the given index and including the end-of-file token, along
+	/// with the trivia and diagnostics from there on. Their offsets are moved by the change in source length.
+	void splice_shifted(const TokenStream& old_stream, uint32_t first_index, SourceOffset shift) {
+		const auto tokens = old_stream.raw().subspan(first_index);
+		const auto lengths = old_stream.raw_lengths().subspan(first_index);
+		const auto base_index = stream_.count_tokens();
+		for (uint32_t i = 0; i != tokens.size(); ++i) {
+			stream_.add_token(tokens[i].kind, tokens[i].offset + shift, lengths[i]);
+			match_bracket(tokens[i].kind, base_index + i);
+		}
+
+		const SourceOffset old_offset = tokens[0].offset;
+		for (auto trivia : old_stream.raw_trivia()) {
+			if (trivia.offset >= old_offset) {
+				trivia.offset += shift;
+				trivia.next_token = trivia.next_token - first_index + base_index;
+				stream_.add_trivia(trivia);
+			}
+		}
+		for (auto error_offset : old_stream.error_offsets_) {
+			if (error_offset >= old_offset) {
+				stream_.add_error(error_offset + shift);
 			}
 		}
 	}
@@ -109,20 +445,20 @@ private:
 		auto lexeme = source_.get_text().substr(offset, length);
 		auto kind = identify_keyword(lexeme);
 
-		stream_.add_token(kind, offset);
+		add_token(kind, offset);
 	}
 
 	void eat_word_token_rest() {
-		while (auto next = cursor_.peek()) {
-			const char c = *next;
-			if (is_standard_ascii(c)) {
-				if (!is_ascii_word_character(c)) {
-					break;
-				}
-			} else {
-				if (!check_multibyte_utf8_value<is_utf8_xid_continue>(c, cursor_.offset())) {
-					break;
-				}
+		while (true) {
+			cursor_.advance_by(scanner_.count_ascii_word_characters(cursor_.remaining()));
+
+			// the scanner stops at anything that isn't an ASCII word character, so only multibyte UTF-8 can continue the word
+			auto next = cursor_.peek();
+			if (!next || is_standard_ascii(*next)) {
+				break;
+			}
+			if (!check_multibyte_utf8_value<is_utf8_xid_continue>(*next, cursor_.offset())) {
+				break;
 			}
 			cursor_.advance();
 		}
@@ -153,13 +489,13 @@ private:
 	void lex_zero(SourceOffset offset) {
 		if (cursor_.match('x')) {
 			eat_number_literal<is_hex_digit>();
-			stream_.add_token(TokenKind::HexIntLiteral, offset);
+			add_token(TokenKind::HexIntLiteral, offset);
 		} else if (cursor_.match('b')) {
 			eat_number_literal<is_dec_digit>(); // consume any decimal digit for better errors during literal parsing later
-			stream_.add_token(TokenKind::BinIntLiteral, offset);
+			add_token(TokenKind::BinIntLiteral, offset);
 		} else if (cursor_.match('o')) {
 			eat_number_literal<is_dec_digit>(); // consume any decimal digit for better errors during literal parsing later
-			stream_.add_token(TokenKind::OctIntLiteral, offset);
+			add_token(TokenKind::OctIntLiteral, offset);
 		} else {
 			lex_number(offset);
 		}
@@ -183,7 +519,7 @@ private:
 		if (next == '.') {
 			const bool matched_number = eat_decimal_number();
 			if (matched_number) {
-				stream_.add_token(TokenKind::FloatLiteral, offset);
+				add_token(TokenKind::FloatLiteral, offset);
 				return;
 			} else {
 				cursor_ = cursor_at_dot; // reset to dot if there's no fractional part
@@ -192,7 +528,7 @@ private:
 			cursor_ = cursor_at_token_end;
 		}
 
-		stream_.add_token(TokenKind::DecIntLiteral, offset);
+		add_token(TokenKind::DecIntLiteral, offset);
 	}
 
 	template<bool CharPredicate(char)>
@@ -229,16 +565,16 @@ private:
 	void lex_dot(SourceOffset offset) {
 		if (cursor_.match('.')) {
 			if (cursor_.match('.')) {
-				stream_.add_token(TokenKind::Ellipsis, offset);
+				add_token(TokenKind::Ellipsis, offset);
 			} else {
-				stream_.add_token(TokenKind::Dot, offset);
-				stream_.add_token(TokenKind::Dot, offset + 1);
+				stream_.add_token(TokenKind::Dot, offset, 1);
+				stream_.add_token(TokenKind::Dot, offset + 1, 1);
 			}
 		} else if (is_dec_digit(cursor_.peek().value_or('\0'))) {
 			eat_number_literal<is_dec_digit>();
-			stream_.add_token(TokenKind::FloatLiteral, offset);
+			add_token(TokenKind::FloatLiteral, offset);
 		} else {
-			stream_.add_token(TokenKind::Dot, offset);
+			add_token(TokenKind::Dot, offset);
 		}
 	}
 
@@ -267,15 +603,15 @@ private:
 	void lex_right_angle(SourceOffset offset) {
 		if (cursor_.match('>')) {
 			if (cursor_.match('=')) {
-				stream_.add_token(TokenKind::RAngleRAngleEq, offset);
+				add_token(TokenKind::RAngleRAngleEq, offset);
 			} else {
-				stream_.add_token(TokenKind::RAngle, offset);
-				stream_.add_token(TokenKind::RAngle, offset + 1);
+				stream_.add_token(TokenKind::RAngle, offset, 1);
+				stream_.add_token(TokenKind::RAngle, offset + 1, 1);
 			}
 		} else if (cursor_.match('=')) {
-			stream_.add_token(TokenKind::RAngleEq, offset);
+			add_token(TokenKind::RAngleEq, offset);
 		} else {
-			stream_.add_token(TokenKind::RAngle, offset);
+			add_token(TokenKind::RAngle, offset);
 		}
 	}
 
@@ -328,18 +664,14 @@ private:
 	void lex_slash(SourceOffset offset) {
 		if (cursor_.match('/')) {
 			eat_line_comment();
-			if (lex_comments_) {
-				stream_.add_token(TokenKind::LineComment, offset);
-			}
+			add_comment(TokenKind::LineComment, offset);
 		} else if (cursor_.match('*')) {
 			eat_block_comment(offset);
-			if (lex_comments_) {
-				stream_.add_token(TokenKind::BlockComment, offset);
-			}
+			add_comment(TokenKind::BlockComment, offset);
 		} else if (cursor_.match('=')) {
-			stream_.add_token(TokenKind::SlashEq, offset);
+			add_token(TokenKind::SlashEq, offset);
 		} else {
-			stream_.add_token(TokenKind::Slash, offset);
+			add_token(TokenKind::Slash, offset);
 		}
 	}
 
@@ -443,77 +775,239 @@ private:
 			}
 		}
 
-		stream_.add_token(kind, offset);
+		add_token(kind, offset);
 	}
 
 	void lex_unicode_name(char character, SourceOffset offset) {
 		if (check_multibyte_utf8_value<is_utf8_xid_start>(character, offset)) {
 			eat_word_token_rest();
 		}
-		stream_.add_token(TokenKind::Name, offset);
+		add_token(TokenKind::Name, offset);
 	}
 
-	void report(Message message, SourceOffset offset, MessageArgs args) {
-		auto location = source_.locate(offset);
-		reporter_.report(message, location, std::move(args));
-		stream_.has_errors_ = true;
+	void add_comment(TokenKind kind, SourceOffset offset) {
+		switch (comment_mode_) {
+			case CommentMode::Discard: break;
+			case CommentMode::Tokens:  add_token(kind, offset); break;
+			case CommentMode::Trivia:
+				stream_.add_trivia(Trivia {kind, offset, get_lexeme_length(offset), stream_.count_tokens()});
+				break;
+		}
 	}
 
-	static TokenKind identify_keyword(std::string_view lexeme) {
+	/// Appends a token whose lexeme ends at the cursor. Trailing whitespace is excluded from the lexeme, since number literals,
+	/// line comments and unterminated quoted sequences can pick some up.
+	void add_token(TokenKind kind, SourceOffset offset) {
+		stream_.add_token(kind, offset, get_lexeme_length(offset));
+	}
+
+	/// Appends an opening bracket token and pushes it onto the open brackets.
+	void add_opening_bracket(TokenKind kind, SourceOffset offset) {
+		const uint32_t index = num_batched_tokens_ + stream_.count_tokens();
+		stream_.add_token(kind, offset, 1);
+		if (defers_brackets_) [[unlikely]] {
+			bracket_tokens_.emplace_back(index);
+		} else {
+			open_bracket(get_bracket_kind_index(kind), index);
+		}
+	}
+
+	/// Appends a closing bracket token and resolves the open bracket it matches.
+	void add_closing_bracket(TokenKind kind, SourceOffset offset) {
+		const uint32_t index = num_batched_tokens_ + stream_.count_tokens();
+		stream_.add_token(kind, offset, 1);
+		if (defers_brackets_) [[unlikely]] {
+			bracket_tokens_.emplace_back(index);
+		} else {
+			close_bracket(get_bracket_kind_index(kind), index);
+		}
+	}
+
+	/// Opens or closes a bracket if the token at the given index is one.
+	void match_bracket(TokenKind kind, uint32_t token_index) {
+		// the bracket kinds come in pairs of opening and closing kind, so that a single comparison filters out all other tokens
+		const auto bracket = static_cast<uint32_t>(kind) - static_cast<uint32_t>(TokenKind::LBrace);
+		if (bracket >= 6) [[likely]] {
+			return;
+		}
+		if (defers_brackets_) {
+			bracket_tokens_.emplace_back(token_index);
+		} else if (bracket % 2 == 0) {
+			open_bracket(bracket / 2, token_index);
+		} else {
+			close_bracket(bracket / 2, token_index);
+		}
+	}
+
+	/// Index of the kind of bracket, which is 0 for braces, 1 for parentheses and 2 for square brackets.
+	static constexpr uint32_t get_bracket_kind_index(TokenKind kind) {
 		using enum TokenKind;
-		switch (lexeme.length()) { // clang-format off
-			case 2:
-				if (lexeme == "do") return Do;
-				if (lexeme == "if") return If;
-				if (lexeme == "in") return In;
-				break;
+		static_assert(uint8_t(RBrace) == uint8_t(LBrace) + 1 && uint8_t(LParen) == uint8_t(LBrace) + 2);
+		static_assert(uint8_t(RParen) == uint8_t(LBrace) + 3 && uint8_t(LBracket) == uint8_t(LBrace) + 4);
+		static_assert(uint8_t(RBracket) == uint8_t(LBrace) + 5);
 
-			case 3:
-				if (lexeme == "for") return For;
-				if (lexeme == "let") return Let;
-				if (lexeme == "try") return Try;
-				if (lexeme == "var") return Var;
-				break;
+		return (static_cast<uint32_t>(kind) - static_cast<uint32_t>(LBrace)) / 2;
+	}
 
-			case 4:
-				if (lexeme == "else") return Else;
-				if (lexeme == "enum") return Enum;
-				break;
+	void open_bracket(uint32_t kind_index, uint32_t token_index) {
+		open_brackets_.emplace_back(OpenBracket {token_index, kind_index});
+		++num_open_brackets_[kind_index];
+	}
 
-			case 5:
-				if (lexeme == "break") return Break;
-				if (lexeme == "catch") return Catch;
-				if (lexeme == "const") return Const;
-				if (lexeme == "throw") return Throw;
-				if (lexeme == "while") return While;
-				break;
+	/// A closing token matches the innermost open bracket of its kind, and any brackets opened after that one stay unclosed.
+	/// Closing tokens without any match are ignored.
+	void close_bracket(uint32_t kind_index, uint32_t token_index) {
+		if (num_open_brackets_[kind_index] == 0) [[unlikely]] {
+			stream_.has_unbalanced_brackets_ = true;
+			return;
+		}
+		while (open_brackets_.back().kind_index != kind_index) [[unlikely]] {
+			leave_bracket_unclosed();
+		}
+		resolve_bracket(open_brackets_.back().token_index, token_index);
+		--num_open_brackets_[kind_index];
+		open_brackets_.pop_back();
+	}
 
-			case 6:
-				if (lexeme == "public") return Public;
-				if (lexeme == "return") return Return;
-				if (lexeme == "static") return Static;
-				if (lexeme == "struct") return Struct;
-				if (lexeme == "switch") return Switch;
-				break;
+	/// Gives up on the innermost open bracket, which a closing token of another kind went past.
+	void leave_bracket_unclosed() {
+		const auto open = open_brackets_.back();
+		if (resolved_brackets_ != nullptr) {
+			resolved_brackets_->emplace_back(BracketPair {open.token_index, BracketPair::Unclosed});
+		}
+		--num_open_brackets_[open.kind_index];
+		open_brackets_.pop_back();
+		stream_.has_unbalanced_brackets_ = true;
+	}
 
-			case 7:
-				if (lexeme == "private") return Private;
-				break;
+	void resolve_bracket(uint32_t open_index, uint32_t close_index) {
+		if (resolved_brackets_ != nullptr) {
+			resolved_brackets_->emplace_back(BracketPair {open_index, close_index});
+		} else {
+			stream_.set_closing_bracket(open_index, close_index);
+		}
+	}
 
-			case 8:
-				if (lexeme == "continue") return Continue;
-				break;
+	/// Leaves the brackets that are still open unclosed, once all tokens are lexed.
+	void finish_brackets() {
+		while (!open_brackets_.empty()) {
+			leave_bracket_unclosed();
+		}
+	}
 
-			case 9:
-				if (lexeme == "unchecked") return Unchecked;
-				break;
-		} // clang-format on
-		return Name;
+	/// Length of the lexeme from the given offset up to the cursor, excluding trailing whitespace.
+	uint32_t get_lexeme_length(SourceOffset offset) const {
+		const auto text = source_.get_text();
+		auto end = cursor_.offset();
+		while (end != offset && is_whitespace(text[end - 1])) {
+			--end;
+		}
+		return end - offset;
+	}
+
+	void report(Message message, SourceOffset offset, MessageArgs args) {
+		if (holds_reports_) {
+			pending_reports_.emplace_back(PendingReport {message, offset, std::move(args)});
+		} else {
+			auto location = source_.locate(offset);
+			reporter_.report(message, location, std::move(args));
+		}
+		stream_.add_error(offset);
+	}
+
+	static TokenKind identify_keyword(std::string_view lexeme) {
+		const auto [min_length, max_length] = KEYWORD_LENGTHS;
+		if (lexeme.length() < min_length || lexeme.length() > max_length) {
+			return TokenKind::Name;
+		}
+
+		auto& entry = KEYWORD_TABLE[hash_keyword(lexeme, KeywordHashMultiplier)];
+		return entry.lexeme == lexeme ? entry.kind : TokenKind::Name;
 	}
 };
 
-TokenStream lex(const SourceGuard& source, Reporter& reporter, bool lex_comments) {
-	return Lexer(source, reporter, lex_comments).lex();
+TokenStream lex(const SourceGuard& source, Reporter& reporter, CommentMode comment_mode, ScanMode scan_mode) {
+	return Lexer(source, reporter, comment_mode, scan_mode).lex();
+}
+
+TokenStream lex_parallel(const SourceGuard& source,
+						 Reporter& reporter,
+						 CommentMode comment_mode,
+						 ThreadPool& thread_pool,
+						 size_t min_chunk_length,
+						 ScanMode scan_mode) {
+	const size_t length = source.get_length();
+	const size_t max_chunks = length / std::max(min_chunk_length, size_t(1));
+	const size_t num_chunks = std::min(size_t(thread_pool.num_threads()) * ParallelLexChunksPerThread, max_chunks);
+	if (num_chunks < 2 || length > MaxCompactSourceLength || thread_pool.num_threads() < 2) {
+		return lex(source, reporter, comment_mode, scan_mode);
+	}
+
+	// chunks begin at the start of a line, where a token almost always begins as well
+	const auto text = source.get_text();
+	std::vector<SourceOffset> chunk_begins {0};
+	for (size_t i = 1; i != num_chunks; ++i) {
+		const size_t newline = text.find('\n', length / num_chunks * i);
+		if (newline == std::string_view::npos) {
+			break;
+		}
+
+		const auto begin = static_cast<SourceOffset>(newline + 1);
+		if (begin > chunk_begins.back() && begin < length) {
+			chunk_begins.emplace_back(begin);
+		}
+	}
+	chunk_begins.emplace_back(static_cast<SourceOffset>(length));
+
+	const auto num_lexed_chunks = static_cast<uint32_t>(chunk_begins.size() - 1);
+	std::vector<std::optional<LexedChunk>> lexed_chunks(num_lexed_chunks);
+	thread_pool.for_each_index(num_lexed_chunks, [&](uint32_t index) {
+		const auto begin = chunk_begins[index];
+		const auto end = chunk_begins[index + 1];
+		lexed_chunks[index] = Lexer(source, reporter, comment_mode, scan_mode, begin, end - begin).lex_chunk(end);
+	});
+
+	std::vector<LexedChunk> chunks;
+	chunks.reserve(num_lexed_chunks);
+	for (auto& chunk : lexed_chunks) {
+		chunks.emplace_back(std::move(*chunk));
+	}
+	return Lexer(source, reporter, comment_mode, scan_mode).stitch(chunks);
+}
+
+StreamingLexer::StreamingLexer(const SourceGuard& source, Reporter& reporter, ScanMode scan_mode) :
+	lexer_(std::make_unique<Lexer>(source, reporter, CommentMode::Discard, scan_mode, 0, 0)) {
+	check(source.get_length() <= MaxCompactSourceLength, "only sources with compact token offsets can be lexed in batches");
+}
+
+StreamingLexer::~StreamingLexer() = default;
+
+uint32_t StreamingLexer::lex_into(std::span<Token> tokens,
+								  std::span<uint32_t> lengths,
+								  std::vector<BracketPair>& resolved_brackets) {
+	return lexer_->lex_into(tokens, lengths, resolved_brackets);
+}
+
+bool StreamingLexer::has_errors() const {
+	return lexer_->has_errors();
+}
+
+TokenStream relex(const TokenStream& old_stream,
+				  const SourceGuard& source,
+				  SourceEdit edit,
+				  Reporter& reporter,
+				  CommentMode comment_mode,
+				  ScanMode scan_mode) {
+	// reusing tokens requires their offsets to be full source offsets both before and after the edit
+	if (source.get_length() > MaxCompactSourceLength || !old_stream.raw_source_segment_starts().empty()) {
+		return lex(source, reporter, comment_mode, scan_mode);
+	}
+
+	// unless the edit uncovers text that was inside a comment or string before, inserted characters add at most one token each,
+	// so this is usually enough storage without much to shrink later
+	const size_t max_tokens = old_stream.num_tokens() + edit.new_length;
+	const size_t expected_length = max_tokens * TokenStream::EstimatedSourceBytesPerToken;
+	return Lexer(source, reporter, comment_mode, scan_mode, 0, expected_length).relex(old_stream, edit);
 }
 
 } // namespace cero
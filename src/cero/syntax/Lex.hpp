@@ -2,10 +2,100 @@
 
 #include "cero/io/Reporter.hpp"
 #include "cero/io/Source.hpp"
+#include "cero/syntax/Scanner.hpp"
 #include "cero/syntax/TokenStream.hpp"
+#include "cero/util/ThreadPool.hpp"
+
+#include <memory>
+#include <span>
+#include <vector>
 
 namespace cero {
 
-TokenStream lex(const SourceGuard& source, Reporter& reporter, bool lex_comments);
+/// Decides what the lexer does with comments.
+enum class CommentMode : uint8_t {
+	/// Comments are dropped.
+	Discard,
+
+	/// Comments become tokens in the token stream, in between the other tokens.
+	Tokens,
+
+	/// Comments are recorded in the token stream's trivia, apart from the tokens, so that the tokens stay free of comments.
+	Trivia,
+};
+
+/// Lexes the given source into a token stream. The scan mode only influences how fast the source is processed, not the result.
+TokenStream lex(const SourceGuard& source,
+				Reporter& reporter,
+				CommentMode comment_mode,
+				ScanMode scan_mode = get_best_scan_mode());
+
+/// Sources are split into at most this many chunks per thread when lexing in parallel, to even out the work per thread.
+constexpr size_t ParallelLexChunksPerThread = 4;
+
+/// Smallest chunk of source text that is worth handing to another thread during parallel lexing.
+constexpr size_t ParallelLexMinChunkLength = 256 * 1024;
+
+/// Lexes the given source by splitting it into chunks at line beginnings and lexing the chunks concurrently on the thread pool.
+/// The token stream and the diagnostics, including their order, are identical to those of sequential lexing. Stitching the
+/// chunks back together runs on the calling thread, so this is only faster than lex when the pool runs on several cores; see
+/// the LexParallelScaling benchmark. Sources too small to be split into chunks of the minimum length, sources longer than
+/// MaxCompactSourceLength and pools with a single thread lex sequentially on the calling thread.
+TokenStream lex_parallel(const SourceGuard& source,
+						 Reporter& reporter,
+						 CommentMode comment_mode,
+						 ThreadPool& thread_pool,
+						 size_t min_chunk_length = ParallelLexMinChunkLength,
+						 ScanMode scan_mode = get_best_scan_mode());
+
+class Lexer;
+
+/// Lexes a source on demand, a batch of tokens at a time, so that the tokens can be consumed as they are produced without the
+/// whole token stream ever being stored. Comments are discarded. Only sources no longer than MaxCompactSourceLength can be
+/// lexed this way, because the tokens carry no record of which source segment they lie in.
+class StreamingLexer {
+public:
+	StreamingLexer(const SourceGuard& source, Reporter& reporter, ScanMode scan_mode = get_best_scan_mode());
+	~StreamingLexer();
+
+	/// Lexes the next tokens into the given buffers and returns how many were written. As long as the buffers have room for
+	/// at least two tokens, at least one is written, until the end-of-file token has been written, after which none are. Each
+	/// opening bracket is appended to the given pairs by its index among all tokens lexed so far, once the token that closes
+	/// it is lexed or once it is known that none will, which is at the latest when the end-of-file token is written.
+	uint32_t lex_into(std::span<Token> tokens, std::span<uint32_t> lengths, std::vector<BracketPair>& resolved_brackets);
+
+	/// Whether syntax errors were encountered in the tokens lexed so far.
+	bool has_errors() const;
+
+	StreamingLexer(StreamingLexer&&) = delete;
+	StreamingLexer& operator=(StreamingLexer&&) = delete;
+
+private:
+	std::unique_ptr<Lexer> lexer_;
+};
+
+/// Replacement of a range of source text, such as an editor makes when text is typed, deleted or pasted.
+struct SourceEdit {
+	/// Offset at which the replaced range begins, which is the same before and after the edit.
+	SourceOffset offset = 0;
+
+	/// Length of the replaced range before the edit.
+	uint32_t old_length = 0;
+
+	/// Length of the text that replaced the range.
+	uint32_t new_length = 0;
+};
+
+/// Updates the token stream of a source after an edit, given the stream lexed from the text before the edit with the same
+/// comment mode. Only the tokens around the edit are lexed again: lexing starts shortly before the edit and stops as soon as a
+/// token starts at the same place as one did before the edit, after which the old tokens are reused with shifted offsets. The
+/// result is identical to lexing the edited source from scratch, but diagnostics are only reported for the relexed range.
+/// Sources longer than MaxCompactSourceLength before or after the edit are lexed from scratch instead.
+TokenStream relex(const TokenStream& old_stream,
+				  const SourceGuard& source,
+				  SourceEdit edit,
+				  Reporter& reporter,
+				  CommentMode comment_mode,
+				  ScanMode scan_mode = get_best_scan_mode());
 
-}
+} // namespace cero
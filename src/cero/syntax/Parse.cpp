@@ -2,11 +2,14 @@
 
 #include "cero/syntax/Lex.hpp"
 #include "cero/syntax/Literal.hpp"
+#include "cero/syntax/StreamingTokenCursor.hpp"
 #include "cero/syntax/TokenCursor.hpp"
 #include "cero/util/Algorithm.hpp"
 #include "cero/util/Fail.hpp"
 #include "cero/util/ScopedAssign.hpp"
 
+#include <unordered_map>
+
 namespace cero {
 
 enum class Precedence : uint8_t {
@@ -20,8 +23,6 @@ enum class Precedence : uint8_t {
 	Postfix
 };
 
-struct ParseError {};
-
 consteval Precedence lookup_precedence_for_associativity(BinaryOperator op) {
 	using enum BinaryOperator;
 	switch (op) {
@@ -61,13 +62,51 @@ consteval Precedence lookup_precedence_for_associativity(BinaryOperator op) {
 	}
 }
 
+/// Diagnostic from a chunk parsed in parallel, held back until the chunks are stitched together in source order.
+struct PendingParseReport {
+	Message message;
+	CodeLocation location;
+	MessageArgs args;
+};
+
+/// How far a parser working on a chunk had come when it began parsing a top-level definition.
+struct DefinitionStart {
+	uint32_t token_index = 0;
+	uint32_t num_nodes = 0;
+	uint32_t num_reports = 0;
+	uint16_t num_definitions = 0;
+};
+
+/// Nodes and held back diagnostics from parsing the top-level definitions in one chunk of a token stream, under the assumption
+/// that the chunk begins where a definition begins.
+struct ParsedChunk {
+	Ast ast;
+	std::vector<PendingParseReport> reports;
+	std::vector<DefinitionStart> definition_starts;
+	uint32_t begin = 0; // index of the first token of the chunk
+
+	// how far the results reach, which is where parsing stopped, at or after the end of the chunk, unless a definition with a
+	// construct that cannot be parsed yet cut it short, in which case they end at that definition
+	DefinitionStart end;
+};
+
+/// Tokens at the start and at the end of a token stream that an edit left unchanged, compared to the stream before the edit.
+struct UnchangedTokens {
+	uint32_t num_leading = 0;
+	uint32_t first_trailing = 0;  // index of the first trailing token in the stream before the edit
+	uint32_t index_shift = 0;	  // how much the indices of trailing tokens changed, wrapping around if they decreased
+	SourceOffset offset_shift = 0; // how much the offsets of trailing tokens changed, wrapping around if they decreased
+};
+
+/// Parses tokens from either a token stream or a token window, depending on the cursor type.
+template<typename Cursor>
 class Parser {
 public:
-	Parser(const TokenStream& token_stream, const SourceGuard& source, Reporter& reporter) :
+	Parser(Cursor cursor, size_t num_tokens, const SourceGuard& source, Reporter& reporter) :
 		source_(source),
 		reporter_(reporter),
-		cursor_(token_stream),
-		ast_(token_stream) {
+		cursor_(std::move(cursor)),
+		ast_(source.get_text(), num_tokens) {
 	}
 
 	Ast parse() && {
@@ -75,29 +114,281 @@ public:
 
 		uint16_t num_definitions = 0;
 		while (!cursor_.match(TokenKind::EndOfFile)) {
-			try {
-				parse_definition();
+			if (parse_definition_or_recover()) {
+				++num_definitions;
+			}
+			ast_.reserve_by_progress(cursor_.peek_offset());
+		}
+
+		auto root = ast_.as<AstRoot>(ast_.get(root_idx));
+		root.num_definitions = num_definitions;
+		ast_.replace(root_idx, root);
+
+		ast_.finish_pre_order();
+		return std::move(ast_);
+	}
+
+	/// Parses like parse does while the tokens are still being lexed, but holds back the diagnostics until the lexer has seen
+	/// the whole source, so that they are reported after those of the lexer, as they are when lexing comes first.
+	Ast parse_while_lexing() && {
+		holds_reports_ = true;
+		auto ast = std::move(*this).parse();
+		for (auto& pending : pending_reports_) {
+			reporter_.report(pending.message, pending.location, std::move(pending.args));
+		}
+		return ast;
+	}
+
+	/// Parses the top-level definitions without the bodies of functions, which are only matched up by their braces.
+	Ast parse_signatures() && {
+		skips_function_bodies_ = true;
+		return std::move(*this).parse();
+	}
+
+	/// Parses the skipped body of the given function definition from an AST of signatures into an AST whose root is a block
+	/// statement holding the statements of the body.
+	static std::optional<Ast> parse_skipped_body(const Ast& signatures,
+												 const AstFunctionDefinition& definition,
+												 const TokenStream& token_stream,
+												 const SourceGuard& source,
+												 Reporter& reporter) {
+		auto body = signatures.find_skipped_body(definition);
+		if (body == nullptr) {
+			return std::nullopt;
+		}
+
+		Parser parser(TokenCursor(token_stream, body->begin), body->end - body->begin, source, reporter);
+		parser.on_left_brace();
+		parser.ast_.finish_pre_order();
+		return std::move(parser.ast_);
+	}
+
+	/// Parses the token stream of a source after an edit, reusing every step of parsing the top-level definitions of the AST
+	/// from before the edit that only inspected unchanged tokens. Parsing picks up after the reused steps before the edit,
+	/// and stops once it reaches a token behind the edit where a step began before, since the steps from there on are the same.
+	Ast reparse(const TokenStream& token_stream, const Ast& old_ast, const UnchangedTokens& unchanged) && {
+		const auto old_spans = std::span(old_ast.definition_spans_);
+		if (old_spans.empty() || !old_ast.skipped_bodies_.empty()) {
+			return std::move(*this).parse();
+		}
+
+		auto root_idx = ast_.store(AstRoot {});
+		uint16_t num_definitions = 0;
+
+		auto reuse = [&](std::span<const Ast::DefinitionSpan> spans, uint32_t index_shift, SourceOffset offset_shift) {
+			if (spans.empty()) {
+				return;
+			}
+
+			const auto first_node = spans.front().first_node;
+			const auto end_node = spans.end() == old_spans.end() ? old_ast.num_nodes() : spans.end()->first_node;
+			const auto node_shift = ast_.num_nodes() - first_node;
+			for (auto span : spans) {
+				span.first_token += index_shift;
+				span.end_token += index_shift;
+				span.first_node += node_shift;
+				ast_.definition_spans_.emplace_back(span);
+				num_definitions = static_cast<uint16_t>(num_definitions + span.is_definition);
+				ast_.has_errors_ |= span.has_errors;
+			}
+
+			const auto nodes = old_ast.raw().subspan(first_node, end_node - first_node);
+			ast_.store_copies(old_ast, nodes, offset_shift);
+		};
+
+		auto next_span = old_spans.begin();
+		while (next_span->end_token <= unchanged.num_leading) {
+			++next_span; // the last step inspects the end-of-file token, which is never a leading token
+		}
+		reuse({old_spans.begin(), next_span}, 0, 0);
+		cursor_ = TokenCursor(token_stream, next_span->first_token);
+
+		const auto first_trailing = unchanged.first_trailing + unchanged.index_shift;
+		while (!cursor_.match(TokenKind::EndOfFile)) {
+			const auto token_index = cursor_.get_token_index();
+			if (token_index >= first_trailing) {
+				const auto old_index = token_index - unchanged.index_shift;
+				while (next_span != old_spans.end() && next_span->first_token < old_index) {
+					++next_span;
+				}
+				if (next_span != old_spans.end() && next_span->first_token == old_index) {
+					reuse({next_span, old_spans.end()}, unchanged.index_shift, unchanged.offset_shift);
+					break;
+				}
+			}
+
+			if (parse_definition_or_recover()) {
 				++num_definitions;
-			} catch (ParseError) {
-				recover_at_definition_scope();
 			}
 		}
 
-		auto& root = ast_.get(root_idx).as<AstRoot>();
+		auto root = ast_.as<AstRoot>(ast_.get(root_idx));
 		root.num_definitions = num_definitions;
+		ast_.replace(root_idx, root);
 
+		ast_.finish_pre_order();
+		return std::move(ast_);
+	}
+
+	/// Parses the top-level definitions from the current token up to the first one that begins at or after the given token
+	/// index. Diagnostics are held back instead of reported, because the current token might not actually begin a definition.
+	ParsedChunk parse_chunk(uint32_t end) && {
+		holds_reports_ = true;
+
+		is_parsing_chunk_ = true;
+
+		const auto begin = cursor_.get_token_index();
+		std::vector<DefinitionStart> starts;
+		uint16_t num_definitions = 0;
+		while (cursor_.get_token_index() < end && cursor_.peek_kind() != TokenKind::EndOfFile) {
+			const auto num_reports = static_cast<uint32_t>(pending_reports_.size());
+			starts.emplace_back(DefinitionStart {cursor_.get_token_index(), ast_.num_nodes(), num_reports, num_definitions});
+
+			if (parse_definition_or_recover()) {
+				++num_definitions;
+			}
+
+			// the sequential parsing in stitch takes over from the definition that was cut short
+			if (is_chunk_cut_short_) {
+				ast_.finish_pre_order();
+				const auto cut_start = starts.back();
+				starts.pop_back();
+				ast_.definition_spans_.pop_back();
+				return ParsedChunk {std::move(ast_), std::move(pending_reports_), std::move(starts), begin, cut_start};
+			}
+		}
+
+		ast_.finish_pre_order();
+		const DefinitionStart stop {cursor_.get_token_index(), ast_.num_nodes(), static_cast<uint32_t>(pending_reports_.size()),
+									num_definitions};
+		return ParsedChunk {std::move(ast_), std::move(pending_reports_), std::move(starts), begin, stop};
+	}
+
+	/// Combines chunks parsed in parallel into a single AST, reporting their diagnostics in source order. Since the parser
+	/// carries no state from one top-level definition to the next, a chunk's results are correct from the first definition it
+	/// begins at the same token as the sequential parsing of the token stream does. Wherever the two disagree, for example
+	/// because recovering from a syntax error skipped past the end of a chunk, definitions are parsed here until they agree.
+	Ast stitch(const TokenStream& token_stream, std::span<ParsedChunk> chunks) && {
+		auto root_idx = ast_.store(AstRoot {});
+
+		uint16_t num_definitions = 0;
+		size_t chunk_index = 0;
+		while (!cursor_.match(TokenKind::EndOfFile)) {
+			const auto token_index = cursor_.get_token_index();
+			while (chunk_index + 1 != chunks.size() && chunks[chunk_index + 1].begin <= token_index) {
+				++chunk_index;
+			}
+
+			auto& chunk = chunks[chunk_index];
+			auto start = std::ranges::lower_bound(chunk.definition_starts, token_index, {}, &DefinitionStart::token_index);
+			if (start != chunk.definition_starts.end() && start->token_index == token_index) {
+				splice(chunk, static_cast<size_t>(start - chunk.definition_starts.begin()));
+				num_definitions = static_cast<uint16_t>(num_definitions + chunk.end.num_definitions - start->num_definitions);
+				cursor_ = TokenCursor(token_stream, chunk.end.token_index);
+			} else if (parse_definition_or_recover()) {
+				++num_definitions;
+			}
+		}
+
+		auto root = ast_.as<AstRoot>(ast_.get(root_idx));
+		root.num_definitions = num_definitions;
+		ast_.replace(root_idx, root);
+
+		ast_.finish_pre_order();
 		return std::move(ast_);
 	}
 
 private:
 	const SourceGuard& source_;
 	Reporter& reporter_;
-	TokenCursor cursor_;
+	Cursor cursor_;
 	Ast ast_;
 	bool is_looking_ahead_ = false;
 	bool is_binding_allowed_ = true;
 	uint32_t open_angles_ = 0;
 
+	/// Set when a syntax error aborts the current definition or statement. While it is set, every parse method returns right
+	/// away without consuming tokens, storing nodes or reporting, until the loop over definitions or statements recovers and
+	/// resets it. Failing this way instead of by throwing keeps error-dense input from spending its parse time on unwinding.
+	bool has_failed_ = false;
+
+	bool skips_function_bodies_ = false;
+	bool holds_reports_ = false;
+
+	/// Set while parsing a chunk in parallel, which might not begin where a definition begins. Constructs that cannot be
+	/// parsed yet then cut the chunk short instead of terminating the compiler, since the sequential parser might never get
+	/// to them.
+	bool is_parsing_chunk_ = false;
+	bool is_chunk_cut_short_ = false;
+	std::vector<PendingParseReport> pending_reports_;
+	uint32_t num_reports_ = 0;
+	uint32_t lookahead_end_ = 0; // index of the furthest token that a lookahead moved the cursor to
+
+	/// How parsing the tokens after a left angle bracket as generic arguments went.
+	struct GenericLookahead {
+		uint16_t num_args = 0;
+		bool is_closed = false;						// whether the arguments are followed by a right angle bracket
+		TokenKind next_kind = TokenKind::EndOfFile; // kind of the token after the right angle bracket
+	};
+
+	/// Lookaheads for generic arguments by the offset of their left angle bracket. When an enclosing lookahead gets discarded
+	/// and its tokens are parsed again, the brackets nested in it are decided from these instead of being looked ahead from
+	/// again, whether their lookahead found generic arguments or not. Cleared for every top-level definition.
+	std::unordered_map<SourceOffset, GenericLookahead> generic_lookaheads_;
+
+	/// Diagnostics from lookaheads, which are reported if the lookahead is kept and discarded along with it otherwise.
+	std::vector<PendingParseReport> held_lookahead_reports_;
+
+	/// Parses the definition at the current token, or recovers from a syntax error in it. Returns whether it was parsed. When
+	/// parsing from a token stream, the tokens and nodes of this step are recorded for reparsing.
+	bool parse_definition_or_recover() {
+		if constexpr (std::is_same_v<Cursor, TokenCursor>) {
+			Ast::DefinitionSpan span {cursor_.get_token_index(), 0, ast_.num_nodes()};
+			const auto num_reports = num_reports_;
+			span.is_definition = parse_definition_step();
+
+			// every step peeks at the token after its last one, and a lookahead might peek one token further than it moves
+			span.end_token = std::max(cursor_.get_token_index(), lookahead_end_) + 1;
+			span.has_errors = num_reports_ != num_reports;
+			ast_.definition_spans_.emplace_back(span);
+			return span.is_definition;
+		} else {
+			return parse_definition_step();
+		}
+	}
+
+	bool parse_definition_step() {
+		if (!generic_lookaheads_.empty()) {
+			generic_lookaheads_.clear();
+		}
+
+		parse_definition();
+		if (has_failed_) [[unlikely]] {
+			has_failed_ = false;
+			recover_at_definition_scope();
+			return false;
+		}
+		return true;
+	}
+
+	/// Appends the nodes and reports the diagnostics of the definitions in the chunk from the one with the given index onward.
+	void splice(ParsedChunk& chunk, size_t start_index) {
+		const auto& start = chunk.definition_starts[start_index];
+		const auto node_shift = ast_.num_nodes() - start.num_nodes;
+		for (auto span : std::span(chunk.ast.definition_spans_).subspan(start_index)) {
+			span.first_node += node_shift;
+			ast_.definition_spans_.emplace_back(span);
+		}
+
+		const auto nodes = std::span(chunk.ast.nodes_).subspan(start.num_nodes, chunk.end.num_nodes - start.num_nodes);
+		ast_.store_copies(chunk.ast, nodes, 0);
+		ast_.num_generic_lookaheads_ += chunk.ast.num_generic_lookaheads_;
+		for (auto& report : std::span(chunk.reports).subspan(start.num_reports, chunk.end.num_reports - start.num_reports)) {
+			reporter_.report(report.message, report.location, std::move(report.args));
+			ast_.has_errors_ = true;
+		}
+	}
+
 	void parse_definition() {
 		auto offset = cursor_.peek_offset();
 
@@ -117,54 +408,94 @@ private:
 			parse_enum(offset, access_specifier);
 		} else {
 			report_expectation(Message::ExpectFuncStructEnum);
-			throw ParseError();
+			has_failed_ = true;
 		}
 	}
 
+	/// Skips to the next token that can begin a definition. Bracketed tokens are jumped over, since a definition cannot begin
+	/// inside of brackets.
 	void recover_at_definition_scope() {
 		static constexpr TokenKind recovery_tokens[] {TokenKind::Public, TokenKind::Private, TokenKind::Struct, TokenKind::Enum,
 													  TokenKind::EndOfFile};
 
 		TokenKind kind;
 		do {
-			cursor_.advance();
+			if (!cursor_.skip_bracketed()) {
+				cursor_.advance();
+			}
 			kind = cursor_.peek_kind();
 		} while (!contains(recovery_tokens, kind));
 	}
 
 	void parse_struct(SourceOffset offset, AccessSpecifier access_specifier) {
 		auto name = expect_name(Message::ExpectNameForStruct);
-		auto node_idx = ast_.store(AstStructDefinition {offset, access_specifier, name});
-
-		auto& struct_def = ast_.get(node_idx).as<AstStructDefinition>();
-		std::ignore = struct_def;
-		to_do();
+		ast_.store(AstStructDefinition {offset, access_specifier, name});
+		cut_chunk_short_or_to_do();
 	}
 
 	void parse_enum(SourceOffset offset, AccessSpecifier access_specifier) {
 		auto name = expect_name(Message::ExpectNameForEnum);
-		auto node_idx = ast_.store(AstEnumDefinition {offset, access_specifier, name});
+		ast_.store(AstEnumDefinition {offset, access_specifier, name});
+		cut_chunk_short_or_to_do();
+	}
 
-		auto& enum_def = ast_.get(node_idx).as<AstEnumDefinition>();
-		std::ignore = enum_def;
-		to_do();
+	/// Stands in for parsing a construct that cannot be parsed yet.
+	void cut_chunk_short_or_to_do() {
+		if (!is_parsing_chunk_) {
+			to_do();
+		}
+		is_chunk_cut_short_ = true;
+		has_failed_ = true;
 	}
 
 	void parse_function(SourceOffset offset, AccessSpecifier access_specifier, StringId name) {
 		auto node_idx = ast_.store(AstFunctionDefinition {offset, access_specifier, name});
 
-		expect(TokenKind::LParen, Message::ExpectParenAfterFuncName);
+		if (!expect(TokenKind::LParen, Message::ExpectParenAfterFuncName)) [[unlikely]] {
+			return;
+		}
 
 		auto num_parameters = parse_function_definition_parameters();
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 		auto num_outputs = parse_function_definition_outputs();
-		expect(TokenKind::LBrace, Message::ExpectBraceBeforeFuncBody);
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 
-		auto num_statements = parse_block();
+		// skipping bodies relies on the bracket pairs and token indices of a token stream
+		bool is_body_skipped = false;
+		if constexpr (std::is_same_v<Cursor, TokenCursor>) {
+			is_body_skipped = skips_function_bodies_ && skip_function_body(offset);
+		}
 
-		auto& func_def = ast_.get(node_idx).as<AstFunctionDefinition>();
+		uint32_t num_statements = 0;
+		if (!is_body_skipped) {
+			if (!expect(TokenKind::LBrace, Message::ExpectBraceBeforeFuncBody)) [[unlikely]] {
+				return;
+			}
+			num_statements = parse_block();
+		}
+
+		auto func_def = ast_.as<AstFunctionDefinition>(ast_.get(node_idx));
 		func_def.num_parameters = num_parameters;
 		func_def.num_outputs = num_outputs;
 		func_def.num_statements = num_statements;
+		ast_.replace(node_idx, func_def);
+	}
+
+	/// Skips over the function body that begins with the current token by jumping to its matching closing brace, and records
+	/// its tokens so that it can be parsed later. Returns whether the body was skipped, which it is not if it has no closing
+	/// brace, so that it is then parsed right away and reports its syntax errors just like when parsing everything.
+	bool skip_function_body(SourceOffset definition_offset) {
+		const auto begin = cursor_.get_token_index();
+		if (cursor_.peek_kind() != TokenKind::LBrace || !cursor_.skip_bracketed()) {
+			return false;
+		}
+
+		ast_.skipped_bodies_.emplace_back(Ast::SkippedBody {definition_offset, begin, cursor_.get_token_index()});
+		return true;
 	}
 
 	uint16_t parse_function_definition_parameters() {
@@ -172,6 +503,9 @@ private:
 		if (!cursor_.match(TokenKind::RParen)) {
 			do {
 				parse_function_definition_parameter();
+				if (has_failed_) [[unlikely]] {
+					return num_parameters;
+				}
 				++num_parameters;
 			} while (cursor_.match(TokenKind::Comma));
 			expect(TokenKind::RParen, Message::ExpectParenAfterParams);
@@ -192,20 +526,27 @@ private:
 		auto node_idx = ast_.store(AstFunctionParameter {offset, specifier});
 
 		parse_type();
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 		auto name = expect_name(Message::ExpectParamName);
 
 		bool has_default_argument = cursor_.match(TokenKind::Eq);
 		if (has_default_argument) {
 			parse_subexpression();
+			if (has_failed_) [[unlikely]] {
+				return;
+			}
 		}
 
-		auto& parameter = ast_.get(node_idx).as<AstFunctionParameter>();
+		auto parameter = ast_.as<AstFunctionParameter>(ast_.get(node_idx));
 		parameter.name = name;
 		parameter.has_default_argument = has_default_argument;
+		ast_.replace(node_idx, parameter);
 
 		// abort parsing here and start next definition so we don't accumulate errors in a malformed signature
 		if (name.empty()) {
-			throw ParseError();
+			has_failed_ = true;
 		}
 	}
 
@@ -214,6 +555,9 @@ private:
 		if (cursor_.match(TokenKind::ThinArrow)) {
 			do {
 				parse_function_definition_output();
+				if (has_failed_) [[unlikely]] {
+					return num_outputs;
+				}
 				++num_outputs;
 			} while (cursor_.match(TokenKind::Comma));
 		}
@@ -225,10 +569,14 @@ private:
 		auto node_idx = ast_.store(AstFunctionOutput {offset});
 
 		parse_type();
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 		auto name = cursor_.match_name(source_);
 
-		auto& output = ast_.get(node_idx).as<AstFunctionOutput>();
+		auto output = ast_.as<AstFunctionOutput>(ast_.get(node_idx));
 		output.name = name;
+		ast_.replace(node_idx, output);
 	}
 
 	uint32_t parse_block() {
@@ -237,19 +585,23 @@ private:
 
 		uint32_t num_statements = 0;
 		while (!cursor_.match(TokenKind::RBrace)) {
-			try {
-				parse_statement();
-				++num_statements;
-			} catch (ParseError) {
+			parse_statement();
+			if (has_failed_) [[unlikely]] {
+				has_failed_ = false;
 				bool at_end = recover_at_statement_scope();
 				if (at_end) {
 					break;
 				}
+			} else {
+				++num_statements;
 			}
 		}
 		return num_statements;
 	}
 
+	/// Skips past the next semicolon or up to the next closing brace, whichever comes first, and returns whether the end of the
+	/// file was reached instead. Bracketed tokens are jumped over, so that the semicolons and braces inside of them, such as
+	/// those of a nested block, do not end the statement.
 	bool recover_at_statement_scope() {
 		TokenKind kind = cursor_.peek_kind();
 		while (kind != TokenKind::EndOfFile) {
@@ -261,7 +613,9 @@ private:
 				return false;
 			}
 
-			cursor_.advance();
+			if (!cursor_.skip_bracketed()) {
+				cursor_.advance();
+			}
 			kind = cursor_.peek_kind();
 		}
 		return true;
@@ -272,12 +626,18 @@ private:
 
 		auto offset = cursor_.peek_offset();
 		auto prev_expr = (this->*parse_method)();
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 
 		if (!parses_full_stmt) {
 			auto name_offset = cursor_.peek_offset();
 			auto name = cursor_.match_name(source_);
 			if (!name.empty()) {
 				on_trailing_name(offset, prev_expr, name, name_offset);
+				if (has_failed_) [[unlikely]] {
+					return;
+				}
 			}
 			expect(TokenKind::Semicolon, Message::ExpectSemicolon);
 		}
@@ -324,7 +684,8 @@ private:
 		if (!contains(type_expr_kinds, kind)) {
 			auto location = source_.locate(name_offset);
 			report(Message::NameCannotAppearHere, location, {});
-			throw ParseError();
+			has_failed_ = true;
+			return;
 		}
 
 		auto node_idx = ast_.store_parent_of(prev_expr, AstBindingStatement {offset, BindingSpecifier::Let, true, name});
@@ -332,10 +693,14 @@ private:
 		bool has_initializer = cursor_.match(TokenKind::Eq);
 		if (has_initializer) {
 			parse_subexpression();
+			if (has_failed_) [[unlikely]] {
+				return;
+			}
 		}
 
-		auto& binding_stmt = ast_.get(node_idx).as<AstBindingStatement>();
+		auto binding_stmt = ast_.as<AstBindingStatement>(ast_.get(node_idx));
 		binding_stmt.has_initializer = has_initializer;
+		ast_.replace(node_idx, binding_stmt);
 	}
 
 	Ast::NodeIndex parse_expression_or_binding() {
@@ -354,12 +719,19 @@ private:
 		auto head_parse_method = lookup_head_parse_method(next.kind);
 		if (head_parse_method == nullptr) {
 			report_expectation(Message::ExpectExpr);
-			throw ParseError();
+			has_failed_ = true;
+			return {};
 		}
 
 		auto expression = (this->*head_parse_method)();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 		while (auto parse_method = get_next_tail_parse_method(precedence)) {
 			(this->*parse_method)(expression, next.offset);
+			if (has_failed_) [[unlikely]] {
+				return {};
+			}
 		}
 
 		return expression;
@@ -467,18 +839,23 @@ private:
 		auto node_idx = ast_.store(AstIfExpr {token.offset});
 
 		parse_expression_or_binding();
-		expect(TokenKind::LBrace, Message::ExpectBlockAfterIfCond);
+		if (has_failed_ || !expect(TokenKind::LBrace, Message::ExpectBlockAfterIfCond)) [[unlikely]] {
+			return {};
+		}
 		const auto num_then_stmts = parse_block();
 
 		uint32_t num_else_stmts = 0;
 		if (cursor_.match(TokenKind::Else)) {
-			expect(TokenKind::LBrace, Message::ExpectBlockAfterElse);
+			if (!expect(TokenKind::LBrace, Message::ExpectBlockAfterElse)) [[unlikely]] {
+				return {};
+			}
 			num_else_stmts = parse_block();
 		}
 
-		auto& if_expr = ast_.get(node_idx).as<AstIfExpr>();
+		auto if_expr = ast_.as<AstIfExpr>(ast_.get(node_idx));
 		if_expr.num_then_statements = num_then_stmts;
 		if_expr.num_else_statements = num_else_stmts;
+		ast_.replace(node_idx, if_expr);
 
 		return node_idx;
 	}
@@ -488,6 +865,9 @@ private:
 		auto node_idx = ast_.store(AstIfExpr {token.offset, 1, 1});
 
 		parse_expression_or_binding();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 
 		if (auto colon = cursor_.match_token(TokenKind::Colon)) {
 			if (cursor_.peek_kind() == TokenKind::LBrace) {
@@ -499,8 +879,9 @@ private:
 			}
 		}
 		parse_subexpression();
-
-		expect(TokenKind::Else, Message::ExpectElse);
+		if (has_failed_ || !expect(TokenKind::Else, Message::ExpectElse)) [[unlikely]] {
+			return {};
+		}
 		parse_subexpression();
 
 		return node_idx;
@@ -511,11 +892,14 @@ private:
 		auto node_idx = ast_.store(AstWhileLoop {token.offset});
 
 		parse_expression_or_binding();
-		expect(TokenKind::LBrace, Message::ExpectBlockAfterWhileCond);
+		if (has_failed_ || !expect(TokenKind::LBrace, Message::ExpectBlockAfterWhileCond)) [[unlikely]] {
+			return {};
+		}
 		auto num_statements = parse_block();
 
-		auto& while_loop = ast_.get(node_idx).as<AstWhileLoop>();
+		auto while_loop = ast_.as<AstWhileLoop>(ast_.get(node_idx));
 		while_loop.num_statements = num_statements;
+		ast_.replace(node_idx, while_loop);
 
 		return node_idx;
 	}
@@ -523,7 +907,8 @@ private:
 	Ast::NodeIndex on_for() {
 		cursor_.advance();
 
-		to_do();
+		cut_chunk_short_or_to_do();
+		return {};
 	}
 
 	Ast::NodeIndex on_left_brace() {
@@ -532,8 +917,9 @@ private:
 
 		auto num_statements = parse_block();
 
-		auto& block = ast_.get(node_idx).as<AstBlockStatement>();
+		auto block = ast_.as<AstBlockStatement>(ast_.get(node_idx));
 		block.num_statements = num_statements;
+		ast_.replace(node_idx, block);
 
 		return node_idx;
 	}
@@ -546,10 +932,14 @@ private:
 		bool has_initializer = cursor_.match(TokenKind::Eq);
 		if (has_initializer) {
 			parse_subexpression();
+			if (has_failed_) [[unlikely]] {
+				return {};
+			}
 		}
 
-		auto& let_stmt = ast_.get(node_idx).as<AstBindingStatement>();
+		auto let_stmt = ast_.as<AstBindingStatement>(ast_.get(node_idx));
 		let_stmt.has_initializer = has_initializer;
+		ast_.replace(node_idx, let_stmt);
 
 		return node_idx;
 	}
@@ -589,24 +979,34 @@ private:
 			cursor_ = lookahead;
 
 			parse_subexpression();
+			if (has_failed_) [[unlikely]] {
+				return {};
+			}
 
 			has_type = false;
 			has_initializer = true;
 		} else {
 			parse_type();
+			if (has_failed_) [[unlikely]] {
+				return {};
+			}
 			name = expect_name(Message::ExpectNameAfterDeclarationType);
 
 			has_type = true;
 			has_initializer = cursor_.match(TokenKind::Eq);
 			if (has_initializer) {
 				parse_subexpression();
+				if (has_failed_) [[unlikely]] {
+					return {};
+				}
 			}
 		}
 
-		auto& binding = ast_.get(node_idx).as<AstBindingStatement>();
+		auto binding = ast_.as<AstBindingStatement>(ast_.get(node_idx));
 		binding.has_type = has_type;
 		binding.has_initializer = has_initializer;
 		binding.name = name;
+		ast_.replace(node_idx, binding);
 
 		return node_idx;
 	}
@@ -629,15 +1029,45 @@ private:
 		ScopedAssign _(open_angles_, open_angles_ + 1);
 
 		auto before_lookahead = cursor_;
-		cursor_.advance(); // consume left angle bracket
+		const auto angle_offset = cursor_.next().offset; // consume left angle bracket
 
 		bool is_generic = true;
 		if (!cursor_.match(TokenKind::RAngle)) {
-			const auto lookahead_idx = ast_.next_index();
-			is_generic = lookahead_whether_is_generic();
+			auto known = generic_lookaheads_.find(angle_offset);
+			if (known == generic_lookaheads_.end()) {
+				++ast_.num_generic_lookaheads_;
+				const auto checkpoint = ast_.save_checkpoint();
+				const auto num_held_reports = held_lookahead_reports_.size();
+				const auto lookahead = lookahead_generic_arguments();
+				if (has_failed_) [[unlikely]] {
+					held_lookahead_reports_.resize(num_held_reports);
+					return {};
+				}
+				generic_lookaheads_.emplace(angle_offset, lookahead);
+
+				if (is_generic_after(lookahead)) {
+					// the lookahead parsed the arguments just like parsing them for real would, so its nodes are kept
+					report_held_lookahead_reports(num_held_reports);
+					auto node_idx = ast_.store_parent_of(checkpoint.num_nodes, AstGenericNameExpr {offset, name});
 
+					auto generic_name_expr = ast_.as<AstGenericNameExpr>(ast_.get(node_idx));
+					generic_name_expr.num_generic_args = lookahead.num_args;
+					ast_.replace(node_idx, generic_name_expr);
+
+					return node_idx;
+				}
+
+				if constexpr (std::is_same_v<Cursor, TokenCursor>) {
+					lookahead_end_ = std::max(lookahead_end_, cursor_.get_token_index());
+				}
+				ast_.undo_nodes_from_lookahead(checkpoint);
+				held_lookahead_reports_.resize(num_held_reports);
+				is_generic = false;
+			} else {
+				// an enclosing lookahead that got discarded already looked ahead from this bracket
+				is_generic = is_generic_after(known->second);
+			}
 			cursor_ = before_lookahead;
-			ast_.undo_nodes_from_lookahead(lookahead_idx);
 		}
 
 		if (is_generic) {
@@ -648,13 +1078,17 @@ private:
 			uint16_t num_generic_args = 0;
 			do {
 				parse_subexpression();
+				if (has_failed_) [[unlikely]] {
+					return {};
+				}
 				++num_generic_args;
 			} while (cursor_.match(TokenKind::Comma));
 
 			cursor_.advance(); // consume right angle bracket
 
-			auto& generic_name_expr = ast_.get(node_idx).as<AstGenericNameExpr>();
+			auto generic_name_expr = ast_.as<AstGenericNameExpr>(ast_.get(node_idx));
 			generic_name_expr.num_generic_args = num_generic_args;
+			ast_.replace(node_idx, generic_name_expr);
 
 			return node_idx;
 		} else {
@@ -662,32 +1096,46 @@ private:
 		}
 	}
 
-	bool lookahead_whether_is_generic() {
+	/// Parses the tokens after a left angle bracket as generic arguments, without reporting diagnostics, since the bracket
+	/// might turn out to be a less-than operator. How this goes only depends on the tokens, since the arguments are parsed
+	/// as subexpressions in which angle brackets are always open, and not on the context that the bracket appears in.
+	GenericLookahead lookahead_generic_arguments() {
 		ScopedAssign _(is_looking_ahead_, true);
 
+		GenericLookahead lookahead;
 		do {
 			parse_subexpression();
+			if (has_failed_) [[unlikely]] {
+				return lookahead;
+			}
+			++lookahead.num_args;
 		} while (cursor_.match(TokenKind::Comma));
 
-		if (cursor_.match(TokenKind::RAngle)) {
-			static constexpr TokenKind ForbiddenAfterGeneric[] {TokenKind::DecIntLiteral, TokenKind::HexIntLiteral,
-																TokenKind::BinIntLiteral, TokenKind::OctIntLiteral,
-																TokenKind::FloatLiteral,  TokenKind::CharLiteral,
-																TokenKind::StringLiteral, TokenKind::Minus,
-																TokenKind::Tilde,		  TokenKind::Amp,
-																TokenKind::PlusPlus,	  TokenKind::MinusMinus};
-
-			auto next = cursor_.peek_kind();
-
-			// allow statements with generics like `a<b, c> d;`, but comparison expressions like `f(a < b, c > d)`
-			return (is_binding_allowed_ || next != TokenKind::Name)
-				   // allow comparison expressions like `f(a < b, c > 0)`
-				   && !contains(ForbiddenAfterGeneric, next)
-				   // allow comparison expressions like `a < b >> c`
-				   && (next != TokenKind::RAngle || open_angles_ > 1);
-		} else {
+		lookahead.is_closed = cursor_.match(TokenKind::RAngle);
+		lookahead.next_kind = cursor_.peek_kind();
+		return lookahead;
+	}
+
+	bool is_generic_after(GenericLookahead lookahead) const {
+		static constexpr TokenKind ForbiddenAfterGeneric[] {TokenKind::DecIntLiteral, TokenKind::HexIntLiteral,
+															TokenKind::BinIntLiteral, TokenKind::OctIntLiteral,
+															TokenKind::FloatLiteral,  TokenKind::CharLiteral,
+															TokenKind::StringLiteral, TokenKind::Minus,
+															TokenKind::Tilde,		  TokenKind::Amp,
+															TokenKind::PlusPlus,	  TokenKind::MinusMinus};
+
+		if (!lookahead.is_closed) {
 			return false;
 		}
+
+		auto next = lookahead.next_kind;
+
+		// allow statements with generics like `a<b, c> d;`, but comparison expressions like `f(a < b, c > d)`
+		return (is_binding_allowed_ || next != TokenKind::Name)
+			   // allow comparison expressions like `f(a < b, c > 0)`
+			   && !contains(ForbiddenAfterGeneric, next)
+			   // allow comparison expressions like `a < b >> c`
+			   && (next != TokenKind::RAngle || open_angles_ > 1);
 	}
 
 	template<void LiteralParseFn(std::string_view), NumericLiteralKind Kind>
@@ -716,13 +1164,19 @@ private:
 		if (!cursor_.match(TokenKind::RParen)) {
 			do {
 				parse_subexpression();
+				if (has_failed_) [[unlikely]] {
+					return {};
+				}
 				++num_args;
 			} while (cursor_.match(TokenKind::Comma));
-			expect(TokenKind::RParen, Message::ExpectClosingParen);
+			if (!expect(TokenKind::RParen, Message::ExpectClosingParen)) [[unlikely]] {
+				return {};
+			}
 		}
 
-		auto& group_expr = ast_.get(node_idx).as<AstGroupExpr>();
+		auto group_expr = ast_.as<AstGroupExpr>(ast_.get(node_idx));
 		group_expr.num_args = num_args;
+		ast_.replace(node_idx, group_expr);
 
 		return node_idx;
 	}
@@ -740,6 +1194,9 @@ private:
 		if (!cursor_.match(TokenKind::RBracket)) {
 			do {
 				parse_subexpression();
+				if (has_failed_) [[unlikely]] {
+					return num_args;
+				}
 				++num_args;
 			} while (cursor_.match(TokenKind::Comma));
 			expect(TokenKind::RBracket, Message::ExpectBracketAfterIndex);
@@ -752,9 +1209,13 @@ private:
 		auto node_idx = ast_.store(AstBreakExpr {token.offset});
 
 		bool has_expression = parse_optional_subexpression();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 
-		auto& break_expr = ast_.get(node_idx).as<AstBreakExpr>();
+		auto break_expr = ast_.as<AstBreakExpr>(ast_.get(node_idx));
 		break_expr.has_label = has_expression;
+		ast_.replace(node_idx, break_expr);
 
 		return node_idx;
 	}
@@ -764,9 +1225,13 @@ private:
 		auto node_idx = ast_.store(AstContinueExpr {token.offset});
 
 		bool has_expression = parse_optional_subexpression();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 
-		auto& continue_expr = ast_.get(node_idx).as<AstContinueExpr>();
+		auto continue_expr = ast_.as<AstContinueExpr>(ast_.get(node_idx));
 		continue_expr.has_label = has_expression;
+		ast_.replace(node_idx, continue_expr);
 
 		return node_idx;
 	}
@@ -779,12 +1244,16 @@ private:
 		if (expression_may_follow()) {
 			do {
 				parse_subexpression();
+				if (has_failed_) [[unlikely]] {
+					return {};
+				}
 				++num_expressions;
 			} while (cursor_.match(TokenKind::Comma));
 		}
 
-		auto& return_expr = ast_.get(node_idx).as<AstReturnExpr>();
+		auto return_expr = ast_.as<AstReturnExpr>(ast_.get(node_idx));
 		return_expr.num_expressions = num_expressions;
+		ast_.replace(node_idx, return_expr);
 
 		return node_idx;
 	}
@@ -794,9 +1263,13 @@ private:
 		auto node_idx = ast_.store(AstThrowExpr {token.offset});
 
 		bool has_expression = parse_optional_subexpression();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 
-		auto& throw_expr = ast_.get(node_idx).as<AstThrowExpr>();
+		auto throw_expr = ast_.as<AstThrowExpr>(ast_.get(node_idx));
 		throw_expr.has_expression = has_expression;
+		ast_.replace(node_idx, throw_expr);
 
 		return node_idx;
 	}
@@ -838,19 +1311,22 @@ private:
 			check_negation_exponentiation_ambiguity(left, operator_token);
 		}
 
-		if (auto left_expr = ast_.get(left).get<AstBinaryExpr>()) {
+		if (auto left_expr = ast_.get<AstBinaryExpr>(ast_.get(left))) {
 			check_binary_operator_ambiguity(left_expr->op, O, operator_token);
 		}
 
 		ast_.store_parent_of(left, AstBinaryExpr {offset, O});
-		auto right = parse_subexpression(precedence);
+		Ast::NodeIndex right = parse_subexpression(precedence);
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 
-		if (auto right_expr = ast_.get(right).get<AstBinaryExpr>()) {
+		if (auto right_expr = ast_.get<AstBinaryExpr>(ast_.get(right))) {
 			check_binary_operator_ambiguity(O, right_expr->op, operator_token);
 		}
 	}
 
-	void check_binary_operator_ambiguity(BinaryOperator left, BinaryOperator right, Token operator_token) {
+	void check_binary_operator_ambiguity(BinaryOperator left, BinaryOperator right, WideToken operator_token) {
 		if (operators_are_ambiguous(left, right)) {
 			auto location = operator_token.locate_in(source_);
 			auto left_str = binary_operator_to_string(left);
@@ -905,8 +1381,8 @@ private:
 		}
 	}
 
-	void check_negation_exponentiation_ambiguity(Ast::NodeIndex left, Token operator_token) {
-		if (auto unary = ast_.get(left).get<AstUnaryExpr>()) {
+	void check_negation_exponentiation_ambiguity(Ast::NodeIndex left, WideToken operator_token) {
+		if (auto unary = ast_.get<AstUnaryExpr>(ast_.get(left))) {
 			if (unary->op == UnaryOperator::Neg) {
 				auto location = operator_token.locate_in(source_);
 				report(Message::AmbiguousOperatorMixing, location, MessageArgs("-", "**"));
@@ -938,13 +1414,19 @@ private:
 		if (!cursor_.match(TokenKind::RParen)) {
 			do {
 				parse_subexpression();
+				if (has_failed_) [[unlikely]] {
+					return;
+				}
 				++num_args;
 			} while (cursor_.match(TokenKind::Comma));
-			expect(TokenKind::RParen, Message::ExpectClosingParen);
+			if (!expect(TokenKind::RParen, Message::ExpectClosingParen)) [[unlikely]] {
+				return;
+			}
 		}
 
-		auto& call_expr = ast_.get(node_idx).as<AstCallExpr>();
+		auto call_expr = ast_.as<AstCallExpr>(ast_.get(node_idx));
 		call_expr.num_args = num_args;
+		ast_.replace(node_idx, call_expr);
 	}
 
 	void on_infix_left_bracket(Ast::NodeIndex left, SourceOffset offset) {
@@ -953,9 +1435,13 @@ private:
 		auto node_idx = ast_.store_parent_of(left, AstIndexExpr {offset});
 
 		auto num_args = parse_bracketed_arguments();
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 
-		auto& index_expr = ast_.get(node_idx).as<AstIndexExpr>();
+		auto index_expr = ast_.as<AstIndexExpr>(ast_.get(node_idx));
 		index_expr.num_args = num_args;
+		ast_.replace(node_idx, index_expr);
 	}
 
 	Ast::NodeIndex on_caret() {
@@ -980,6 +1466,9 @@ private:
 			if (!cursor_.match(TokenKind::RBrace)) {
 				do {
 					parse_subexpression();
+					if (has_failed_) [[unlikely]] {
+						return {};
+					}
 					++num_args;
 				} while (cursor_.match(TokenKind::Comma));
 
@@ -987,13 +1476,16 @@ private:
 					specifier = PermissionSpecifier::VarUnbounded;
 				}
 
-				expect(TokenKind::RBrace, Message::ExpectBraceAfterPermission);
+				if (!expect(TokenKind::RBrace, Message::ExpectBraceAfterPermission)) [[unlikely]] {
+					return {};
+				}
 			}
 		}
 
-		auto& permission_expr = ast_.get(node_idx).as<AstPermissionExpr>();
+		auto permission_expr = ast_.as<AstPermissionExpr>(ast_.get(node_idx));
 		permission_expr.specifier = specifier;
 		permission_expr.num_args = num_args;
+		ast_.replace(node_idx, permission_expr);
 
 		return node_idx;
 	}
@@ -1021,12 +1513,18 @@ private:
 		bool has_bound = !cursor_.match(TokenKind::RBracket);
 		if (has_bound) {
 			parse_subexpression();
-			expect(TokenKind::RBracket, Message::ExpectBracketAfterArrayBound);
+			if (has_failed_ || !expect(TokenKind::RBracket, Message::ExpectBracketAfterArrayBound)) [[unlikely]] {
+				return {};
+			}
 		}
 		parse_type();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 
-		auto& array_type_expr = ast_.get(node_idx).as<AstArrayTypeExpr>();
+		auto array_type_expr = ast_.as<AstArrayTypeExpr>(ast_.get(node_idx));
 		array_type_expr.has_bound = has_bound;
+		ast_.replace(node_idx, array_type_expr);
 
 		return node_idx;
 	}
@@ -1037,11 +1535,18 @@ private:
 		bool has_permission = cursor_.peek_kind() == TokenKind::Var;
 		if (has_permission) { // TODO: handle other ways to have subexpressions here
 			parse_subexpression();
+			if (has_failed_) [[unlikely]] {
+				return {};
+			}
 		}
 		parse_type();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 
-		auto& ptr_type_expr = ast_.get(node_idx).as<AstPointerTypeExpr>();
+		auto ptr_type_expr = ast_.as<AstPointerTypeExpr>(ast_.get(node_idx));
 		ptr_type_expr.has_permission = has_permission;
+		ast_.replace(node_idx, ptr_type_expr);
 
 		return node_idx;
 	}
@@ -1050,12 +1555,18 @@ private:
 		auto node_idx = ast_.store(AstFunctionTypeExpr {offset});
 
 		auto num_parameters = parse_function_type_parameters();
-		expect(TokenKind::ThinArrow, Message::ExpectArrowAfterFuncTypeParams);
+		if (has_failed_ || !expect(TokenKind::ThinArrow, Message::ExpectArrowAfterFuncTypeParams)) [[unlikely]] {
+			return {};
+		}
 		auto num_outputs = parse_function_type_outputs();
+		if (has_failed_) [[unlikely]] {
+			return {};
+		}
 
-		auto& func_type_expr = ast_.get(node_idx).as<AstFunctionTypeExpr>();
+		auto func_type_expr = ast_.as<AstFunctionTypeExpr>(ast_.get(node_idx));
 		func_type_expr.num_parameters = num_parameters;
 		func_type_expr.num_outputs = num_outputs;
+		ast_.replace(node_idx, func_type_expr);
 
 		return node_idx;
 	}
@@ -1065,6 +1576,9 @@ private:
 		if (!cursor_.match(TokenKind::RParen)) {
 			do {
 				parse_function_type_parameter();
+				if (has_failed_) [[unlikely]] {
+					return num_parameters;
+				}
 				++num_parameters;
 			} while (cursor_.match(TokenKind::Comma));
 			expect(TokenKind::RParen, Message::ExpectParenAfterParams);
@@ -1085,15 +1599,19 @@ private:
 		auto node_idx = ast_.store(AstFunctionParameter {offset, specifier, {}, false});
 
 		parse_type();
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 		auto name = cursor_.match_name(source_);
 
-		auto& param = ast_.get(node_idx).as<AstFunctionParameter>();
+		auto param = ast_.as<AstFunctionParameter>(ast_.get(node_idx));
 		param.name = name;
+		ast_.replace(node_idx, param);
 
 		if (auto equal = cursor_.match_token(TokenKind::Eq)) {
 			auto location = equal->locate_in(source_);
 			report(Message::FuncTypeDefaultArgument, location, {});
-			throw ParseError();
+			has_failed_ = true;
 		}
 	}
 
@@ -1101,6 +1619,9 @@ private:
 		uint16_t num_outputs = 0;
 		do {
 			parse_function_type_output();
+			if (has_failed_) [[unlikely]] {
+				return num_outputs;
+			}
 			++num_outputs;
 		} while (cursor_.match(TokenKind::Comma));
 		expect(TokenKind::RParen, Message::ExpectParenAfterOutputs);
@@ -1113,17 +1634,25 @@ private:
 		auto node_idx = ast_.store(AstFunctionOutput {offset});
 
 		parse_type();
+		if (has_failed_) [[unlikely]] {
+			return;
+		}
 		auto name = cursor_.match_name(source_);
 
-		auto& output = ast_.get(node_idx).as<AstFunctionOutput>();
+		auto output = ast_.as<AstFunctionOutput>(ast_.get(node_idx));
 		output.name = name;
+		ast_.replace(node_idx, output);
 	}
 
-	void expect(TokenKind kind, Message message) {
-		if (!cursor_.match(kind)) {
-			report_expectation(message);
-			throw ParseError();
+	/// Consumes a token of the given kind, or reports that it was expected and fails if the next token is of another kind.
+	bool expect(TokenKind kind, Message message) {
+		if (cursor_.match(kind)) {
+			return true;
 		}
+
+		report_expectation(message);
+		has_failed_ = true;
+		return false;
 	}
 
 	std::string_view expect_name(Message message) {
@@ -1147,20 +1676,186 @@ private:
 	}
 
 	void report(Message message, CodeLocation location, MessageArgs args) {
-		if (!is_looking_ahead_) {
+		if (is_looking_ahead_) {
+			held_lookahead_reports_.emplace_back(PendingParseReport {message, location, std::move(args)});
+			return;
+		}
+
+		++num_reports_;
+		if (holds_reports_) {
+			pending_reports_.emplace_back(PendingParseReport {message, location, std::move(args)});
+		} else {
 			reporter_.report(message, location, std::move(args));
-			ast_.has_errors_ = true;
 		}
+		ast_.has_errors_ = true;
+	}
+
+	/// Reports the diagnostics held back since the given number of them, unless they belong to an enclosing lookahead.
+	void report_held_lookahead_reports(size_t num_held_reports) {
+		if (is_looking_ahead_) {
+			return;
+		}
+
+		auto reports = std::span(held_lookahead_reports_).subspan(num_held_reports);
+		for (auto& report : reports) {
+			this->report(report.message, report.location, std::move(report.args));
+		}
+		held_lookahead_reports_.resize(num_held_reports);
 	}
 };
 
+/// Nodes that the AST of a source parsed while it is lexed has room for before the parsed part of the source is used to
+/// estimate how many nodes the whole source needs.
+constexpr size_t InitialStreamingAstCapacity = 16 * 1024;
+
 Ast parse(const SourceGuard& source, Reporter& reporter) {
-	auto token_stream = lex(source, reporter, false);
-	return parse(token_stream, source, reporter);
+	// tokens in a sliding window cannot tell which source segment they lie in, so longer sources are lexed in full first
+	if (source.get_length() > MaxCompactSourceLength) {
+		auto token_stream = lex(source, reporter, CommentMode::Discard);
+		return parse(token_stream, source, reporter);
+	}
+
+	// the number of tokens is not known until the whole source is lexed, so the AST starts out small and grows as the parsed
+	// part of the source shows how many nodes the rest will need
+	TokenWindow window(source, reporter);
+	const size_t initial_num_tokens = std::min<size_t>(source.get_length() / TokenStream::EstimatedSourceBytesPerToken,
+													   InitialStreamingAstCapacity);
+
+	// the parser must be constructed in its own statement, since the cursor it is given keeps the window from sliding for as
+	// long as the cursor lives
+	Parser parser(StreamingTokenCursor(window), initial_num_tokens, source, reporter);
+	return std::move(parser).parse_while_lexing();
 }
 
 Ast parse(const TokenStream& token_stream, const SourceGuard& source, Reporter& reporter) {
-	return Parser(token_stream, source, reporter).parse();
+	return Parser(TokenCursor(token_stream), token_stream.num_tokens(), source, reporter).parse();
+}
+
+Ast reparse(const Ast& old_ast,
+			const TokenStream& old_stream,
+			const SourceGuard& old_source,
+			const TokenStream& new_stream,
+			const SourceGuard& new_source,
+			SourceEdit edit,
+			Reporter& reporter) {
+	// offsets of tokens in longer sources are relative to their source segment, which an edit can move them into or out of
+	if (old_source.get_length() > MaxCompactSourceLength || new_source.get_length() > MaxCompactSourceLength) {
+		return parse(new_stream, new_source, reporter);
+	}
+
+	const auto old_tokens = old_stream.raw();
+	const auto new_tokens = new_stream.raw();
+	const auto old_lengths = old_stream.raw_lengths();
+	const auto new_lengths = new_stream.raw_lengths();
+	const auto old_closing = old_stream.raw_closing_brackets();
+	const auto new_closing = new_stream.raw_closing_brackets();
+
+	UnchangedTokens unchanged;
+	unchanged.offset_shift = edit.new_length - edit.old_length;
+
+	// the text of a token is only known to be unchanged if the token lies entirely before or behind the edit, but whether
+	// it was lexed the same can also depend on the text after it, so the tokens themselves must be the same as well. Since
+	// recovering from syntax errors jumps over brackets, an opening bracket must also still be closed by the same token.
+	const auto max_leading = std::min(old_stream.num_tokens(), new_stream.num_tokens()) - 1; // without end-of-file tokens
+	uint32_t& num_leading = unchanged.num_leading;
+	while (num_leading != max_leading && old_tokens[num_leading].kind == new_tokens[num_leading].kind
+		   && old_tokens[num_leading].offset == new_tokens[num_leading].offset
+		   && old_lengths[num_leading] == new_lengths[num_leading]
+		   && old_tokens[num_leading].offset + old_lengths[num_leading] <= edit.offset
+		   && old_closing[num_leading] == new_closing[num_leading]) {
+		++num_leading;
+	}
+
+	const SourceOffset old_edit_end = edit.offset + edit.old_length;
+	auto old_index = old_stream.num_tokens();
+	auto new_index = new_stream.num_tokens();
+	while (old_index != num_leading && new_index != num_leading) {
+		const auto old_token = old_tokens[old_index - 1];
+		const auto new_token = new_tokens[new_index - 1];
+		const auto old_close = old_closing[old_index - 1];
+		const auto new_close = new_closing[new_index - 1];
+		const bool closes_alike = old_close == BracketPair::Unclosed ? new_close == BracketPair::Unclosed
+																	 : new_close == old_close + (new_index - old_index);
+		if (old_token.kind != new_token.kind || old_token.offset < old_edit_end
+			|| new_token.offset != old_token.offset + unchanged.offset_shift
+			|| old_lengths[old_index - 1] != new_lengths[new_index - 1] || !closes_alike) {
+			break;
+		}
+		--old_index;
+		--new_index;
+	}
+	unchanged.first_trailing = old_index;
+	unchanged.index_shift = new_index - old_index;
+
+	Parser parser(TokenCursor(new_stream), new_stream.num_tokens(), new_source, reporter);
+	return std::move(parser).reparse(new_stream, old_ast, unchanged);
+}
+
+Ast parse_signatures(const TokenStream& token_stream, const SourceGuard& source, Reporter& reporter) {
+	return Parser(TokenCursor(token_stream), token_stream.num_tokens(), source, reporter).parse_signatures();
+}
+
+std::optional<Ast> parse_function_body(const Ast& signatures,
+									   const AstFunctionDefinition& definition,
+									   const TokenStream& token_stream,
+									   const SourceGuard& source,
+									   Reporter& reporter) {
+	return Parser<TokenCursor>::parse_skipped_body(signatures, definition, token_stream, source, reporter);
+}
+
+Ast parse_parallel(const TokenStream& token_stream,
+				   const SourceGuard& source,
+				   Reporter& reporter,
+				   ThreadPool& thread_pool,
+				   size_t min_chunk_tokens) {
+	const uint32_t num_tokens = token_stream.num_tokens();
+	const size_t max_chunks = num_tokens / std::max(min_chunk_tokens, size_t(1));
+	const size_t num_chunks = std::min(size_t(thread_pool.num_threads()) * ParallelParseChunksPerThread, max_chunks);
+	if (num_chunks < 2) {
+		return parse(token_stream, source, reporter);
+	}
+
+	// chunks begin after a closing brace that balances all braces before it, where a top-level definition almost always begins
+	// as well. Parsing structs, enums and for-loops is not implemented yet, so a chunk stops at the definition with any of them
+	// and only the tokens from there to the next chunk are parsed sequentially.
+	const auto tokens = token_stream.raw();
+	std::vector<uint32_t> chunk_begins {0};
+	uint32_t depth = 0;
+	for (uint32_t i = 0; i != num_tokens; ++i) {
+		switch (tokens[i].kind) {
+			using enum TokenKind;
+		case LBrace: ++depth; break;
+		case RBrace:
+			if (depth > 0 && --depth == 0) {
+				const uint32_t begin = i + 1;
+				if (begin >= num_tokens / num_chunks * chunk_begins.size() && begin < num_tokens - 1) {
+					chunk_begins.emplace_back(begin);
+				}
+			}
+			break;
+		default: break;
+		}
+	}
+	chunk_begins.emplace_back(num_tokens - 1); // the end-of-file token
+
+	const auto num_parsed_chunks = static_cast<uint32_t>(chunk_begins.size() - 1);
+	if (num_parsed_chunks < 2) {
+		return parse(token_stream, source, reporter);
+	}
+
+	std::vector<std::optional<ParsedChunk>> parsed_chunks(num_parsed_chunks);
+	thread_pool.for_each_index(num_parsed_chunks, [&](uint32_t index) {
+		const auto begin = chunk_begins[index];
+		const auto end = chunk_begins[index + 1];
+		parsed_chunks[index] = Parser(TokenCursor(token_stream, begin), end - begin, source, reporter).parse_chunk(end);
+	});
+
+	std::vector<ParsedChunk> chunks;
+	chunks.reserve(num_parsed_chunks);
+	for (auto& chunk : parsed_chunks) {
+		chunks.emplace_back(std::move(*chunk));
+	}
+	return Parser(TokenCursor(token_stream), num_tokens, source, reporter).stitch(token_stream, chunks);
 }
 
 } // namespace cero
@@ -3,11 +3,60 @@
 #include "cero/io/Reporter.hpp"
 #include "cero/io/Source.hpp"
 #include "cero/syntax/Ast.hpp"
+#include "cero/syntax/Lex.hpp"
 #include "cero/syntax/TokenStream.hpp"
+#include "cero/util/ThreadPool.hpp"
 
 namespace cero {
 
+/// Parses the given source while lexing it, without ever storing its whole token stream. The AST and the diagnostics,
+/// including their order, are identical to those of lexing the source first and then parsing its token stream.
 Ast parse(const SourceGuard& source, Reporter& reporter);
 Ast parse(const TokenStream& token_stream, const SourceGuard& source, Reporter& reporter);
 
+/// Parses a source after an edit, given its AST, token stream and text from before the edit and its token stream and text
+/// after the edit. Only the top-level definitions around the edit are parsed again, while the nodes of the others are copied
+/// from the old AST with their offsets shifted. The result is identical to parsing the new token stream from scratch, but
+/// diagnostics are only reported for the definitions that are parsed again. Sources longer than MaxCompactSourceLength, as
+/// well as old ASTs that were not parsed from a token stream or that have skipped function bodies, are parsed from scratch.
+Ast reparse(const Ast& old_ast,
+			const TokenStream& old_stream,
+			const SourceGuard& old_source,
+			const TokenStream& new_stream,
+			const SourceGuard& new_source,
+			SourceEdit edit,
+			Reporter& reporter);
+
+/// Parses the given token stream like parse does, except that the bodies of function definitions are skipped by matching up
+/// their braces, so that they hold no statements in the AST. Syntax errors in a skipped body are only reported once it is
+/// parsed with parse_function_body. Bodies without a closing brace are parsed right away. The binary representation of the
+/// AST does not include the skipped bodies.
+Ast parse_signatures(const TokenStream& token_stream, const SourceGuard& source, Reporter& reporter);
+
+/// Parses the body of a function definition that was skipped by parse_signatures, given the AST it returned and the same
+/// token stream and source. The root of the resulting AST is a block statement holding the statements of the body. Returns
+/// nothing if the body of the definition was not skipped.
+std::optional<Ast> parse_function_body(const Ast& signatures,
+									   const AstFunctionDefinition& definition,
+									   const TokenStream& token_stream,
+									   const SourceGuard& source,
+									   Reporter& reporter);
+
+/// Token streams are split into at most this many chunks per thread when parsing in parallel, to even out the work per thread.
+constexpr size_t ParallelParseChunksPerThread = 4;
+
+/// Smallest number of tokens in a chunk that is worth handing to another thread during parallel parsing.
+constexpr size_t ParallelParseMinChunkTokens = 64 * 1024;
+
+/// Parses the given token stream by splitting it into chunks of top-level definitions and parsing the chunks concurrently on
+/// the thread pool. Chunks begin after a closing brace that balances all braces before it. The AST and the diagnostics,
+/// including their order, are identical to those of sequential parsing. Token streams too small to be split into chunks of the
+/// minimum number of tokens are parsed sequentially on the calling thread, as is every part of a chunk from the first
+/// definition with a construct that cannot be parsed yet.
+Ast parse_parallel(const TokenStream& token_stream,
+				   const SourceGuard& source,
+				   Reporter& reporter,
+				   ThreadPool& thread_pool,
+				   size_t min_chunk_tokens = ParallelParseMinChunkTokens);
+
 } // namespace cero
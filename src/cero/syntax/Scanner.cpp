@@ -0,0 +1,200 @@
+#include "Scanner.hpp"
+
+#include "cero/syntax/Encoding.hpp"
+#include "cero/util/Macros.hpp"
+
+#if CERO_ARCH_X64
+	#include <immintrin.h>
+
+	#if CERO_COMPILER_MSVC
+		#include <intrin.h>
+		#define CERO_TARGET_AVX2
+	#else
+		#define CERO_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace cero {
+
+static size_t count_whitespace_scalar(std::string_view text) {
+	size_t i = 0;
+	while (i != text.length() && is_whitespace(text[i])) {
+		++i;
+	}
+	return i;
+}
+
+static size_t count_ascii_word_characters_scalar(std::string_view text) {
+	size_t i = 0;
+	while (i != text.length() && is_ascii_word_character(text[i])) {
+		++i;
+	}
+	return i;
+}
+
+#if CERO_ARCH_X64
+
+// Both vector implementations classify a block of bytes into a bit mask with one bit per byte and then count the trailing ones
+// of that mask. Range checks like `c >= lo && c <= hi` are done as a single unsigned comparison `c - lo <= hi - lo`, which is
+// expressed as `min(c - lo, hi - lo) == c - lo` since there are no unsigned byte comparisons in SSE2 or AVX2. Bytes that are
+// not standard ASCII never match any of the classes, so the scan always stops in front of a multibyte UTF-8 sequence.
+
+static __m128i sse2_in_range(__m128i bytes, char lo, char hi) {
+	const __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8(lo));
+	return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+static uint32_t sse2_whitespace_mask(__m128i bytes) {
+	const __m128i space = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+	const __m128i control = sse2_in_range(bytes, '\t', '\r');
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(space, control)));
+}
+
+static uint32_t sse2_word_character_mask(__m128i bytes) {
+	const __m128i lowercase = _mm_or_si128(bytes, _mm_set1_epi8(0x20)); // maps upper case letters onto lower case letters
+	const __m128i letter = sse2_in_range(lowercase, 'a', 'z');
+	const __m128i digit = sse2_in_range(bytes, '0', '9');
+	const __m128i underscore = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_'));
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), underscore)));
+}
+
+template<uint32_t ClassifyBlock(__m128i), size_t ScanRest(std::string_view)>
+static size_t count_sse2(std::string_view text) {
+	constexpr size_t BlockSize = sizeof(__m128i);
+	constexpr uint32_t FullMask = 0xffff;
+
+	size_t i = 0;
+	for (; text.length() - i >= BlockSize; i += BlockSize) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+
+		const uint32_t mask = ClassifyBlock(bytes);
+		if (mask != FullMask) {
+			return i + static_cast<size_t>(std::countr_one(mask));
+		}
+	}
+	return i + ScanRest(text.substr(i));
+}
+
+CERO_TARGET_AVX2 static __m256i avx2_in_range(__m256i bytes, char lo, char hi) {
+	const __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8(lo));
+	return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+CERO_TARGET_AVX2 static size_t count_whitespace_avx2(std::string_view text) {
+	constexpr size_t BlockSize = sizeof(__m256i);
+
+	size_t i = 0;
+	for (; text.length() - i >= BlockSize; i += BlockSize) {
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+
+		const __m256i space = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+		const __m256i control = avx2_in_range(bytes, '\t', '\r');
+
+		const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(space, control)));
+		if (mask != UINT32_MAX) {
+			return i + static_cast<size_t>(std::countr_one(mask));
+		}
+	}
+	return i + count_sse2<sse2_whitespace_mask, count_whitespace_scalar>(text.substr(i));
+}
+
+CERO_TARGET_AVX2 static size_t count_ascii_word_characters_avx2(std::string_view text) {
+	constexpr size_t BlockSize = sizeof(__m256i);
+
+	size_t i = 0;
+	for (; text.length() - i >= BlockSize; i += BlockSize) {
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+
+		const __m256i lowercase = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+		const __m256i letter = avx2_in_range(lowercase, 'a', 'z');
+		const __m256i digit = avx2_in_range(bytes, '0', '9');
+		const __m256i underscore = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('_'));
+
+		const __m256i word = _mm256_or_si256(_mm256_or_si256(letter, digit), underscore);
+		const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(word));
+		if (mask != UINT32_MAX) {
+			return i + static_cast<size_t>(std::countr_one(mask));
+		}
+	}
+	return i + count_sse2<sse2_word_character_mask, count_ascii_word_characters_scalar>(text.substr(i));
+}
+
+static bool cpu_supports_avx2() {
+	#if CERO_COMPILER_MSVC
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+
+	__cpuid(info, 1);
+	const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+	if (!has_osxsave || (_xgetbv(0) & 0x6) != 0x6) { // the OS must save the upper halves of the YMM registers
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+	#else
+	return __builtin_cpu_supports("avx2");
+	#endif
+}
+
+#endif
+
+bool is_scan_mode_supported(ScanMode mode) {
+	switch (mode) {
+		case ScanMode::Scalar: return true;
+#if CERO_ARCH_X64
+		case ScanMode::Sse2: return true;
+		case ScanMode::Avx2: {
+			static const bool has_avx2 = cpu_supports_avx2();
+			return has_avx2;
+		}
+#else
+		case ScanMode::Sse2:
+		case ScanMode::Avx2: return false;
+#endif
+	}
+	fail_unreachable();
+}
+
+ScanMode get_best_scan_mode() {
+	static const ScanMode best = [] {
+		if (is_scan_mode_supported(ScanMode::Avx2)) {
+			return ScanMode::Avx2;
+		}
+		if (is_scan_mode_supported(ScanMode::Sse2)) {
+			return ScanMode::Sse2;
+		}
+		return ScanMode::Scalar;
+	}();
+	return best;
+}
+
+const Scanner& Scanner::get(ScanMode mode) {
+	static constexpr Scanner scalar {count_whitespace_scalar, count_ascii_word_characters_scalar};
+#if CERO_ARCH_X64
+	static constexpr Scanner sse2 {count_sse2<sse2_whitespace_mask, count_whitespace_scalar>,
+								   count_sse2<sse2_word_character_mask, count_ascii_word_characters_scalar>};
+	static constexpr Scanner avx2 {count_whitespace_avx2, count_ascii_word_characters_avx2};
+#endif
+
+	if (!is_scan_mode_supported(mode)) {
+		return scalar;
+	}
+
+	switch (mode) {
+		case ScanMode::Scalar: return scalar;
+#if CERO_ARCH_X64
+		case ScanMode::Sse2: return sse2;
+		case ScanMode::Avx2: return avx2;
+#else
+		case ScanMode::Sse2:
+		case ScanMode::Avx2: return scalar;
+#endif
+	}
+	fail_unreachable();
+}
+
+} // namespace cero
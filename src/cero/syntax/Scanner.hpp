@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace cero {
+
+/// Decides how the lexer scans runs of whitespace and ASCII word characters.
+enum class ScanMode : uint8_t {
+	Scalar, ///< Classifies one character at a time. Supported everywhere.
+	Sse2,	///< Classifies 16 characters at a time. Only supported on x64.
+	Avx2,	///< Classifies 32 characters at a time. Only supported on x64 CPUs with AVX2.
+};
+
+/// Whether the CPU the compiler is running on can execute the given scan mode.
+bool is_scan_mode_supported(ScanMode mode);
+
+/// Gets the fastest scan mode supported by the CPU the compiler is running on. The result is determined once and cached.
+ScanMode get_best_scan_mode();
+
+/// Set of character classification routines for bulk scanning of source text, implemented for a specific scan mode.
+struct Scanner {
+	/// Returns the length of the run of whitespace characters at the start of the text.
+	size_t (*count_whitespace)(std::string_view text) = nullptr;
+
+	/// Returns the length of the run of ASCII word characters at the start of the text. Stops at the first non-ASCII byte, so
+	/// that the caller can fall back to decoding UTF-8.
+	size_t (*count_ascii_word_characters)(std::string_view text) = nullptr;
+
+	/// Gets the scanner for the given scan mode. Falls back to the scalar implementation if the mode is not supported.
+	static const Scanner& get(ScanMode mode);
+};
+
+} // namespace cero
@@ -16,6 +16,13 @@ public:
 		end_(source.get_text().end()) {
 	}
 
+	/// Creates a cursor positioned at the given offset into the source, which must not be past the end.
+	SourceCursor(const SourceGuard& source, SourceOffset offset) :
+		it_(source.get_text().begin() + offset),
+		begin_(source.get_text().begin()),
+		end_(source.get_text().end()) {
+	}
+
 	/// Returns the current character and then advances, or returns null if the cursor is at the end.
 	std::optional<char> next() {
 		if (it_ != end_) {
@@ -41,6 +48,11 @@ public:
 		}
 	}
 
+	/// Moves cursor ahead by the given number of characters, which must not be more than the number of remaining characters.
+	void advance_by(size_t count) {
+		it_ += static_cast<ptrdiff_t>(count);
+	}
+
 	/// Returns true and advances if the current character equals the expected, otherwise false.
 	bool match(char expected) {
 		if (it_ != end_ && *it_ == expected) {
@@ -56,6 +68,11 @@ public:
 		return it_ != end_;
 	}
 
+	/// Gets a view of the source text from the current character up to the end.
+	std::string_view remaining() const {
+		return {it_, end_};
+	}
+
 	/// Current offset from the beginning of the source text.
 	SourceOffset offset() const {
 		return static_cast<SourceOffset>(it_ - begin_);
@@ -0,0 +1,115 @@
+#include "StreamingTokenCursor.hpp"
+
+namespace cero {
+
+TokenWindow::TokenWindow(const SourceGuard& source, Reporter& reporter, ScanMode scan_mode) :
+	lexer_(source, reporter, scan_mode),
+	tokens_(MinCapacity),
+	lengths_(MinCapacity),
+	closing_brackets_(MinCapacity),
+	end_(tokens_.data()) {
+	lex_more();
+}
+
+bool TokenWindow::has_errors() const {
+	return lexer_.has_errors();
+}
+
+uint32_t TokenWindow::get_capacity() const {
+	return static_cast<uint32_t>(tokens_.size());
+}
+
+void TokenWindow::lex_more() {
+	const Token* first_needed = end_;
+	for (auto cursor : cursors_) {
+		first_needed = std::min(first_needed, cursor->it_);
+	}
+
+	const auto first = first_needed - tokens_.data();
+	const auto last = end_ - tokens_.data();
+	const auto num_kept = static_cast<size_t>(last - first);
+
+	// growing once more than half is still needed keeps the amount of tokens moved to the front linear in the tokens lexed
+	if (num_kept > tokens_.size() / 2) {
+		std::vector<Token> tokens(tokens_.size() * 2);
+		std::vector<uint32_t> lengths(lengths_.size() * 2);
+		std::vector<uint32_t> closing_brackets(closing_brackets_.size() * 2);
+		std::copy(tokens_.begin() + first, tokens_.begin() + last, tokens.begin());
+		std::copy(lengths_.begin() + first, lengths_.begin() + last, lengths.begin());
+		std::copy(closing_brackets_.begin() + first, closing_brackets_.begin() + last, closing_brackets.begin());
+		tokens_ = std::move(tokens);
+		lengths_ = std::move(lengths);
+		closing_brackets_ = std::move(closing_brackets);
+	} else {
+		std::copy(tokens_.begin() + first, tokens_.begin() + last, tokens_.begin());
+		std::copy(lengths_.begin() + first, lengths_.begin() + last, lengths_.begin());
+		std::copy(closing_brackets_.begin() + first, closing_brackets_.begin() + last, closing_brackets_.begin());
+	}
+	for (auto cursor : cursors_) {
+		cursor->it_ = tokens_.data() + (cursor->it_ - first_needed);
+	}
+	first_index_ += static_cast<uint32_t>(first);
+
+	const auto num_lexed = lexer_.lex_into(std::span(tokens_).subspan(num_kept), std::span(lengths_).subspan(num_kept),
+										   resolved_brackets_);
+	end_ = tokens_.data() + num_kept + num_lexed;
+
+	// brackets can be closed in the same batch that opens them, so the new ones are marked as pending first
+	const auto new_brackets = std::span(closing_brackets_).subspan(num_kept, num_lexed);
+	std::fill(new_brackets.begin(), new_brackets.end(), PendingBracket);
+	for (auto pair : resolved_brackets_) {
+		if (pair.open >= first_index_) {
+			closing_brackets_[pair.open - first_index_] = pair.close;
+		}
+	}
+	resolved_brackets_.clear();
+}
+
+bool StreamingTokenCursor::skip_bracketed() {
+	if (!is_opening_bracket(peek_kind())) {
+		return false;
+	}
+
+	// the window keeps every token from this cursor onward, so lexing more eventually brings in the closing token
+	auto& closing_brackets = window_->closing_brackets_;
+	auto position = [&] {
+		return static_cast<uint32_t>(it_ - window_->tokens_.data());
+	};
+	while (closing_brackets[position()] == TokenWindow::PendingBracket) {
+		window_->lex_more();
+	}
+
+	const uint32_t close = closing_brackets[position()];
+	if (close == BracketPair::Unclosed) {
+		return false;
+	}
+
+	it_ += close - (window_->first_index_ + position());
+	advance(); // the closing token comes before the end-of-file token
+	return true;
+}
+
+StreamingTokenCursor::StreamingTokenCursor(TokenWindow& window) :
+	window_(&window),
+	it_(window.tokens_.data()) {
+	window_->cursors_.emplace_back(this);
+}
+
+StreamingTokenCursor::StreamingTokenCursor(const StreamingTokenCursor& other) :
+	window_(other.window_),
+	it_(other.it_) {
+	window_->cursors_.emplace_back(this);
+}
+
+StreamingTokenCursor& StreamingTokenCursor::operator=(const StreamingTokenCursor& other) {
+	check(window_ == other.window_, "cursors over different token windows cannot be assigned to each other");
+	it_ = other.it_;
+	return *this;
+}
+
+StreamingTokenCursor::~StreamingTokenCursor() {
+	auto& cursors = window_->cursors_;
+	cursors.erase(std::find(cursors.begin(), cursors.end(), this));
+}
+
+} // namespace cero
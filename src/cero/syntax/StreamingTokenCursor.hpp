@@ -0,0 +1,150 @@
+#pragma once
+
+#include "cero/syntax/Lex.hpp"
+
+#include <vector>
+
+namespace cero {
+
+class StreamingTokenCursor;
+
+/// Holds the tokens of a source that are lexed on demand, for as long as a cursor might still visit them. The window slides
+/// forward over the token stream as the cursors advance, so the full token stream is never stored at once.
+class TokenWindow {
+public:
+	/// Fewest tokens the window has room for.
+	static constexpr uint32_t MinCapacity = 256;
+
+	/// Creates a window over the tokens of the given source and lexes the first of them. The source must not be longer than
+	/// MaxCompactSourceLength, so that every token offset is a full source offset.
+	explicit TokenWindow(const SourceGuard& source, Reporter& reporter, ScanMode scan_mode = get_best_scan_mode());
+
+	/// Whether syntax errors were encountered in the tokens lexed so far.
+	bool has_errors() const;
+
+	/// Number of tokens the window has room for, which grows only while cursors keep many tokens in the window at once.
+	uint32_t get_capacity() const;
+
+	TokenWindow(TokenWindow&&) = delete;
+	TokenWindow& operator=(TokenWindow&&) = delete;
+
+private:
+	/// Value of closing_brackets_ for opening brackets whose closing token the lexer might still come across.
+	static constexpr uint32_t PendingBracket = BracketPair::Unclosed - 1;
+
+	StreamingLexer lexer_;
+	std::vector<Token> tokens_;
+	std::vector<uint32_t> lengths_;
+	std::vector<uint32_t> closing_brackets_; // like in a token stream, but indices count from the first token of the source
+	std::vector<BracketPair> resolved_brackets_;
+	std::vector<StreamingTokenCursor*> cursors_;
+	const Token* end_ = nullptr; // one past the last token lexed so far
+	uint32_t first_index_ = 0;	 // index of the first token in the window, counting from the first token of the source
+
+	/// Drops the tokens that no cursor can visit anymore, grows the window if that frees too little room, and then lexes as
+	/// many tokens as fit. Cursors are moved along with the tokens they point to.
+	void lex_more();
+
+	friend class StreamingTokenCursor;
+};
+
+/// Iterates over the tokens in a token window, in the same way that a TokenCursor iterates over a token stream. All tokens from
+/// the position of the rearmost cursor onward stay in the window, so copies of a cursor can be used to look ahead and then go
+/// back. An instance of this class must not outlive the window it is initialized with.
+class StreamingTokenCursor {
+public:
+	/// Creates a cursor positioned at the first token that the window has not dropped yet.
+	explicit StreamingTokenCursor(TokenWindow& window);
+
+	StreamingTokenCursor(const StreamingTokenCursor& other);
+	StreamingTokenCursor& operator=(const StreamingTokenCursor& other);
+	~StreamingTokenCursor();
+
+	/// Returns the current token.
+	WideToken peek() const {
+		return WideToken {it_->kind, it_->offset};
+	}
+
+	/// Returns the current token kind.
+	TokenKind peek_kind() const {
+		return it_->kind;
+	}
+
+	/// Returns the current token offset.
+	SourceOffset peek_offset() const {
+		return it_->offset;
+	}
+
+	/// Returns the current token and then advances if not at the end.
+	WideToken next() {
+		const auto token = peek();
+		advance();
+		return token;
+	}
+
+	/// Returns true and advances if the current token kind equals the expected, otherwise returns false.
+	bool match(TokenKind kind) {
+		if (peek_kind() == kind) {
+			advance();
+			return true;
+		}
+		return false;
+	}
+
+	/// Returns the current token and advances if the current token kind equals the expected, otherwise returns null.
+	std::optional<WideToken> match_token(TokenKind kind) {
+		auto token = peek();
+		if (token.kind == kind) {
+			advance();
+			return token;
+		}
+		return std::nullopt;
+	}
+
+	/// Returns a string view of the lexeme and advances if the current token kind is an identifier token, otherwise returns an
+	/// empty string.
+	std::string_view match_name(const SourceGuard& source) {
+		if (peek_kind() == TokenKind::Name) {
+			auto identifier = get_lexeme(source);
+			advance();
+			return identifier;
+		}
+		return {};
+	}
+
+	/// Returns the token after the current token.
+	WideToken peek_ahead() {
+		if (it_->kind == TokenKind::EndOfFile) {
+			return peek();
+		}
+		if (it_ + 1 == window_->end_) {
+			window_->lex_more();
+		}
+		return WideToken {it_[1].kind, it_[1].offset};
+	}
+
+	/// Returns a string view of the current token's lexeme, which excludes any trailing whitespace.
+	std::string_view get_lexeme(const SourceGuard& source) const {
+		return source.get_text().substr(it_->offset, window_->lengths_[static_cast<size_t>(it_ - window_->tokens_.data())]);
+	}
+
+	/// Moves cursor to the next token.
+	void advance() {
+		if (it_->kind != TokenKind::EndOfFile && ++it_ == window_->end_) {
+			window_->lex_more();
+		}
+	}
+
+	/// Moves past the token that closes the opening bracket at the current token and returns true, or returns false without
+	/// moving if the current token is no opening bracket or no token closes it. The window grows until it holds the closing
+	/// token, so this is meant for jumps that are rare, such as when recovering from syntax errors.
+	bool skip_bracketed();
+
+private:
+	TokenWindow* window_;
+	const Token* it_;
+
+	friend class TokenWindow;
+};
+
+} // namespace cero
@@ -99,90 +99,6 @@ std::string_view token_kind_to_string(TokenKind kind) {
 	fail_unreachable();
 }
 
-std::string_view get_fixed_length_lexeme(TokenKind kind) {
-	switch (kind) {
-		using enum TokenKind;
-		case Dot:			 return ".";
-		case Comma:			 return ",";
-		case Colon:			 return ":";
-		case Semicolon:		 return ";";
-		case LBrace:		 return "{";
-		case RBrace:		 return "}";
-		case LParen:		 return "(";
-		case RParen:		 return ")";
-		case LBracket:		 return "[";
-		case RBracket:		 return "]";
-		case LAngle:		 return "<";
-		case RAngle:		 return ">";
-		case Eq:			 return "=";
-		case Plus:			 return "+";
-		case Minus:			 return "-";
-		case Star:			 return "*";
-		case Slash:			 return "/";
-		case Percent:		 return "%";
-		case Amp:			 return "&";
-		case Pipe:			 return "|";
-		case Tilde:			 return "~";
-		case Caret:			 return "^";
-		case Bang:			 return "!";
-		case Quest:			 return "?";
-		case At:			 return "@";
-		case Dollar:		 return "$";
-		case Hash:			 return "#";
-		case ThinArrow:		 return "->";
-		case ThickArrow:	 return "=>";
-		case ColonColon:	 return "::";
-		case PlusPlus:		 return "++";
-		case MinusMinus:	 return "--";
-		case StarStar:		 return "**";
-		case LAngleLAngle:	 return "<<";
-		case AmpAmp:		 return "&&";
-		case PipePipe:		 return "||";
-		case EqEq:			 return "==";
-		case BangEq:		 return "!=";
-		case LAngleEq:		 return "<=";
-		case RAngleEq:		 return ">=";
-		case PlusEq:		 return "+=";
-		case MinusEq:		 return "-=";
-		case StarEq:		 return "*=";
-		case SlashEq:		 return "/=";
-		case PercentEq:		 return "%=";
-		case AmpEq:			 return "&=";
-		case PipeEq:		 return "|=";
-		case TildeEq:		 return "~=";
-		case Ellipsis:		 return "...";
-		case StarStarEq:	 return "**=";
-		case LAngleLAngleEq: return "<<=";
-		case RAngleRAngleEq: return ">>=";
-		case AmpAmpEq:		 return "&&=";
-		case PipePipeEq:	 return "||=";
-		case Break:			 return "break";
-		case Catch:			 return "catch";
-		case Const:			 return "const";
-		case Continue:		 return "continue";
-		case Do:			 return "do";
-		case Else:			 return "else";
-		case Enum:			 return "enum";
-		case For:			 return "for";
-		case If:			 return "if";
-		case In:			 return "in";
-		case Let:			 return "let";
-		case Private:		 return "private";
-		case Public:		 return "public";
-		case Return:		 return "return";
-		case Static:		 return "static";
-		case Struct:		 return "struct";
-		case Switch:		 return "switch";
-		case Throw:			 return "throw";
-		case Try:			 return "try";
-		case Unchecked:		 return "unchecked";
-		case Var:			 return "var";
-		case While:			 return "while";
-		case EndOfFile:		 return "";
-		default:			 fail_unreachable();
-	}
-}
-
 std::string_view get_token_message_format(TokenKind kind) {
 	switch (kind) {
 		using enum TokenKind;
@@ -304,4 +220,8 @@ CodeLocation Token::locate_in(const SourceGuard& source) const {
 	return source.locate(offset);
 }
 
+CodeLocation WideToken::locate_in(const SourceGuard& source) const {
+	return source.locate(offset);
+}
+
 } // namespace cero
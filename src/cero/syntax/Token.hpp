@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cero/io/Source.hpp"
+#include "cero/util/Fail.hpp"
 
 #include <cstdint>
 #include <string>
@@ -109,10 +110,12 @@ enum class TokenKind {
 };
 
 std::string_view token_kind_to_string(TokenKind kind);
-std::string_view get_fixed_length_lexeme(TokenKind kind);
+constexpr std::string_view get_fixed_length_lexeme(TokenKind kind);
 std::string_view get_token_message_format(TokenKind kind);
 bool is_variable_length_token(TokenKind kind);
 
+/// A token as stored in a token stream. Its offset is relative to the source segment it lies in, which is the start of the
+/// source unless the source is longer than MaxCompactSourceLength.
 struct Token {
 	TokenKind kind : 8 = {};
 	SourceOffset offset : SourceOffsetBits = 0;
@@ -122,4 +125,102 @@ struct Token {
 
 static_assert(sizeof(Token) == 4);
 
+/// A token with its full source offset, as token cursors return it.
+struct WideToken {
+	TokenKind kind = {};
+	SourceOffset offset = 0;
+
+	CodeLocation locate_in(const SourceGuard& source) const;
+};
+
+/// Defined here instead of in the source file so that lexing tables can be derived from it at compile time.
+constexpr std::string_view get_fixed_length_lexeme(TokenKind kind) {
+	switch (kind) {
+		using enum TokenKind;
+		case Dot:			 return ".";
+		case Comma:			 return ",";
+		case Colon:			 return ":";
+		case Semicolon:		 return ";";
+		case LBrace:		 return "{";
+		case RBrace:		 return "}";
+		case LParen:		 return "(";
+		case RParen:		 return ")";
+		case LBracket:		 return "[";
+		case RBracket:		 return "]";
+		case LAngle:		 return "<";
+		case RAngle:		 return ">";
+		case Eq:			 return "=";
+		case Plus:			 return "+";
+		case Minus:			 return "-";
+		case Star:			 return "*";
+		case Slash:			 return "/";
+		case Percent:		 return "%";
+		case Amp:			 return "&";
+		case Pipe:			 return "|";
+		case Tilde:			 return "~";
+		case Caret:			 return "^";
+		case Bang:			 return "!";
+		case Quest:			 return "?";
+		case At:			 return "@";
+		case Dollar:		 return "$";
+		case Hash:			 return "#";
+		case ThinArrow:		 return "->";
+		case ThickArrow:	 return "=>";
+		case ColonColon:	 return "::";
+		case PlusPlus:		 return "++";
+		case MinusMinus:	 return "--";
+		case StarStar:		 return "**";
+		case LAngleLAngle:	 return "<<";
+		case AmpAmp:		 return "&&";
+		case PipePipe:		 return "||";
+		case EqEq:			 return "==";
+		case BangEq:		 return "!=";
+		case LAngleEq:		 return "<=";
+		case RAngleEq:		 return ">=";
+		case PlusEq:		 return "+=";
+		case MinusEq:		 return "-=";
+		case StarEq:		 return "*=";
+		case SlashEq:		 return "/=";
+		case PercentEq:		 return "%=";
+		case AmpEq:			 return "&=";
+		case PipeEq:		 return "|=";
+		case TildeEq:		 return "~=";
+		case Ellipsis:		 return "...";
+		case StarStarEq:	 return "**=";
+		case LAngleLAngleEq: return "<<=";
+		case RAngleRAngleEq: return ">>=";
+		case AmpAmpEq:		 return "&&=";
+		case PipePipeEq:	 return "||=";
+		case Break:			 return "break";
+		case Catch:			 return "catch";
+		case Const:			 return "const";
+		case Continue:		 return "continue";
+		case Do:			 return "do";
+		case Else:			 return "else";
+		case Enum:			 return "enum";
+		case For:			 return "for";
+		case If:			 return "if";
+		case In:			 return "in";
+		case Let:			 return "let";
+		case Private:		 return "private";
+		case Public:		 return "public";
+		case Return:		 return "return";
+		case Static:		 return "static";
+		case Struct:		 return "struct";
+		case Switch:		 return "switch";
+		case Throw:			 return "throw";
+		case Try:			 return "try";
+		case Unchecked:		 return "unchecked";
+		case Var:			 return "var";
+		case While:			 return "while";
+		case EndOfFile:		 return "";
+		default:			 fail_unreachable();
+	}
+}
+
+/// Whether the token kind is a brace, parenthesis or square bracket that opens a bracketed range of tokens.
+constexpr bool is_opening_bracket(TokenKind kind) {
+	return kind == TokenKind::LBrace || kind == TokenKind::LParen || kind == TokenKind::LBracket;
+}
+
 } // namespace cero
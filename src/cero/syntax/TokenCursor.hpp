@@ -1,21 +1,37 @@
 #pragma once
 
-#include "cero/syntax/Encoding.hpp"
 #include "cero/syntax/TokenStream.hpp"
 
 namespace cero {
 
-/// Iterates over a token stream. An instance of this class must not outlive the token stream it is initialized with.
+/// Iterates over a token stream, returning tokens with their full source offsets. An instance of this class must not outlive
+/// the token stream it is initialized with.
 class TokenCursor {
 public:
 	/// Creates a cursor positioned at the first token of the given token stream.
 	explicit TokenCursor(const TokenStream& token_stream) :
-		it_(token_stream.raw().begin()) {
+		it_(token_stream.raw().data()),
+		begin_(it_),
+		lengths_(token_stream.raw_lengths().data()),
+		token_stream_(&token_stream) {
+		enter_source_segments();
+	}
+
+	/// Creates a cursor positioned at the token with the given index in the given token stream.
+	TokenCursor(const TokenStream& token_stream, uint32_t token_index) :
+		TokenCursor(token_stream) {
+		it_ += token_index;
+		enter_source_segments();
+	}
+
+	/// Returns the index of the current token in the token stream.
+	uint32_t get_token_index() const {
+		return static_cast<uint32_t>(it_ - begin_);
 	}
 
 	/// Returns the current token.
-	Token peek() const {
-		return *it_;
+	WideToken peek() const {
+		return WideToken {it_->kind, peek_offset()};
 	}
 
 	/// Returns the current token kind.
@@ -25,12 +41,12 @@ public:
 
 	/// Returns the current token offset.
 	SourceOffset peek_offset() const {
-		return it_->offset;
+		return segment_base_ + it_->offset;
 	}
 
 	/// Returns the current token and then advances if not at the end.
-	Token next() {
-		const auto token = *it_;
+	WideToken next() {
+		const auto token = peek();
 		advance();
 		return token;
 	}
@@ -45,8 +61,8 @@ public:
 	}
 
 	/// Returns the current token and advances if the current token kind equals the expected, otherwise returns null.
-	std::optional<Token> match_token(TokenKind kind) {
-		auto token = *it_;
+	std::optional<WideToken> match_token(TokenKind kind) {
+		auto token = peek();
 		if (token.kind == kind) {
 			advance();
 			return token;
@@ -66,52 +82,76 @@ public:
 	}
 
 	/// Returns the token after the current token.
-	Token peek_ahead() {
-		auto saved = it_;
-		advance();
-		auto token = *it_;
-		it_ = saved;
-		return token;
+	WideToken peek_ahead() const {
+		if (it_ == stop_) [[unlikely]] {
+			auto copy = *this;
+			copy.advance();
+			return copy.peek();
+		}
+		return WideToken {it_[1].kind, segment_base_ + it_[1].offset};
 	}
 
+	/// Returns a string view of the current token's lexeme, which excludes any trailing whitespace.
 	std::string_view get_lexeme(const SourceGuard& source) const {
-		const auto offset = it_->offset;
-		const auto length = it_->kind != TokenKind::EndOfFile ? it_[1].offset - offset : 0;
-
-		auto lexeme = source.get_text().substr(offset, length);
-
-		size_t whitespace = 0;
-		const auto end = lexeme.rend();
-		for (auto it = lexeme.rbegin(); it != end; ++it) {
-			if (is_whitespace(*it)) {
-				++whitespace;
-			} else {
-				break;
-			}
-		}
-		lexeme.remove_suffix(whitespace);
-
-		return lexeme;
+		return source.get_text().substr(peek_offset(), lengths_[it_ - begin_]);
 	}
 
 	/// Moves cursor to the next token.
 	void advance() {
-		if (it_->kind != TokenKind::EndOfFile) {
+		if (it_ != stop_) [[likely]] {
+			++it_;
+		} else if (it_->kind != TokenKind::EndOfFile) {
 			++it_;
+			enter_source_segments();
 		}
 	}
 
+	/// Moves past the token that closes the opening bracket at the current token and returns true, or returns false without
+	/// moving if the current token is no opening bracket or no token closes it.
+	bool skip_bracketed() {
+		auto close = token_stream_->find_closing_bracket(get_token_index());
+		if (!close) {
+			return false;
+		}
+
+		it_ = begin_ + *close + 1; // the closing token comes before the end-of-file token
+		enter_source_segments();
+		return true;
+	}
+
 	/// Advance to the next non-comment token.
 	void skip_comments() {
 		auto kind = it_->kind;
 		while (kind == TokenKind::LineComment || kind == TokenKind::BlockComment) {
-			++it_;
+			advance();
 			kind = it_->kind;
 		}
 	}
 
 private:
-	std::span<const Token>::iterator it_;
+	// Only the stop token needs a check when advancing, which is the end-of-file token unless the source has more than one
+	// segment. The rest of the segment state is looked up in the token stream, to keep copies of cursors for lookaheads small.
+	const Token* it_;
+	const Token* begin_;
+	const Token* stop_ = nullptr; // last token before the next source segment begins, or the end-of-file token
+	const uint32_t* lengths_;
+	const TokenStream* token_stream_;
+	SourceOffset segment_base_ = 0;
+
+	/// Moves into every source segment that begins at or before the current token, and finds the token to stop at next.
+	void enter_source_segments() {
+		const auto segment_starts = token_stream_->raw_source_segment_starts();
+		const auto index = get_token_index();
+
+		size_t num_entered = 0;
+		while (num_entered != segment_starts.size() && segment_starts[num_entered] <= index) {
+			++num_entered;
+		}
+		segment_base_ = static_cast<SourceOffset>(num_entered * SourceSegmentLength);
+
+		const auto num_tokens = token_stream_->raw().size();
+		stop_ = begin_ + (num_entered != segment_starts.size() ? segment_starts[num_entered] : num_tokens) - 1;
+	}
 };
 
 } // namespace cero
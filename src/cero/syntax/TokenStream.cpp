@@ -9,13 +9,62 @@ uint32_t TokenStream::num_tokens() const {
 }
 
 bool TokenStream::has_errors() const {
-	return has_errors_;
+	return !error_offsets_.empty();
 }
 
 std::span<const Token> TokenStream::raw() const {
 	return {stream_};
 }
 
+std::span<const uint32_t> TokenStream::raw_lengths() const {
+	return {lengths_};
+}
+
+std::span<const uint32_t> TokenStream::raw_source_segment_starts() const {
+	return {source_segment_starts_};
+}
+
+SourceOffset TokenStream::get_offset(uint32_t token_index) const {
+	auto segment = std::upper_bound(source_segment_starts_.begin(), source_segment_starts_.end(), token_index);
+	const auto segment_index = static_cast<SourceOffset>(segment - source_segment_starts_.begin());
+	return (segment_index << SourceOffsetBits) + stream_[token_index].offset;
+}
+
+std::span<const uint32_t> TokenStream::raw_closing_brackets() const {
+	return {closing_brackets_};
+}
+
+std::optional<uint32_t> TokenStream::find_closing_bracket(uint32_t token_index) const {
+	const uint32_t close = closing_brackets_[token_index];
+	if (close == BracketPair::Unclosed) {
+		return std::nullopt;
+	}
+	return close;
+}
+
+bool TokenStream::has_unbalanced_brackets() const {
+	return has_unbalanced_brackets_;
+}
+
+std::span<const Trivia> TokenStream::raw_trivia() const {
+	return {trivia_};
+}
+
+std::span<const Trivia> TokenStream::get_trivia_before(uint32_t token_index) const {
+	auto first = std::partition_point(trivia_.begin(), trivia_.end(), [&](const Trivia& trivia) {
+		return trivia.next_token < token_index;
+	});
+	auto last = std::partition_point(first, trivia_.end(), [&](const Trivia& trivia) {
+		return trivia.next_token == token_index;
+	});
+	return {first, last};
+}
+
+TokenStorageStats TokenStream::get_storage_stats() const {
+	const size_t used_bytes = stream_.size() * sizeof(Token) + lengths_.size() * sizeof(uint32_t);
+	return TokenStorageStats {used_bytes, count_reserved_bytes(), peak_reserved_bytes_};
+}
+
 std::string TokenStream::to_string(const SourceGuard& source) const {
 	auto num_tokens = stream_.size();
 	auto str = fmt::format("Token stream for {} ({} token{})\n", source.get_name(), num_tokens, num_tokens == 1 ? "" : "s");
@@ -26,9 +75,6 @@ std::string TokenStream::to_string(const SourceGuard& source) const {
 		auto token = cursor.next();
 
 		auto kind_str = token_kind_to_string(token.kind);
-
-		// This loop is technically quadratic since SourceGuard::locate will linearly search the source for the code location
-		// every time, but it really doesn't matter.
 		auto location_str = token.locate_in(source).to_short_string();
 
 		str += fmt::format("\t{} `{}` {}\n", kind_str, lexeme, location_str);
@@ -40,13 +86,140 @@ std::string TokenStream::to_string(const SourceGuard& source) const {
 	return str;
 }
 
-TokenStream::TokenStream(const SourceGuard& source) {
-	// TODO: find the most common ratio between source length and token count and then reserve based on that
-	stream_.reserve(source.get_length());
+TokenStream::TokenStream(size_t source_length) {
+	const size_t capacity = std::max(source_length / EstimatedSourceBytesPerToken, MinSegmentCapacity);
+	stream_.reserve(capacity);
+	lengths_.reserve(capacity);
+	peak_reserved_bytes_ = count_reserved_bytes();
+}
+
+void TokenStream::add_token(TokenKind kind, SourceOffset offset, uint32_t length) {
+	if (stream_.size() == stream_.capacity()) {
+		start_segment();
+	}
+	if (offset >= next_source_segment_offset_) [[unlikely]] {
+		enter_source_segment(offset);
+	}
+
+	stream_.emplace_back(Token {kind, offset & MaxCompactSourceLength});
+	lengths_.emplace_back(length);
+}
+
+void TokenStream::add_tokens(std::span<const Token> tokens, std::span<const uint32_t> lengths) {
+	while (!tokens.empty()) {
+		if (stream_.size() == stream_.capacity()) {
+			start_segment();
+		}
+
+		const size_t count = std::min(tokens.size(), stream_.capacity() - stream_.size());
+		stream_.insert(stream_.end(), tokens.begin(), tokens.begin() + static_cast<ptrdiff_t>(count));
+		lengths_.insert(lengths_.end(), lengths.begin(), lengths.begin() + static_cast<ptrdiff_t>(count));
+		tokens = tokens.subspan(count);
+		lengths = lengths.subspan(count);
+	}
+}
+
+void TokenStream::add_trivia(Trivia trivia) {
+	trivia_.emplace_back(trivia);
 }
 
-void TokenStream::add_token(TokenKind kind, SourceOffset offset) {
-	stream_.emplace_back(Token {kind, offset & 0x00ffffffu});
+void TokenStream::add_error(SourceOffset offset) {
+	error_offsets_.emplace_back(offset);
+}
+
+uint32_t TokenStream::count_tokens() const {
+	return num_tokens_in_full_segments_ + static_cast<uint32_t>(stream_.size());
+}
+
+void TokenStream::enter_source_segment(SourceOffset offset) {
+	const uint32_t index = count_tokens();
+	while (offset >= next_source_segment_offset_) {
+		source_segment_starts_.emplace_back(index);
+		next_source_segment_offset_ += SourceSegmentLength;
+	}
+}
+
+void TokenStream::start_segment() {
+	const size_t num_tokens = count_tokens();
+	num_tokens_in_full_segments_ = static_cast<uint32_t>(num_tokens);
+	full_segments_.emplace_back(Segment {std::exchange(stream_, {}), std::exchange(lengths_, {})});
+
+	// growing by half of the current size keeps the number of segments logarithmic without overshooting by much
+	const size_t capacity = std::max(num_tokens / 2, MinSegmentCapacity);
+	stream_.reserve(capacity);
+	lengths_.reserve(capacity);
+	peak_reserved_bytes_ = std::max(peak_reserved_bytes_, count_reserved_bytes());
+}
+
+void TokenStream::join_segments() {
+	if (full_segments_.empty()) {
+		return;
+	}
+
+	const size_t num_tokens = count_tokens();
+
+	std::vector<Token> tokens;
+	std::vector<uint32_t> lengths;
+	tokens.reserve(num_tokens);
+	lengths.reserve(num_tokens);
+	const size_t joined_bytes = num_tokens * (sizeof(Token) + sizeof(uint32_t));
+	peak_reserved_bytes_ = std::max(peak_reserved_bytes_, count_reserved_bytes() + joined_bytes);
+
+	for (auto& segment : full_segments_) {
+		tokens.insert(tokens.end(), segment.tokens.begin(), segment.tokens.end());
+		lengths.insert(lengths.end(), segment.lengths.begin(), segment.lengths.end());
+		segment = {};
+	}
+	tokens.insert(tokens.end(), stream_.begin(), stream_.end());
+	lengths.insert(lengths.end(), lengths_.begin(), lengths_.end());
+
+	stream_ = std::move(tokens);
+	lengths_ = std::move(lengths);
+	full_segments_.clear();
+	num_tokens_in_full_segments_ = 0;
+}
+
+void TokenStream::shrink() {
+	if (!full_segments_.empty()) {
+		join_segments(); // joining already allocates exactly as much as needed
+		return;
+	}
+
+	// only copy into a smaller allocation if it frees a considerable amount of memory
+	const size_t unused = stream_.capacity() - stream_.size();
+	if (unused > stream_.size() / 4) {
+		const size_t shrunk_bytes = stream_.size() * (sizeof(Token) + sizeof(uint32_t));
+		peak_reserved_bytes_ = std::max(peak_reserved_bytes_, count_reserved_bytes() + shrunk_bytes);
+		stream_.shrink_to_fit();
+		lengths_.shrink_to_fit();
+	}
+}
+
+void TokenStream::set_closing_bracket(uint32_t open_index, uint32_t close_index) {
+	// only growing up to the opening bracket leaves the filling of the rest to finishing, and the vector's own geometric growth
+	// keeps the number of reallocations logarithmic
+	if (closing_brackets_.size() <= open_index) {
+		closing_brackets_.resize(open_index + 1, BracketPair::Unclosed);
+	}
+	closing_brackets_[open_index] = close_index;
+}
+
+void TokenStream::finish() {
+	shrink();
+
+	// the tokens after the last closed bracket have no entries yet, and growing might have left too much capacity behind
+	closing_brackets_.resize(stream_.size(), BracketPair::Unclosed);
+	if (closing_brackets_.capacity() - closing_brackets_.size() > closing_brackets_.size() / 4) {
+		closing_brackets_.shrink_to_fit();
+	}
+}
+
+size_t TokenStream::count_reserved_bytes() const {
+	size_t bytes = stream_.capacity() * sizeof(Token) + lengths_.capacity() * sizeof(uint32_t);
+	for (auto& segment : full_segments_) {
+		bytes += segment.tokens.capacity() * sizeof(Token) + segment.lengths.capacity() * sizeof(uint32_t);
+	}
+	return bytes;
 }
 
 } // namespace cero
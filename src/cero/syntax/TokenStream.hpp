@@ -1,15 +1,63 @@
 #pragma once
 
 #include "cero/syntax/Token.hpp"
+#include "cero/util/BinaryStream.hpp"
 
+#include <optional>
 #include <span>
 #include <string>
 #include <vector>
 
 namespace cero {
 
+/// Memory usage of a token stream's storage.
+struct TokenStorageStats {
+	/// Bytes taken up by the tokens and their lexeme lengths.
+	size_t used_bytes = 0;
+
+	/// Bytes currently allocated for the tokens and their lexeme lengths.
+	size_t reserved_bytes = 0;
+
+	/// Most bytes that were allocated at any one time while the stream was being built.
+	size_t peak_reserved_bytes = 0;
+};
+
+/// A comment that was recorded apart from the tokens, so that tools can use comments without the parser having to skip them.
+struct Trivia {
+	/// Either LineComment or BlockComment.
+	TokenKind kind = {};
+
+	/// Offset of the comment's first character.
+	SourceOffset offset = 0;
+
+	/// Length of the comment's lexeme.
+	uint32_t length = 0;
+
+	/// Index of the token that follows the comment.
+	uint32_t next_token = 0;
+};
+
+/// An opening brace, parenthesis or square bracket, together with the token that closes it.
+struct BracketPair {
+	/// Value of close when no token closes the bracket.
+	static constexpr uint32_t Unclosed = UINT32_MAX;
+
+	/// Index of the opening token.
+	uint32_t open = 0;
+
+	/// Index of the closing token, or Unclosed.
+	uint32_t close = Unclosed;
+};
+
 class TokenStream {
 public:
+	/// Source bytes per token to expect when reserving storage up front. Handwritten code averages about 4.8 bytes per token,
+	/// and only particularly dense code goes below 4.
+	static constexpr size_t EstimatedSourceBytesPerToken = 4;
+
+	/// Fewest tokens a storage segment is created for.
+	static constexpr size_t MinSegmentCapacity = 64;
+
 	/// Number of tokens in the stream.
 	uint32_t num_tokens() const;
 
@@ -19,20 +67,108 @@ public:
 	/// Get a view of the underlying array of tokens.
 	std::span<const Token> raw() const;
 
+	/// Get a view of the lexeme lengths, where each length belongs to the token at the same index. They are kept apart from
+	/// the tokens so that the tokens stay small for the parser, which mostly only needs their kinds.
+	std::span<const uint32_t> raw_lengths() const;
+
+	/// Get a view of the indices of the tokens that begin each source segment after the first, where a segment is the stretch
+	/// of SourceSegmentLength bytes that the offsets of its tokens are relative to. Empty unless the source is longer than
+	/// MaxCompactSourceLength. A segment without any token begins with the same token as the segment after it.
+	std::span<const uint32_t> raw_source_segment_starts() const;
+
+	/// Gets the full source offset of the token at the given index.
+	SourceOffset get_offset(uint32_t token_index) const;
+
+	/// Get a view of the index of the token that closes each token, where each index belongs to the token at the same index,
+	/// or BracketPair::Unclosed for tokens that are no opening bracket or that nothing closes. A closing token matches the
+	/// innermost open bracket of its kind, and any brackets of other kinds opened after that one stay unclosed.
+	std::span<const uint32_t> raw_closing_brackets() const;
+
+	/// Gets the index of the token that closes the opening bracket at the given index, or nothing if the token is no opening
+	/// bracket or no token closes it.
+	std::optional<uint32_t> find_closing_bracket(uint32_t token_index) const;
+
+	/// Whether any bracket is unclosed or any closing token matches no bracket.
+	bool has_unbalanced_brackets() const;
+
+	/// Get a view of the comments that were recorded as trivia, in source order.
+	std::span<const Trivia> raw_trivia() const;
+
+	/// Get a view of the trivia that directly precedes the token at the given index, i.e. the comments between that token and
+	/// the one before it.
+	std::span<const Trivia> get_trivia_before(uint32_t token_index) const;
+
+	/// Memory usage of the token storage.
+	TokenStorageStats get_storage_stats() const;
+
 	/// Creates a list-like string representation of the token stream.
 	std::string to_string(const SourceGuard& source) const;
 
 private:
+	/// Storage that was filled up while lexing. It is kept as is until the stream is complete, so growing the stream never
+	/// copies existing tokens.
+	struct Segment {
+		std::vector<Token> tokens;
+		std::vector<uint32_t> lengths;
+	};
+
+	// the tokens and lengths of the segment currently being filled, which after shrinking hold the entire stream
 	std::vector<Token> stream_;
-	bool has_errors_ = false;
+	std::vector<uint32_t> lengths_;
+	std::vector<Segment> full_segments_;
+	std::vector<Trivia> trivia_;
+	std::vector<uint32_t> closing_brackets_; // filled in by the lexer as it closes brackets, so it can be shorter until finished
+	bool has_unbalanced_brackets_ = false;
+	std::vector<SourceOffset> error_offsets_; // where diagnostics were reported, so that relexing can carry them over
+	std::vector<uint32_t> source_segment_starts_;
+	size_t next_source_segment_offset_ = SourceSegmentLength;
+	uint32_t num_tokens_in_full_segments_ = 0;
+	size_t peak_reserved_bytes_ = 0;
 
 	/// Reserves storage for the token stream based on the length of the source code input.
-	explicit TokenStream(const SourceGuard& source);
+	explicit TokenStream(size_t source_length);
+
+	/// Appends a token with the given lexeme length to the stream.
+	void add_token(TokenKind kind, SourceOffset offset, uint32_t length);
+
+	/// Appends a range of already lexed tokens and their lexeme lengths to the stream. The tokens must all lie in the first
+	/// source segment.
+	void add_tokens(std::span<const Token> tokens, std::span<const uint32_t> lengths);
+
+	/// Appends a comment to the trivia.
+	void add_trivia(Trivia trivia);
+
+	/// Records that a diagnostic was reported at the given offset.
+	void add_error(SourceOffset offset);
+
+	/// Number of tokens added so far, also before the stream is complete.
+	uint32_t count_tokens() const;
+
+	/// Records that the next token added begins the source segment containing the given offset, and any empty ones before it.
+	void enter_source_segment(SourceOffset offset);
+
+	/// Moves the full current segment aside and starts a new one sized relative to the number of tokens so far.
+	void start_segment();
+
+	/// Copies all segments into a single contiguous segment, if there is more than one.
+	void join_segments();
+
+	/// Joins all segments and releases unused capacity if it is a considerable amount.
+	void shrink();
+
+	/// Records that the token at the given close index closes the opening bracket at the given open index.
+	void set_closing_bracket(uint32_t open_index, uint32_t close_index);
+
+	/// Shrinks the storage and extends the closing brackets to every token. Must be called when the stream is complete, as the
+	/// public interface only sees the current segment.
+	void finish();
 
-	/// Appends a token to the stream.
-	void add_token(TokenKind kind, SourceOffset offset);
+	/// Bytes currently allocated across all segments.
+	size_t count_reserved_bytes() const;
 
 	friend class Lexer;
+	friend class TokenStreamBinaryView;
+	friend void write_binary_token_stream(BinaryWriter& writer, const TokenStream& stream);
 };
 
 } // namespace cero
@@ -0,0 +1,104 @@
+#include "TokenStreamBinary.hpp"
+
+#include <algorithm>
+
+namespace cero {
+
+void write_binary_token_stream(BinaryWriter& writer, const TokenStream& stream) {
+	TokenStreamBinaryHeader header;
+	header.has_unbalanced_brackets = stream.has_unbalanced_brackets();
+	writer.write(header);
+	writer.write_aligned_span(stream.raw());
+	writer.write_aligned_span(stream.raw_lengths());
+	writer.write_aligned_span(stream.raw_closing_brackets());
+	writer.write_aligned_span(stream.raw_trivia());
+	writer.write_aligned_span(std::span(stream.error_offsets_));
+	writer.write_aligned_span(stream.raw_source_segment_starts());
+}
+
+std::optional<TokenStreamBinaryView> TokenStreamBinaryView::from(BinaryReader& reader) {
+	TokenStreamBinaryHeader header;
+	if (!reader.read(header) || header.magic != TokenStreamBinaryHeader::Magic
+		|| header.format_version != TokenStreamBinaryHeader::FormatVersion || header.has_unbalanced_brackets > 1) {
+		return std::nullopt;
+	}
+
+	TokenStreamBinaryView view;
+	view.has_unbalanced_brackets_ = header.has_unbalanced_brackets == 1;
+	if (!reader.view_span(view.tokens_) || !reader.view_span(view.lengths_) || !reader.view_span(view.closing_brackets_)
+		|| !reader.view_span(view.trivia_) || !reader.view_span(view.error_offsets_)
+		|| !reader.view_span(view.source_segment_starts_)) {
+		return std::nullopt;
+	}
+
+	// cursors rely on the stream ending with exactly one end-of-file token and on indices staying within the stream
+	const auto tokens = view.tokens_;
+	if (tokens.empty() || tokens.size() >= UINT32_MAX || view.lengths_.size() != tokens.size()
+		|| view.closing_brackets_.size() != tokens.size() || tokens.back().kind != TokenKind::EndOfFile) {
+		return std::nullopt;
+	}
+
+	// a closing token lies between its opening bracket and the end-of-file token
+	const auto num_tokens = static_cast<uint32_t>(tokens.size());
+	for (uint32_t i = 0; i != num_tokens; ++i) {
+		const auto kind = tokens[i].kind;
+		const uint32_t close = view.closing_brackets_[i];
+		// the kind is a signed bit-field, so it is compared as the byte it is stored in
+		if (static_cast<uint8_t>(kind) > static_cast<uint8_t>(TokenKind::EndOfFile)
+			|| (kind == TokenKind::EndOfFile && i != num_tokens - 1)) {
+			return std::nullopt;
+		}
+		if (close != BracketPair::Unclosed && (!is_opening_bracket(kind) || close <= i || close >= num_tokens - 1)) {
+			return std::nullopt;
+		}
+	}
+	for (auto& trivia : view.trivia_) {
+		if (trivia.next_token >= num_tokens) {
+			return std::nullopt;
+		}
+	}
+	const auto segment_starts = view.source_segment_starts_;
+	if (!std::ranges::is_sorted(segment_starts) || (!segment_starts.empty() && segment_starts.back() > num_tokens)) {
+		return std::nullopt;
+	}
+	return view;
+}
+
+uint32_t TokenStreamBinaryView::num_tokens() const {
+	return static_cast<uint32_t>(tokens_.size());
+}
+
+bool TokenStreamBinaryView::has_errors() const {
+	return !error_offsets_.empty();
+}
+
+std::span<const Token> TokenStreamBinaryView::raw() const {
+	return tokens_;
+}
+
+std::span<const uint32_t> TokenStreamBinaryView::raw_lengths() const {
+	return lengths_;
+}
+
+std::span<const uint32_t> TokenStreamBinaryView::raw_closing_brackets() const {
+	return closing_brackets_;
+}
+
+std::span<const Trivia> TokenStreamBinaryView::raw_trivia() const {
+	return trivia_;
+}
+
+TokenStream TokenStreamBinaryView::to_token_stream() const {
+	TokenStream stream(0);
+	stream.stream_.assign(tokens_.begin(), tokens_.end());
+	stream.lengths_.assign(lengths_.begin(), lengths_.end());
+	stream.closing_brackets_.assign(closing_brackets_.begin(), closing_brackets_.end());
+	stream.trivia_.assign(trivia_.begin(), trivia_.end());
+	stream.error_offsets_.assign(error_offsets_.begin(), error_offsets_.end());
+	stream.source_segment_starts_.assign(source_segment_starts_.begin(), source_segment_starts_.end());
+	stream.has_unbalanced_brackets_ = has_unbalanced_brackets_;
+	stream.peak_reserved_bytes_ = stream.count_reserved_bytes();
+	return stream;
+}
+
+} // namespace cero
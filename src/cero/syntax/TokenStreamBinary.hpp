@@ -0,0 +1,73 @@
+#pragma once
+
+#include "cero/syntax/TokenStream.hpp"
+#include "cero/util/BinaryStream.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace cero {
+
+/// Leads every token stream in the binary format. The header is followed by the tokens, their lexeme lengths and their
+/// closing brackets in the same layout that a complete TokenStream stores them in, and then by the trivia, the offsets of the
+/// diagnostics and the source segment starts, each written as an aligned span.
+struct TokenStreamBinaryHeader {
+	/// Identifies the format. Also rejects data written with the other byte order, since it is read as a single integer.
+	static constexpr uint32_t Magic = 0x4B544143; // "CATK" in little-endian byte order
+
+	/// Version of the format, which must be incremented whenever the layout or meaning of any part of it changes.
+	static constexpr uint32_t FormatVersion = 1;
+
+	uint32_t magic = Magic;
+	uint32_t format_version = FormatVersion;
+	uint8_t has_unbalanced_brackets = 0;
+	uint8_t reserved[3] = {};
+};
+
+/// Appends the complete token stream in the binary format to the given writer, which only copies its storage.
+void write_binary_token_stream(BinaryWriter& writer, const TokenStream& stream);
+
+/// Gives access to a token stream in the binary format by reading from the bytes in place, so that a token stream can be
+/// loaded by mapping a file, without decoding anything per token. Creating the view validates what cursors rely on: every
+/// token has a known kind, the stream ends with the end-of-file token, and every index refers to a token of the stream.
+class TokenStreamBinaryView {
+public:
+	/// Views the token stream that the reader is at, or returns nothing if the bytes do not hold a token stream in the binary
+	/// format of this version. The bytes must outlive the view.
+	static std::optional<TokenStreamBinaryView> from(BinaryReader& reader);
+
+	/// Number of tokens in the stream.
+	uint32_t num_tokens() const;
+
+	/// Whether syntax errors were encountered during lexing.
+	bool has_errors() const;
+
+	/// Get a view of the tokens, which lie in the bytes that the view was created from.
+	std::span<const Token> raw() const;
+
+	/// Get a view of the lexeme lengths, like TokenStream::raw_lengths.
+	std::span<const uint32_t> raw_lengths() const;
+
+	/// Get a view of the index of the token that closes each token, like TokenStream::raw_closing_brackets.
+	std::span<const uint32_t> raw_closing_brackets() const;
+
+	/// Get a view of the comments that were recorded as trivia, in source order.
+	std::span<const Trivia> raw_trivia() const;
+
+	/// Copies the token stream out of the bytes.
+	TokenStream to_token_stream() const;
+
+private:
+	std::span<const Token> tokens_;
+	std::span<const uint32_t> lengths_;
+	std::span<const uint32_t> closing_brackets_;
+	std::span<const Trivia> trivia_;
+	std::span<const SourceOffset> error_offsets_;
+	std::span<const uint32_t> source_segment_starts_;
+	bool has_unbalanced_brackets_ = false;
+
+	TokenStreamBinaryView() = default;
+};
+
+} // namespace cero
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace cero {
+
+/// Builds up a byte string from values in their in-memory representation or as variable-length integers. Only meant for data
+/// that is read back by the same build of the compiler, since neither byte order nor padding are normalized.
+class BinaryWriter {
+public:
+	/// Most bytes that BinaryWriter::write_varint takes for a single value.
+	static constexpr size_t MaxVarintBytes = 10;
+
+	template<typename T>
+	void write(const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+		if constexpr (sizeof(T) == 1) {
+			bytes_.push_back(std::bit_cast<char>(value));
+		} else {
+			bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+	}
+
+	/// Writes the number of values followed by the values themselves.
+	template<typename T>
+	void write_span(std::span<const T> values) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+		write(static_cast<uint64_t>(values.size()));
+		bytes_.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+	}
+
+	/// Like write_span, but pads the values to their alignment relative to the first byte written, so that they can be viewed
+	/// in place with BinaryReader::view_span when the bytes are read back from storage with at least that alignment.
+	template<typename T>
+	void write_aligned_span(std::span<const T> values) {
+		write(static_cast<uint64_t>(values.size()));
+		bytes_.resize((bytes_.size() + alignof(T) - 1) / alignof(T) * alignof(T), '\0');
+		bytes_.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+	}
+
+	/// Writes the length of the string followed by its characters.
+	void write_string(std::string_view str) {
+		write_span(std::span(str.data(), str.size()));
+	}
+
+	/// Writes an unsigned integer in as few bytes as it needs, seven bits per byte starting with the lowest ones, so that
+	/// small values such as counts and lengths take up a single byte.
+	void write_varint(uint64_t value) {
+		if (value < 0x80) [[likely]] {
+			bytes_.push_back(static_cast<char>(value));
+			return;
+		}
+
+		char buffer[MaxVarintBytes];
+		size_t length = 0;
+		while (value >= 0x80) {
+			buffer[length++] = static_cast<char>(value | 0x80);
+			value >>= 7;
+		}
+		buffer[length++] = static_cast<char>(value);
+		bytes_.append(buffer, length);
+	}
+
+	/// Reserves room for the given number of bytes in total, for when the size of the output can be estimated up front.
+	void reserve(size_t num_bytes) {
+		bytes_.reserve(num_bytes);
+	}
+
+	std::string_view get_bytes() const {
+		return bytes_;
+	}
+
+private:
+	std::string bytes_;
+};
+
+/// Reads back values written by a BinaryWriter. Every read checks that enough bytes are left and returns false otherwise, so
+/// that truncated or otherwise malformed input is rejected instead of read past its end.
+class BinaryReader {
+public:
+	explicit BinaryReader(std::string_view bytes) :
+		bytes_(bytes),
+		begin_(bytes.data()) {
+	}
+
+	template<typename T>
+	bool read(T& value) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+		if (bytes_.size() < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&value, bytes_.data(), sizeof(T));
+		bytes_.remove_prefix(sizeof(T));
+		return true;
+	}
+
+	/// Reads values written by BinaryWriter::write_span.
+	template<typename T>
+	bool read_vector(std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+		uint64_t size;
+		if (!read(size) || size > bytes_.size() / sizeof(T)) {
+			return false;
+		}
+		values.clear();
+		if (size == 0) {
+			// an empty vector may have no storage at all, and memcpy must not be given a null pointer
+			return true;
+		}
+		values.resize(size);
+		std::memcpy(values.data(), bytes_.data(), size * sizeof(T));
+		bytes_.remove_prefix(size * sizeof(T));
+		return true;
+	}
+
+	/// Views values written by BinaryWriter::write_aligned_span in place, without copying them. Fails if the bytes given to the
+	/// reader are not aligned for the values, which storage that was allocated or mapped for the bytes always is.
+	template<typename T>
+	bool view_span(std::span<const T>& values) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+		uint64_t size;
+		if (!read(size)) {
+			return false;
+		}
+		const auto position = static_cast<size_t>(bytes_.data() - begin_);
+		const size_t padding = (alignof(T) - position % alignof(T)) % alignof(T);
+		if (padding > bytes_.size() || size > (bytes_.size() - padding) / sizeof(T)
+			|| reinterpret_cast<uintptr_t>(begin_) % alignof(T) != 0) {
+			return false;
+		}
+		bytes_.remove_prefix(padding);
+		values = {reinterpret_cast<const T*>(bytes_.data()), static_cast<size_t>(size)};
+		bytes_.remove_prefix(size * sizeof(T));
+		return true;
+	}
+
+	/// Reads a string written by BinaryWriter::write_string.
+	bool read_string(std::string& str) {
+		uint64_t size;
+		if (!read(size) || size > bytes_.size()) {
+			return false;
+		}
+		str.assign(bytes_.data(), size);
+		bytes_.remove_prefix(size);
+		return true;
+	}
+
+	/// Reads an integer written by BinaryWriter::write_varint, which must fit into the given type.
+	template<std::unsigned_integral T>
+	bool read_varint(T& value) {
+		if (!bytes_.empty() && static_cast<uint8_t>(bytes_[0]) < 0x80) [[likely]] {
+			value = static_cast<T>(bytes_[0]);
+			bytes_.remove_prefix(1);
+			return true;
+		}
+
+		uint64_t result = 0;
+		for (uint32_t shift = 0; shift < 64 && !bytes_.empty(); shift += 7) {
+			const auto byte = static_cast<uint8_t>(bytes_[0]);
+			bytes_.remove_prefix(1);
+			result |= uint64_t(byte & 0x7f) << shift;
+			if (byte < 0x80) {
+				if (result > std::numeric_limits<T>::max() || (shift == 63 && byte > 1)) {
+					return false;
+				}
+				value = static_cast<T>(result);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// Number of bytes that are left to read.
+	size_t num_remaining_bytes() const {
+		return bytes_.size();
+	}
+
+private:
+	std::string_view bytes_;
+	const char* begin_; // where the bytes given to the reader start, which alignment is relative to
+};
+
+} // namespace cero
@@ -0,0 +1,323 @@
+#include "ContentHash.hpp"
+
+#include "cero/util/Macros.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if CERO_ARCH_X64
+	#include <emmintrin.h>
+#endif
+
+#if CERO_COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
+namespace cero {
+
+// This is a port of the 128-bit variant of XXH3 from xxHash 0.8 with the default secret, so its values can be checked against
+// any other implementation of it. Inputs of up to 240 bytes are mixed in 16-byte pieces with the secret. Longer inputs
+// are consumed in stripes of 64 bytes, each of which is mixed into eight independent 64-bit accumulators with one 32x32-bit
+// multiplication per lane. Since the lanes never depend on each other within a stripe, they are processed two at a time in SSE2
+// registers, which every x64 processor has. The accumulators are scrambled after every block of stripes so that the bits of
+// earlier input spread out, and finally merged twice with different parts of the secret into 128 bits.
+
+constexpr size_t NumLanes = 8;
+constexpr size_t StripeLength = NumLanes * sizeof(uint64_t);
+constexpr size_t SecretConsumeRate = 8;
+constexpr size_t SecretMergeStart = 11;
+constexpr size_t SecretLastStripeStart = 7;
+constexpr size_t MaxMidLength = 240;
+constexpr size_t MinSecretLength = 136;
+
+constexpr uint64_t Prime32_1 = 0x9E3779B1u;
+constexpr uint64_t Prime32_2 = 0x85EBCA77u;
+constexpr uint64_t Prime32_3 = 0xC2B2AE3Du;
+constexpr uint64_t Prime64_1 = 0x9E3779B185EBCA87u;
+constexpr uint64_t Prime64_2 = 0xC2B2AE3D27D4EB4Fu;
+constexpr uint64_t Prime64_3 = 0x165667B19E3779F9u;
+constexpr uint64_t Prime64_4 = 0x85EBCA77C2B2AE63u;
+constexpr uint64_t Prime64_5 = 0x27D4EB2F165667C5u;
+
+alignas(64) constexpr unsigned char SECRET[] {
+	0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9,
+	0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78,
+	0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21, 0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+	0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+	0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8, 0xa8, 0xfa, 0x76, 0x3f,
+	0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+	0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff,
+	0xfa, 0x13, 0x63, 0xeb, 0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+	0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+	0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+constexpr size_t SecretLength = sizeof(SECRET);
+constexpr size_t StripesPerBlock = (SecretLength - StripeLength) / SecretConsumeRate;
+constexpr size_t BlockLength = StripesPerBlock * StripeLength;
+
+static uint64_t swap_bytes(uint64_t value) {
+	value = (value & 0x00ff00ff00ff00ffu) << 8 | (value >> 8 & 0x00ff00ff00ff00ffu);
+	value = (value & 0x0000ffff0000ffffu) << 16 | (value >> 16 & 0x0000ffff0000ffffu);
+	return value << 32 | value >> 32;
+}
+
+static uint64_t read_64(const void* bytes) {
+	uint64_t value;
+	std::memcpy(&value, bytes, sizeof(value));
+	if constexpr (std::endian::native == std::endian::big) {
+		value = swap_bytes(value);
+	}
+	return value;
+}
+
+static void write_64(unsigned char* bytes, uint64_t value) {
+	if constexpr (std::endian::native == std::endian::big) {
+		value = swap_bytes(value);
+	}
+	std::memcpy(bytes, &value, sizeof(value));
+}
+
+static uint32_t read_32(const void* bytes) {
+	uint32_t value;
+	std::memcpy(&value, bytes, sizeof(value));
+	if constexpr (std::endian::native == std::endian::big) {
+		value = static_cast<uint32_t>(swap_bytes(value) >> 32);
+	}
+	return value;
+}
+
+struct Product128 {
+	uint64_t low;
+	uint64_t high;
+};
+
+static Product128 multiply_64_to_128(uint64_t a, uint64_t b) {
+#if CERO_COMPILER_MSVC
+	uint64_t high;
+	const uint64_t low = _umul128(a, b, &high);
+	return Product128 {low, high};
+#else
+	__extension__ using uint128_t = unsigned __int128;
+	const auto product = static_cast<uint128_t>(a) * b;
+	return Product128 {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#endif
+}
+
+static uint64_t multiply_fold(uint64_t a, uint64_t b) {
+	const auto product = multiply_64_to_128(a, b);
+	return product.low ^ product.high;
+}
+
+static uint64_t avalanche(uint64_t value) {
+	value ^= value >> 37;
+	value *= 0x165667919E3779F9u;
+	return value ^ (value >> 32);
+}
+
+static uint64_t avalanche_xxh64(uint64_t value) {
+	value ^= value >> 33;
+	value *= Prime64_2;
+	value ^= value >> 29;
+	value *= Prime64_3;
+	return value ^ (value >> 32);
+}
+
+static ContentHash hash_up_to_3(const char* data, size_t length, uint64_t seed) {
+	const auto c1 = static_cast<uint8_t>(data[0]);
+	const auto c2 = static_cast<uint8_t>(data[length >> 1]);
+	const auto c3 = static_cast<uint8_t>(data[length - 1]);
+	const uint32_t combined_low = uint32_t(c1) << 16 | uint32_t(c2) << 24 | uint32_t(c3) | static_cast<uint32_t>(length) << 8;
+	const uint32_t combined_high = std::rotl(static_cast<uint32_t>(swap_bytes(combined_low) >> 32), 13);
+
+	const uint64_t flip_low = (read_32(SECRET) ^ read_32(SECRET + 4)) + seed;
+	const uint64_t flip_high = (read_32(SECRET + 8) ^ read_32(SECRET + 12)) - seed;
+	return ContentHash {avalanche_xxh64(combined_low ^ flip_low), avalanche_xxh64(combined_high ^ flip_high)};
+}
+
+static ContentHash hash_4_to_8(const char* data, size_t length, uint64_t seed) {
+	seed ^= swap_bytes(seed << 32) << 32; // mirrors the bytes of the low half into the high half
+	const uint64_t input = read_32(data) + (uint64_t(read_32(data + length - 4)) << 32);
+	const uint64_t flip = (read_64(SECRET + 16) ^ read_64(SECRET + 24)) + seed;
+
+	auto [low, high] = multiply_64_to_128(input ^ flip, Prime64_1 + (length << 2));
+	high += low << 1;
+	low ^= high >> 3;
+
+	low ^= low >> 35;
+	low *= 0x9FB21C651E98DF25u;
+	low ^= low >> 28;
+	return ContentHash {low, avalanche(high)};
+}
+
+static ContentHash hash_9_to_16(const char* data, size_t length, uint64_t seed) {
+	const uint64_t flip_low = (read_64(SECRET + 32) ^ read_64(SECRET + 40)) - seed;
+	const uint64_t flip_high = (read_64(SECRET + 48) ^ read_64(SECRET + 56)) + seed;
+	const uint64_t input_low = read_64(data);
+	const uint64_t input_high = read_64(data + length - 8);
+
+	auto [mul_low, mul_high] = multiply_64_to_128(input_low ^ input_high ^ flip_low, Prime64_1);
+	const uint64_t flipped_high = input_high ^ flip_high;
+	mul_low += uint64_t(length - 1) << 54;
+	mul_high += flipped_high + (flipped_high & 0xffffffffu) * (Prime32_2 - 1);
+	mul_low ^= swap_bytes(mul_high);
+
+	auto [result_low, result_high] = multiply_64_to_128(mul_low, Prime64_2);
+	result_high += mul_high * Prime64_2;
+	return ContentHash {avalanche(result_low), avalanche(result_high)};
+}
+
+static uint64_t mix_16(const char* data, const unsigned char* secret, uint64_t seed) {
+	return multiply_fold(read_64(data) ^ (read_64(secret) + seed), read_64(data + 8) ^ (read_64(secret + 8) - seed));
+}
+
+/// Mixes two 16-byte pieces of the input into the two halves of the hash.
+static void mix_32(ContentHash& hash, const char* first, const char* second, const unsigned char* secret, uint64_t seed) {
+	hash.low += mix_16(first, secret, seed);
+	hash.low ^= read_64(second) + read_64(second + 8);
+	hash.high += mix_16(second, secret + 16, seed);
+	hash.high ^= read_64(first) + read_64(first + 8);
+}
+
+static ContentHash finish_mid(ContentHash hash, size_t length, uint64_t seed) {
+	const uint64_t low = hash.low + hash.high;
+	const uint64_t high = hash.low * Prime64_1 + hash.high * Prime64_4 + (length - seed) * Prime64_2;
+	return ContentHash {avalanche(low), 0 - avalanche(high)};
+}
+
+static ContentHash hash_17_to_128(const char* data, size_t length, uint64_t seed) {
+	ContentHash hash {length * Prime64_1, 0};
+	if (length > 32) {
+		if (length > 64) {
+			if (length > 96) {
+				mix_32(hash, data + 48, data + length - 64, SECRET + 96, seed);
+			}
+			mix_32(hash, data + 32, data + length - 48, SECRET + 64, seed);
+		}
+		mix_32(hash, data + 16, data + length - 32, SECRET + 32, seed);
+	}
+	mix_32(hash, data, data + length - 16, SECRET, seed);
+	return finish_mid(hash, length, seed);
+}
+
+static ContentHash hash_129_to_240(const char* data, size_t length, uint64_t seed) {
+	ContentHash hash {length * Prime64_1, 0};
+	const size_t num_rounds = length / 32;
+	for (size_t i = 0; i != 4; ++i) {
+		mix_32(hash, data + 32 * i, data + 32 * i + 16, SECRET + 32 * i, seed);
+	}
+	hash.low = avalanche(hash.low);
+	hash.high = avalanche(hash.high);
+
+	for (size_t i = 4; i != num_rounds; ++i) {
+		mix_32(hash, data + 32 * i, data + 32 * i + 16, SECRET + 3 + 32 * (i - 4), seed);
+	}
+	mix_32(hash, data + length - 16, data + length - 32, SECRET + MinSecretLength - 17 - 16, 0 - seed);
+	return finish_mid(hash, length, seed);
+}
+
+using Accumulators = uint64_t[NumLanes];
+
+static void accumulate_stripe(Accumulators& acc, const char* stripe, const unsigned char* secret) {
+#if CERO_ARCH_X64
+	for (size_t i = 0; i != NumLanes; i += 2) {
+		const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe + i * sizeof(uint64_t)));
+		const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + i * sizeof(uint64_t)));
+		const __m128i keyed = _mm_xor_si128(values, keys);
+		const __m128i products = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+		const __m128i swapped = _mm_shuffle_epi32(values, _MM_SHUFFLE(1, 0, 3, 2));
+
+		auto lanes = reinterpret_cast<__m128i*>(acc + i);
+		_mm_storeu_si128(lanes, _mm_add_epi64(_mm_loadu_si128(lanes), _mm_add_epi64(products, swapped)));
+	}
+#else
+	for (size_t i = 0; i != NumLanes; ++i) {
+		const uint64_t value = read_64(stripe + i * sizeof(uint64_t));
+		const uint64_t keyed = value ^ read_64(secret + i * sizeof(uint64_t));
+		acc[i ^ 1] += value; // adding the plain value to the neighboring lane keeps it from being lost if the product is zero
+		acc[i] += (keyed & 0xffffffffu) * (keyed >> 32);
+	}
+#endif
+}
+
+static void scramble(Accumulators& acc, const unsigned char* secret) {
+	for (size_t i = 0; i != NumLanes; ++i) {
+		uint64_t lane = acc[i];
+		lane ^= lane >> 47;
+		lane ^= read_64(secret + i * sizeof(uint64_t));
+		acc[i] = lane * Prime32_1;
+	}
+}
+
+static uint64_t merge(const Accumulators& acc, const unsigned char* secret, uint64_t start) {
+	uint64_t result = start;
+	for (size_t i = 0; i != NumLanes; i += 2) {
+		result += multiply_fold(acc[i] ^ read_64(secret + i * 8), acc[i + 1] ^ read_64(secret + i * 8 + 8));
+	}
+	return avalanche(result);
+}
+
+static ContentHash hash_long(const char* data, size_t length, const unsigned char* secret) {
+	Accumulators acc {Prime32_3, Prime64_1, Prime64_2, Prime64_3, Prime64_4, Prime32_2, Prime64_5, Prime32_1};
+
+	// the last stripe is always consumed on its own, even if it overlaps the stripes before it
+	const size_t num_blocks = (length - 1) / BlockLength;
+	for (size_t block = 0; block != num_blocks; ++block) {
+		for (size_t stripe = 0; stripe != StripesPerBlock; ++stripe) {
+			accumulate_stripe(acc, data + block * BlockLength + stripe * StripeLength, secret + stripe * SecretConsumeRate);
+		}
+		scramble(acc, secret + SecretLength - StripeLength);
+	}
+
+	const size_t num_stripes = (length - 1 - num_blocks * BlockLength) / StripeLength;
+	for (size_t stripe = 0; stripe != num_stripes; ++stripe) {
+		accumulate_stripe(acc, data + num_blocks * BlockLength + stripe * StripeLength, secret + stripe * SecretConsumeRate);
+	}
+	accumulate_stripe(acc, data + length - StripeLength, secret + SecretLength - StripeLength - SecretLastStripeStart);
+
+	const uint64_t low = merge(acc, secret + SecretMergeStart, length * Prime64_1);
+	const uint64_t high = merge(acc, secret + SecretLength - sizeof(Accumulators) - SecretMergeStart, ~(length * Prime64_2));
+	return ContentHash {low, high};
+}
+
+ContentHash ContentHash::of(std::string_view bytes, uint64_t seed) {
+	const char* data = bytes.data();
+	const size_t length = bytes.length();
+	if (length == 0) {
+		const uint64_t flip_low = read_64(SECRET + 64) ^ read_64(SECRET + 72);
+		const uint64_t flip_high = read_64(SECRET + 80) ^ read_64(SECRET + 88);
+		return ContentHash {avalanche_xxh64(seed ^ flip_low), avalanche_xxh64(seed ^ flip_high)};
+	}
+	if (length <= 3) {
+		return hash_up_to_3(data, length, seed);
+	}
+	if (length <= 8) {
+		return hash_4_to_8(data, length, seed);
+	}
+	if (length <= 16) {
+		return hash_9_to_16(data, length, seed);
+	}
+	if (length <= 128) {
+		return hash_17_to_128(data, length, seed);
+	}
+	if (length <= MaxMidLength) {
+		return hash_129_to_240(data, length, seed);
+	}
+	if (seed == 0) {
+		return hash_long(data, length, SECRET);
+	}
+
+	// long inputs take the seed into account through a secret that is derived from it
+	alignas(64) unsigned char seeded_secret[SecretLength];
+	for (size_t i = 0; i != SecretLength; i += 16) {
+		write_64(seeded_secret + i, read_64(SECRET + i) + seed);
+		write_64(seeded_secret + i + 8, read_64(SECRET + i + 8) - seed);
+	}
+	return hash_long(data, length, seeded_secret);
+}
+
+std::string ContentHash::to_string() const {
+	return fmt::format("{:016x}{:016x}", high, low);
+}
+
+} // namespace cero
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace cero {
+
+/// 128-bit fingerprint of a byte string, for recognizing contents that were seen before without comparing them byte by byte.
+/// It is the 128-bit variant of XXH3, which is not cryptographic, so it only guards against accidental collisions. The value is
+/// the same on every platform, so it can be persisted.
+struct ContentHash {
+	uint64_t low = 0;
+	uint64_t high = 0;
+
+	/// Computes the fingerprint of the given bytes. Fingerprints with different seeds are independent of each other, so one with
+	/// another seed can tell apart contents whose fingerprints collide.
+	static ContentHash of(std::string_view bytes, uint64_t seed = 0);
+
+	/// Creates a string of 32 hexadecimal digits, such as for file names.
+	std::string to_string() const;
+
+	bool operator==(const ContentHash&) const = default;
+};
+
+} // namespace cero
@@ -3,14 +3,22 @@
 #include "cero/util/Result.hpp"
 #include "cero/util/UniqueImpl.hpp"
 
+#include <memory>
 #include <string_view>
 #include <system_error>
+#include <vector>
 
 namespace cero {
 
+/// Gives access to the contents of a file. Files of at least the given mapping threshold are memory-mapped, while smaller ones
+/// are read into a pooled buffer, since for them mapping and unmapping costs more than copying the contents.
 class FileMapping {
 public:
-	static Result<FileMapping, std::error_condition> from(std::string_view path);
+	static Result<FileMapping, std::error_condition> from(std::string_view path, size_t mmap_threshold);
+
+	/// Takes over a buffer from the ReadBufferPool that the entire contents of a file were read into by other means, such as
+	/// by a SourceLoader. The buffer is returned to the pool once the instance is destroyed.
+	static FileMapping from_read_buffer(std::unique_ptr<std::vector<char>> buffer);
 
 	std::string_view get_text() const;
 	size_t get_size() const;
@@ -20,7 +28,7 @@ public:
 	FileMapping& operator=(FileMapping&&) noexcept;
 
 private:
-	UniqueImpl<struct FileMappingImpl, 32> impl_;
+	UniqueImpl<struct FileMappingImpl, 40> impl_;
 
 	FileMapping();
 };
@@ -1,6 +1,7 @@
 #include "FileMapping.hpp"
 
 #include "cero/util/Fail.hpp"
+#include "cero/util/ReadBufferPool.hpp"
 #include "cero/util/SystemError.hpp"
 
 #include <fcntl.h>
@@ -14,8 +15,12 @@ struct FileMappingImpl {
 	int fd = -1;
 	size_t size = 0;
 	void* addr = MAP_FAILED;
+	std::vector<char>* buffer = nullptr; // holds the contents instead of a mapping if the file was read
 
 	void destroy() const {
+		if (buffer != nullptr) {
+			ReadBufferPool::release(std::unique_ptr<std::vector<char>>(buffer));
+		}
 		if (addr != MAP_FAILED) {
 			int ret = ::munmap(addr, size);
 			check(ret != -1, fmt::format("could not unmap file, system error: {}", get_last_system_error().message()));
@@ -25,9 +30,51 @@ struct FileMappingImpl {
 			check(ret != -1, fmt::format("could not close file, system error: {}", get_last_system_error().message()));
 		}
 	}
+
+	/// Reads the entire file into a pooled buffer and closes the file, since it is not needed after that.
+	std::error_condition read() {
+		auto pooled = ReadBufferPool::acquire(size);
+		size_t num_read = 0;
+		while (num_read < size) {
+			const auto ret = ::pread(fd, pooled->data() + num_read, size - num_read, static_cast<off_t>(num_read));
+			if (ret == -1) {
+				if (errno == EINTR) {
+					continue;
+				}
+				ReadBufferPool::release(std::move(pooled));
+				return get_last_system_error();
+			}
+			if (ret == 0) {
+				break; // the file was truncated since its size was determined
+			}
+			num_read += static_cast<size_t>(ret);
+		}
+		size = num_read;
+		buffer = pooled.release();
+
+		int ret = ::close(std::exchange(fd, -1));
+		check(ret != -1, fmt::format("could not close file, system error: {}", get_last_system_error().message()));
+		return {};
+	}
+
+	/// Maps the entire file, populating the page tables up front so that reading it does not fault on every page.
+	std::error_condition map() {
+		int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+		flags |= MAP_POPULATE;
+#endif
+		addr = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+		if (addr == MAP_FAILED) {
+			return get_last_system_error();
+		}
+
+		// the contents are read front to back, so pages behind the reader can be reclaimed early; failing to hint that is harmless
+		::madvise(addr, size, MADV_SEQUENTIAL);
+		return {};
+	}
 };
 
-Result<FileMapping, std::error_condition> FileMapping::from(std::string_view path) {
+Result<FileMapping, std::error_condition> FileMapping::from(std::string_view path, size_t mmap_threshold) {
 	std::string path_nt(path);
 
 	FileMapping f;
@@ -43,19 +90,32 @@ Result<FileMapping, std::error_condition> FileMapping::from(std::string_view pat
 	}
 	f.impl_->size = static_cast<size_t>(file_stats.st_size);
 
-	if (f.impl_->size > 0) {
-		f.impl_->addr = ::mmap(nullptr, f.impl_->size, PROT_READ, MAP_PRIVATE, f.impl_->fd, 0);
-		if (f.impl_->addr == MAP_FAILED) {
-			return get_last_system_error();
+	// anything but a regular file is left to mmap to accept or reject
+	if (f.impl_->size < mmap_threshold && S_ISREG(file_stats.st_mode)) {
+		if (auto error = f.impl_->read()) {
+			return error;
+		}
+	} else if (f.impl_->size > 0) {
+		if (auto error = f.impl_->map()) {
+			return error;
 		}
 	}
 
 	return f;
 }
 
+FileMapping FileMapping::from_read_buffer(std::unique_ptr<std::vector<char>> buffer) {
+	FileMapping f;
+	f.impl_->size = buffer->size();
+	f.impl_->buffer = buffer.release();
+	return f;
+}
+
 std::string_view FileMapping::get_text() const {
 	if (impl_->size == 0) {
 		return "";
+	} else if (impl_->buffer != nullptr) {
+		return std::string_view(impl_->buffer->data(), impl_->size);
 	} else {
 		return std::string_view(static_cast<const char*>(impl_->addr), impl_->size);
 	}
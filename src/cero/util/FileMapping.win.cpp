@@ -1,6 +1,7 @@
 #include "FileMapping.hpp"
 
 #include "cero/util/Fail.hpp"
+#include "cero/util/ReadBufferPool.hpp"
 #include "cero/util/SystemError.hpp"
 #include "cero/util/WinApi.win.hpp"
 #include "cero/util/WinUtil.win.hpp"
@@ -12,8 +13,12 @@ struct FileMappingImpl {
 	size_t size = 0;
 	HANDLE mapping = INVALID_HANDLE_VALUE;
 	LPVOID addr = nullptr;
+	std::vector<char>* buffer = nullptr; // holds the contents instead of a mapping if the file was read
 
 	void destroy() const {
+		if (buffer != nullptr) {
+			ReadBufferPool::release(std::unique_ptr<std::vector<char>>(buffer));
+		}
 		if (addr != nullptr) {
 			BOOL success = ::UnmapViewOfFile(addr);
 			check(success, fmt::format("could not unmap file, system error: {}", get_last_system_error().message()));
@@ -28,9 +33,48 @@ struct FileMappingImpl {
 			check(success, fmt::format("could not close file handle, system error: {}", get_last_system_error().message()));
 		}
 	}
+
+	/// Reads the entire file into a pooled buffer and closes the file, since it is not needed after that.
+	std::error_condition read() {
+		auto pooled = ReadBufferPool::acquire(size);
+		size_t num_read = 0;
+		while (num_read < size) {
+			DWORD chunk_read = 0;
+			const auto chunk = static_cast<DWORD>(std::min<size_t>(size - num_read, MAXDWORD));
+			if (!::ReadFile(file, pooled->data() + num_read, chunk, &chunk_read, nullptr)) {
+				ReadBufferPool::release(std::move(pooled));
+				return get_last_system_error();
+			}
+			if (chunk_read == 0) {
+				break; // the file was truncated since its size was determined
+			}
+			num_read += chunk_read;
+		}
+		size = num_read;
+		buffer = pooled.release();
+
+		BOOL success = ::CloseHandle(std::exchange(file, INVALID_HANDLE_VALUE));
+		check(success, fmt::format("could not close file handle, system error: {}", get_last_system_error().message()));
+		return {};
+	}
+
+	/// Maps a view of the entire file.
+	std::error_condition map() {
+		HANDLE new_mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (new_mapping == nullptr) {
+			return get_last_system_error();
+		}
+		mapping = new_mapping;
+
+		addr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (addr == nullptr) {
+			return get_last_system_error();
+		}
+		return {};
+	}
 };
 
-Result<FileMapping, std::error_condition> FileMapping::from(std::string_view path) {
+Result<FileMapping, std::error_condition> FileMapping::from(std::string_view path, size_t mmap_threshold) {
 	auto path_utf16 = windows::utf8_to_utf16(path);
 
 	FileMapping f;
@@ -47,25 +91,31 @@ Result<FileMapping, std::error_condition> FileMapping::from(std::string_view pat
 	}
 	f.impl_->size = static_cast<size_t>(file_size.QuadPart);
 
-	if (f.impl_->size > 0) {
-		HANDLE mapping = ::CreateFileMappingW(f.impl_->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
-		if (mapping == nullptr) {
-			return get_last_system_error();
+	if (f.impl_->size < mmap_threshold) {
+		if (auto error = f.impl_->read()) {
+			return error;
 		}
-		f.impl_->mapping = mapping;
-
-		f.impl_->addr = ::MapViewOfFile(f.impl_->mapping, FILE_MAP_READ, 0, 0, 0);
-		if (f.impl_->addr == nullptr) {
-			return get_last_system_error();
+	} else if (f.impl_->size > 0) {
+		if (auto error = f.impl_->map()) {
+			return error;
 		}
 	}
 
 	return f;
 }
 
+FileMapping FileMapping::from_read_buffer(std::unique_ptr<std::vector<char>> buffer) {
+	FileMapping f;
+	f.impl_->size = buffer->size();
+	f.impl_->buffer = buffer.release();
+	return f;
+}
+
 std::string_view FileMapping::get_text() const {
 	if (impl_->size == 0) {
 		return "";
+	} else if (impl_->buffer != nullptr) {
+		return std::string_view(impl_->buffer->data(), impl_->size);
 	} else {
 		return std::string_view(static_cast<const char*>(impl_->addr), impl_->size);
 	}
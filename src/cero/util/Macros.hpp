@@ -8,6 +8,10 @@
 	#define CERO_COMPILER_GCC __GNUC__
 #endif
 
+#if __x86_64__ || _M_X64
+	#define CERO_ARCH_X64 1
+#endif
+
 #if CERO_COMPILER_CLANG
 	#define CERO_DEBUG_BREAK() __builtin_debugtrap()
 #elif CERO_COMPILER_MSVC
@@ -0,0 +1,33 @@
+#include "ReadBufferPool.hpp"
+
+#include <mutex>
+
+namespace cero {
+
+static std::mutex pool_mutex;
+static std::vector<std::unique_ptr<std::vector<char>>> pooled_buffers;
+
+std::unique_ptr<std::vector<char>> ReadBufferPool::acquire(size_t size) {
+	std::unique_ptr<std::vector<char>> buffer;
+	{
+		std::lock_guard lock(pool_mutex);
+		if (!pooled_buffers.empty()) {
+			buffer = std::move(pooled_buffers.back());
+			pooled_buffers.pop_back();
+		}
+	}
+	if (buffer == nullptr) {
+		buffer = std::make_unique<std::vector<char>>();
+	}
+	buffer->resize(size);
+	return buffer;
+}
+
+void ReadBufferPool::release(std::unique_ptr<std::vector<char>> buffer) {
+	std::lock_guard lock(pool_mutex);
+	if (pooled_buffers.size() < MaxPooledBuffers) {
+		pooled_buffers.emplace_back(std::move(buffer));
+	}
+}
+
+} // namespace cero
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace cero {
+
+/// Hands out buffers to read small files into and takes them back once they are no longer needed, so that reading many small
+/// files reuses a few allocations instead of making one per file. There is a single pool behind a mutex, shared by all threads,
+/// since files are often read on one thread and released on another.
+class ReadBufferPool {
+public:
+	/// Most buffers that are kept for reuse. Buffers released beyond that are freed.
+	static constexpr size_t MaxPooledBuffers = 16;
+
+	/// Returns a buffer that is resized to the given number of bytes. Safe to call from multiple threads.
+	static std::unique_ptr<std::vector<char>> acquire(size_t size);
+
+	/// Returns a buffer to the pool. Safe to call from multiple threads.
+	static void release(std::unique_ptr<std::vector<char>> buffer);
+};
+
+} // namespace cero
@@ -0,0 +1,113 @@
+#include "ThreadPool.hpp"
+
+#include <exception>
+
+namespace cero {
+
+struct ThreadPool::Batch {
+	FunctionRef<void(uint32_t)> task;
+	uint32_t num_tasks = 0;
+	std::atomic<uint32_t> next_index = 0;
+	std::mutex exception_mutex {};
+	std::exception_ptr exception = nullptr;
+};
+
+ThreadPool::ThreadPool(uint32_t num_threads) {
+	const uint32_t num_workers = num_threads > 1 ? num_threads - 1 : 0;
+	workers_.reserve(num_workers);
+	for (uint32_t i = 0; i != num_workers; ++i) {
+		workers_.emplace_back(&ThreadPool::run_worker, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock(mutex_);
+		stopping_ = true;
+	}
+	batch_posted_.notify_all();
+
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+
+uint32_t ThreadPool::num_threads() const {
+	return static_cast<uint32_t>(workers_.size()) + 1;
+}
+
+void ThreadPool::for_each_index(uint32_t num_tasks, FunctionRef<void(uint32_t index)> task) {
+	std::lock_guard batch_lock(batch_mutex_);
+
+	Batch batch {task, num_tasks};
+	{
+		std::lock_guard lock(mutex_);
+		batch_ = &batch;
+		++generation_;
+	}
+	batch_posted_.notify_all();
+
+	work_on(batch);
+
+	// the batch lives on this stack frame, so wait until no worker can touch it anymore
+	{
+		std::unique_lock lock(mutex_);
+		batch_ = nullptr;
+		worker_finished_.wait(lock, [&] {
+			return num_busy_workers_ == 0;
+		});
+	}
+
+	// no thread touches the batch anymore, so its exception can be read without locking
+	if (batch.exception) {
+		std::rethrow_exception(batch.exception);
+	}
+}
+
+void ThreadPool::run_worker() {
+	uint64_t seen_generation = 0;
+
+	std::unique_lock lock(mutex_);
+	while (true) {
+		batch_posted_.wait(lock, [&] {
+			return stopping_ || generation_ != seen_generation;
+		});
+		if (stopping_) {
+			return;
+		}
+
+		seen_generation = generation_;
+		if (batch_ == nullptr) {
+			continue; // the batch was already completed by other threads
+		}
+
+		auto& batch = *batch_;
+		++num_busy_workers_;
+		lock.unlock();
+
+		work_on(batch);
+
+		lock.lock();
+		--num_busy_workers_;
+		worker_finished_.notify_all();
+	}
+}
+
+void ThreadPool::work_on(Batch& batch) {
+	try {
+		uint32_t index;
+		while ((index = batch.next_index.fetch_add(1, std::memory_order_relaxed)) < batch.num_tasks) {
+			batch.task(index);
+		}
+	} catch (...) {
+		// keep the first exception and stop handing out indices, since the batch has failed either way
+		batch.next_index.store(batch.num_tasks, std::memory_order_relaxed);
+
+		std::lock_guard lock(batch.exception_mutex);
+		if (!batch.exception) {
+			batch.exception = std::current_exception();
+		}
+	}
+}
+
+} // namespace cero
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "cero/util/FunctionRef.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cero {
+
+/// Fixed set of worker threads that cooperatively run batches of indexed tasks. The thread that submits a batch also works on
+/// it, so a pool with N threads owns N - 1 worker threads.
+class ThreadPool {
+public:
+	/// Creates a pool that runs batches on the given total number of threads, including the submitting thread.
+	explicit ThreadPool(uint32_t num_threads = std::max(std::thread::hardware_concurrency(), 1u));
+
+	/// Stops and joins all worker threads.
+	~ThreadPool();
+
+	/// Number of threads that batches run on, including the submitting thread.
+	uint32_t num_threads() const;
+
+	/// Invokes the task once for every index from zero up to the given number of tasks, spread across all threads of the pool.
+	/// Blocks until every invocation has completed. The order in which indices are processed is unspecified. Batches submitted
+	/// concurrently from multiple threads are run one after another. If an invocation throws, no further indices are handed
+	/// out, and the first exception is rethrown on the submitting thread once the invocations that already started are done.
+	void for_each_index(uint32_t num_tasks, FunctionRef<void(uint32_t index)> task);
+
+	ThreadPool(ThreadPool&&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+private:
+	struct Batch;
+
+	std::vector<std::thread> workers_;
+	std::mutex batch_mutex_;
+	std::mutex mutex_;
+	std::condition_variable batch_posted_;
+	std::condition_variable worker_finished_;
+	Batch* batch_ = nullptr;
+	uint64_t generation_ = 0;
+	uint32_t num_busy_workers_ = 0;
+	bool stopping_ = false;
+
+	void run_worker();
+
+	static void work_on(Batch& batch);
+};
+
+} // namespace cero
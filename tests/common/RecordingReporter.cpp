@@ -0,0 +1,9 @@
+#include "RecordingReporter.hpp"
+
+namespace tests {
+
+void RecordingReporter::handle_report(cero::MessageLevel, cero::CodeLocation location, std::string message_text) {
+	reports.emplace_back(location, std::move(message_text));
+}
+
+} // namespace tests
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cero/io/CodeLocation.hpp>
+#include <cero/io/Reporter.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tests {
+
+/// A test utility that keeps every report in the order it arrived, so that the reports of different ways to process the same
+/// source can be compared.
+class RecordingReporter : public cero::Reporter {
+public:
+	std::vector<std::pair<cero::CodeLocation, std::string>> reports;
+
+private:
+	void handle_report(cero::MessageLevel message_level, cero::CodeLocation location, std::string message_text) override;
+};
+
+} // namespace tests
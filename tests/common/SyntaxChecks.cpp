@@ -0,0 +1,57 @@
+#include "SyntaxChecks.hpp"
+
+#include <doctest/doctest.h>
+
+namespace tests {
+
+void check_same_tokens(const cero::TokenStream& expected, const cero::TokenStream& actual) {
+	auto expected_tokens = expected.raw();
+	auto actual_tokens = actual.raw();
+	REQUIRE_EQ(expected_tokens.size(), actual_tokens.size());
+	for (size_t i = 0; i != expected_tokens.size(); ++i) {
+		CHECK_EQ(expected_tokens[i].kind, actual_tokens[i].kind);
+		CHECK_EQ(expected_tokens[i].offset, actual_tokens[i].offset);
+	}
+	auto expected_trivia = expected.raw_trivia();
+	auto actual_trivia = actual.raw_trivia();
+	REQUIRE_EQ(expected_trivia.size(), actual_trivia.size());
+	for (size_t i = 0; i != expected_trivia.size(); ++i) {
+		CHECK_EQ(expected_trivia[i].offset, actual_trivia[i].offset);
+		CHECK_EQ(expected_trivia[i].length, actual_trivia[i].length);
+		CHECK_EQ(expected_trivia[i].next_token, actual_trivia[i].next_token);
+	}
+	auto expected_closing = expected.raw_closing_brackets();
+	auto actual_closing = actual.raw_closing_brackets();
+	REQUIRE_EQ(expected_closing.size(), actual_closing.size());
+	for (size_t i = 0; i != expected_closing.size(); ++i) {
+		CHECK_EQ(expected_closing[i], actual_closing[i]);
+	}
+	CHECK_EQ(expected.has_unbalanced_brackets(), actual.has_unbalanced_brackets());
+	CHECK_EQ(expected.has_errors(), actual.has_errors());
+}
+
+void check_same_nodes(std::span<const cero::AstNode> expected, std::span<const cero::AstNode> actual) {
+	REQUIRE_EQ(expected.size(), actual.size());
+	for (size_t i = 0; i != expected.size(); ++i) {
+		CHECK_EQ(expected[i].get_kind(), actual[i].get_kind());
+		CHECK_EQ(expected[i].get_offset(), actual[i].get_offset());
+		CHECK_EQ(expected[i].num_children(), actual[i].num_children());
+	}
+}
+
+void check_same_ast(const cero::Ast& expected, const cero::Ast& actual, const cero::SourceGuard& source) {
+	check_same_nodes(expected.raw(), actual.raw());
+	CHECK_EQ(expected.to_string(source), actual.to_string(source));
+	CHECK_EQ(expected.has_errors(), actual.has_errors());
+}
+
+void check_same_ast_and_reports(const cero::Ast& expected,
+								const RecordingReporter& expected_reporter,
+								const cero::Ast& actual,
+								const RecordingReporter& actual_reporter,
+								const cero::SourceGuard& source) {
+	check_same_ast(expected, actual, source);
+	CHECK(expected_reporter.reports == actual_reporter.reports);
+}
+
+} // namespace tests
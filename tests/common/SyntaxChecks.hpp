@@ -0,0 +1,30 @@
+#pragma once
+
+#include "common/RecordingReporter.hpp"
+
+#include <cero/io/Source.hpp>
+#include <cero/syntax/Ast.hpp>
+#include <cero/syntax/TokenStream.hpp>
+
+#include <span>
+
+namespace tests {
+
+/// Checks that both token streams have the same tokens, trivia and bracket pairs and that they agree on whether there are
+/// errors.
+void check_same_tokens(const cero::TokenStream& expected, const cero::TokenStream& actual);
+
+/// Checks that both sequences of nodes have the same kinds, offsets and numbers of children.
+void check_same_nodes(std::span<const cero::AstNode> expected, std::span<const cero::AstNode> actual);
+
+/// Checks that both ASTs have the same nodes, print the same way and agree on whether there are errors.
+void check_same_ast(const cero::Ast& expected, const cero::Ast& actual, const cero::SourceGuard& source);
+
+/// Checks that both ASTs are the same and that processing the source reported the same diagnostics in the same order.
+void check_same_ast_and_reports(const cero::Ast& expected,
+								const RecordingReporter& expected_reporter,
+								const cero::Ast& actual,
+								const RecordingReporter& actual_reporter,
+								const cero::SourceGuard& source);
+
+} // namespace tests
@@ -0,0 +1,133 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/SyntaxChecks.hpp"
+#include "common/Test.hpp"
+
+#include <cero/driver/BuildCache.hpp>
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/Parse.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace tests {
+
+static constexpr std::string_view CachedSourceText = R"_____(
+public distance(Point a, ^var Point b = Point(), in int32 c) -> float64 {
+	let s = "text with \"escapes\"";
+	let n = 0x3 + 4.5 + 'c';
+	var x = a.x - b.x * 2;
+	if x > 0 {
+		return List<int32>(x);
+	}
+	// a comment
+	return (x, y);
+}
+)_____";
+
+CERO_TEST(BuildCacheRoundTrip) {
+	const auto directory = std::filesystem::temp_directory_path() / "BuildCacheRoundTrip";
+	std::filesystem::remove_all(directory);
+
+	auto source = make_test_source(CachedSourceText);
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Trivia);
+	auto ast = cero::parse(tokens, source, r);
+
+	cero::Configuration config;
+	const auto key = cero::CacheKey::of(source, config);
+	cero::BuildCache cache(directory.string());
+	CHECK(!cache.load(key, source));
+	REQUIRE(cache.store(key, source, tokens, ast));
+
+	auto cached = cache.load(key, source);
+	REQUIRE(cached);
+	check_same_tokens(tokens, cached->token_stream.to_token_stream());
+	check_same_nodes(ast.raw(), cached->ast.raw());
+	check_same_ast(ast, cached->ast.to_ast(source), source);
+
+	// no temporary files are left behind
+	CHECK_EQ(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()), 1);
+
+	CHECK(cero::BuildCache::purge(directory.string()));
+	CHECK(!std::filesystem::exists(directory));
+	CHECK(!cache.load(key, source));
+}
+
+CERO_TEST(BuildCachePurgesOnlyEntries) {
+	const auto directory = std::filesystem::temp_directory_path() / "BuildCachePurgesOnlyEntries";
+	std::filesystem::remove_all(directory);
+
+	auto source = make_test_source(CachedSourceText);
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	auto ast = cero::parse(tokens, source, r);
+
+	const auto key = cero::CacheKey::of(source, cero::Configuration());
+	cero::BuildCache cache(directory.string());
+	REQUIRE(cache.store(key, source, tokens, ast));
+
+	// files that only resemble entries or their temporary files are kept, as is the directory holding them
+	const auto entry_name = key.to_string();
+	const std::string kept_names[] {"main.ce", entry_name + ".txt", entry_name.substr(1), entry_name + ".0123456789abcdeg.tmp",
+									entry_name + ".tmp", "G" + entry_name.substr(1)};
+	for (auto& name : kept_names) {
+		std::ofstream(directory / name) << "kept";
+	}
+	std::filesystem::create_directory(directory / entry_name.substr(2));
+	std::ofstream(directory / (entry_name + ".0123456789abcdef.tmp")) << "left behind";
+
+	CHECK(cero::BuildCache::purge(directory.string()));
+	CHECK(!cache.load(key, source));
+	CHECK(!std::filesystem::exists(directory / (entry_name + ".0123456789abcdef.tmp")));
+	for (auto& name : kept_names) {
+		CHECK(std::filesystem::exists(directory / name));
+	}
+	CHECK(std::filesystem::exists(directory / entry_name.substr(2)));
+
+	std::filesystem::remove_all(directory);
+	CHECK(cero::BuildCache::purge(directory.string()));
+}
+
+CERO_TEST(BuildCacheRejectsMalformedEntries) {
+	const auto directory = std::filesystem::temp_directory_path() / "BuildCacheRejectsMalformedEntries";
+	std::filesystem::remove_all(directory);
+
+	auto source = make_test_source(CachedSourceText);
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	auto ast = cero::parse(tokens, source, r);
+
+	cero::Configuration config;
+	const auto key = cero::CacheKey::of(source, config);
+	cero::BuildCache cache(directory.string());
+	REQUIRE(cache.store(key, source, tokens, ast));
+
+	// any truncation of an entry must be detected
+	const auto entry_path = directory / key.to_string();
+	std::string entry;
+	{
+		std::ifstream file(entry_path, std::ios::binary);
+		entry.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	for (size_t length = 0; length < entry.length(); length += 7) {
+		std::ofstream(entry_path, std::ios::binary | std::ios::trunc) << entry.substr(0, length);
+		CHECK(!cache.load(key, source));
+	}
+
+	// an entry stored under a different key is not used
+	std::ofstream(entry_path, std::ios::binary | std::ios::trunc) << entry;
+	config.tab_size = 8;
+	CHECK(!cache.load(cero::CacheKey::of(source, config), source));
+	CHECK(cache.load(key, source));
+
+	// nor is an entry whose key collides with that of another source, which the length and second hash of the source reveal
+	const auto longer_text = std::string(CachedSourceText) + " ";
+	CHECK(!cache.load(key, make_test_source(longer_text)));
+	auto changed_text = std::string(CachedSourceText);
+	changed_text[changed_text.find('c')] = 'd';
+	CHECK(!cache.load(key, make_test_source(changed_text)));
+
+	cero::BuildCache::purge(directory.string());
+}
+
+} // namespace tests
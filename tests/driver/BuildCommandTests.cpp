@@ -32,4 +32,29 @@ CERO_TEST(CouldNotOpenFileForBuildCommand) {
 	cero::build_source(source, config, r);
 }
 
+CERO_TEST(BuildCommandReportsEachSourceInOrder) {
+#if CERO_WINDOWS
+	constexpr auto err_code = std::errc::permission_denied;
+#else
+	constexpr auto err_code = std::errc::no_such_device;
+#endif
+	const auto err_msg = std::make_error_condition(err_code).message();
+
+	ExhaustiveReporter r;
+	r.set_source_name("FileShouldNotExist.ce");
+	r.expect(0, 0, cero::Message::FileNotFound, {});
+	r.set_source_name(".");
+	r.expect(0, 0, cero::Message::CouldNotOpenFile, cero::MessageArgs(err_msg));
+	r.set_source_name("OtherFileShouldNotExist.ce");
+	r.expect(0, 0, cero::Message::FileNotFound, {});
+
+	cero::Configuration config;
+	const cero::Source sources[] {
+		cero::Source::from_file("FileShouldNotExist.ce", config),
+		cero::Source::from_file(".", config),
+		cero::Source::from_file("OtherFileShouldNotExist.ce", config),
+	};
+	cero::build_sources(sources, config, r);
+}
+
 } // namespace tests
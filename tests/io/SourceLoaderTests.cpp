@@ -0,0 +1,103 @@
+#include "common/Test.hpp"
+
+#include <cero/io/SourceLoader.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace tests {
+
+static void check_sources_in_order(std::string_view test_name, cero::SourceLoadMethod method) {
+	const auto directory = std::filesystem::temp_directory_path() / test_name;
+	std::filesystem::create_directories(directory);
+
+	// every fifth source is missing, and the rest alternate between being read and being mapped
+	cero::Configuration config;
+	config.mmap_threshold = 100;
+	std::vector<std::string> paths;
+	std::vector<std::string> texts;
+	for (int i = 0; i != 50; ++i) {
+		auto path = (directory / fmt::format("{}.ce", i)).string();
+		auto text = std::string(i % 2 == 0 ? 10 : 1000, static_cast<char>('a' + i % 26));
+		if (i % 5 != 4) {
+			std::ofstream(path, std::ios::binary) << text;
+		}
+		paths.emplace_back(std::move(path));
+		texts.emplace_back(std::move(text));
+	}
+
+	std::vector<cero::Source> sources;
+	for (auto& path : paths) {
+		sources.emplace_back(cero::Source::from_file(path, config));
+	}
+
+	cero::SourceLoader loader(sources, method, 3);
+	for (size_t i = 0; i != sources.size(); ++i) {
+		REQUIRE(loader.has_next());
+		auto result = loader.next();
+		if (i % 5 == 4) {
+			CHECK(!result.has_value());
+		} else {
+			REQUIRE(result.has_value());
+			CHECK_EQ(result.value()->get_text(), texts[i]);
+		}
+	}
+	CHECK(!loader.has_next());
+
+	std::filesystem::remove_all(directory);
+}
+
+CERO_TEST(SourceLoaderHandsOutSourcesInOrderThroughRing) {
+	check_sources_in_order("SourceLoaderHandsOutSourcesInOrderThroughRing", cero::SourceLoadMethod::IoRing);
+}
+
+CERO_TEST(SourceLoaderHandsOutSourcesInOrderThroughThreads) {
+	check_sources_in_order("SourceLoaderHandsOutSourcesInOrderThroughThreads", cero::SourceLoadMethod::Threads);
+}
+
+CERO_TEST(SourceLoaderFailsLikeLockingDirectly) {
+	const auto directory = std::filesystem::temp_directory_path() / "SourceLoaderFailsLikeLockingDirectly";
+	std::filesystem::create_directories(directory);
+
+	// a directory opens fine but cannot be read, and a missing file cannot be opened at all
+	cero::Configuration config;
+	std::vector<std::string> paths {directory.string(), (directory / "missing.ce").string()};
+	std::vector<cero::Source> sources;
+	for (auto& path : paths) {
+		sources.emplace_back(cero::Source::from_file(path, config));
+	}
+
+	for (auto method : {cero::SourceLoadMethod::IoRing, cero::SourceLoadMethod::Threads}) {
+		cero::SourceLoader loader(sources, method);
+		for (auto& source : sources) {
+			auto expected = source.lock();
+			auto actual = loader.next();
+			REQUIRE(!expected.has_value());
+			REQUIRE(!actual.has_value());
+			CHECK_EQ(*actual.error(), *expected.error());
+		}
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+CERO_TEST(SourceLoaderStopsEarly) {
+	const auto directory = std::filesystem::temp_directory_path() / "SourceLoaderStopsEarly";
+	std::filesystem::create_directories(directory);
+
+	const auto path = (directory / "main.ce").string();
+	std::ofstream(path, std::ios::binary) << "main() {}";
+
+	cero::Configuration config;
+	std::vector<cero::Source> sources(100, cero::Source::from_file(path, config));
+
+	// the loader must stop without waiting for the sources that were never handed out
+	for (auto method : {cero::SourceLoadMethod::IoRing, cero::SourceLoadMethod::Threads}) {
+		cero::SourceLoader loader(sources, method);
+		CHECK_EQ(loader.next().value()->get_text(), "main() {}");
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+} // namespace tests
@@ -0,0 +1,53 @@
+#include "common/Test.hpp"
+
+#include <cero/io/SourceManager.hpp>
+
+namespace tests {
+
+CERO_TEST(SourceManagerLocatesGlobalOffsets) {
+	cero::Configuration config;
+	auto a = cero::Source::from_string("a", "ab\ncd", config);
+	auto b = cero::Source::from_string("b", "", config);
+	auto c = cero::Source::from_string("c", "x\n\ny", config);
+
+	cero::SourceManager manager;
+	CHECK_EQ(manager.add(a.lock().or_throw()), 0u);
+	CHECK_EQ(manager.add(b.lock().or_throw()), 6u);
+	CHECK_EQ(manager.add(c.lock().or_throw()), 7u);
+	CHECK_EQ(manager.num_sources(), 3u);
+
+	auto check_location = [&](cero::GlobalSourceOffset offset, std::string_view name, uint32_t line, uint32_t column) {
+		auto location = manager.locate(offset);
+		CHECK_EQ(location.source_name, name);
+		CHECK_EQ(location.line, line);
+		CHECK_EQ(location.column, column);
+	};
+	check_location(0, "a", 1, 1);
+	check_location(4, "a", 2, 2);
+	check_location(5, "a", 2, 3); // end of file
+	check_location(6, "b", 1, 1); // empty sources still have an end-of-file offset
+	check_location(7, "c", 1, 1);
+	check_location(10, "c", 3, 1);
+	check_location(11, "c", 3, 2);
+
+	CHECK_EQ(manager.find_source(10), 2u);
+	CHECK_EQ(manager.get_source(2).get_name(), "c");
+	CHECK_EQ(manager.get_base(2), 7u);
+}
+
+CERO_TEST(SourceManagerRunsOutOfGlobalOffsets) {
+	cero::Configuration config;
+	const std::string text(1 << 20, ' ');
+	auto source = cero::Source::from_string("SourceManagerRunsOutOfGlobalOffsets", text, config);
+
+	// each source takes up one more offset than its length, so 4095 sources of 1 MiB fit but the 4096th does not
+	cero::SourceManager manager;
+	for (int i = 0; i != 4095; ++i) {
+		REQUIRE(manager.add(source.lock().or_throw()).has_value());
+	}
+	CHECK(!manager.add(source.lock().or_throw()).has_value());
+	CHECK_EQ(manager.num_sources(), 4095u);
+	CHECK_EQ(manager.find_source(UINT32_MAX - (1 << 20) - 4095), 4094u);
+}
+
+} // namespace tests
@@ -0,0 +1,53 @@
+#include "common/Test.hpp"
+
+#include <cero/io/Source.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace tests {
+
+CERO_TEST(LocateOffsetsInSource) {
+	cero::Configuration config;
+	config.tab_size = 4;
+	auto source = make_test_source("ab\n\tc\n\n d", config);
+
+	auto check_location = [&](cero::SourceOffset offset, uint32_t line, uint32_t column) {
+		auto location = source.locate(offset);
+		CHECK_EQ(location.source_name, "LocateOffsetsInSource");
+		CHECK_EQ(location.line, line);
+		CHECK_EQ(location.column, column);
+	};
+	check_location(0, 1, 1);
+	check_location(1, 1, 2);
+	check_location(2, 1, 3); // the newline itself is still on the first line
+	check_location(3, 2, 1);
+	check_location(4, 2, 5);
+	check_location(6, 3, 1);
+	check_location(7, 4, 1);
+	check_location(8, 4, 2);
+	check_location(9, 4, 3);	 // end of file
+	check_location(1000, 4, 3); // offsets past the end are clamped to the end
+}
+
+CERO_TEST(LockSourceFileByReadingOrMapping) {
+	const auto path = std::filesystem::temp_directory_path() / "LockSourceFileByReadingOrMapping.ce";
+	const std::string text = "main() {\n\treturn;\n}\n";
+	std::ofstream(path, std::ios::binary) << text;
+	const auto path_str = path.string();
+
+	// the same file is read when it is below the threshold and mapped when it is not, both more than once to reuse buffers
+	for (uint32_t mmap_threshold : {0u, 1u, uint32_t(text.length()), uint32_t(text.length() + 1), 1u << 20}) {
+		cero::Configuration config;
+		config.mmap_threshold = mmap_threshold;
+		auto source = cero::Source::from_file(path_str, config);
+		for (int i = 0; i != 2; ++i) {
+			auto guard = source.lock().or_throw();
+			CHECK_EQ(guard.get_text(), text);
+		}
+	}
+
+	std::filesystem::remove(path);
+}
+
+} // namespace tests
@@ -0,0 +1,131 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/SyntaxChecks.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/AstBinary.hpp>
+#include <cero/syntax/Parse.hpp>
+
+#include <cstring>
+#include <optional>
+
+namespace tests {
+
+static constexpr std::string_view BinarySourceText = R"_____(
+public distance(Point a, ^var Point b = Point(), in int32 c) -> float64 {
+	let s = "text with \"escapes\"";
+	var x = a.x - b.x * 2;
+	if x > 0 {
+		return List<int32>(x);
+	}
+	return (x, "text with \"escapes\"");
+}
+)_____";
+
+/// Writes the AST in the binary format.
+static std::string write_binary(const cero::Ast& ast) {
+	cero::BinaryWriter writer;
+	cero::write_binary_ast(writer, ast);
+	return std::string(writer.get_bytes());
+}
+
+static std::optional<cero::AstBinaryView> view_binary(std::string_view bytes, const cero::SourceGuard& source) {
+	cero::BinaryReader reader(bytes);
+	auto view = cero::AstBinaryView::from(reader, source);
+	if (view && reader.num_remaining_bytes() != 0) {
+		return std::nullopt;
+	}
+	return view;
+}
+
+CERO_TEST(AstBinaryRoundTrip) {
+	auto source = make_test_source(BinarySourceText);
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+
+	const auto bytes = write_binary(ast);
+	auto view = view_binary(bytes, source);
+	REQUIRE(view);
+	CHECK_EQ(view->num_nodes(), ast.num_nodes());
+	CHECK_EQ(view->has_errors(), ast.has_errors());
+	check_same_nodes(ast.raw(), view->raw());
+	check_same_ast(ast, view->to_ast(source), source);
+
+	// the nodes are read in place instead of being decoded
+	CHECK_GE(view->raw().data(), static_cast<const void*>(bytes.data()));
+	CHECK_LE(static_cast<const void*>(view->raw().data() + view->num_nodes()), bytes.data() + bytes.size());
+}
+
+CERO_TEST(AstBinaryRejectsInvalidHeader) {
+	auto source = make_test_source(BinarySourceText);
+	ExhaustiveReporter r;
+	const auto bytes = write_binary(cero::parse(source, r));
+
+	for (size_t length = 0; length < bytes.size(); length += 5) {
+		CHECK(!view_binary(std::string_view(bytes).substr(0, length), source));
+	}
+
+	auto wrong_version = bytes;
+	wrong_version[offsetof(cero::AstBinaryHeader, format_version)] += 1;
+	CHECK(!view_binary(wrong_version, source));
+
+	auto wrong_magic = bytes;
+	std::reverse(wrong_magic.begin(), wrong_magic.begin() + sizeof(uint32_t));
+	CHECK(!view_binary(wrong_magic, source));
+
+	// the nodes cannot be viewed in place if the bytes are not aligned for them
+	std::string misaligned = ' ' + bytes;
+	CHECK(!view_binary(std::string_view(misaligned).substr(1), source));
+}
+
+CERO_TEST(AstBinaryRejectsInvalidNodes) {
+	auto source = make_test_source(BinarySourceText);
+	ExhaustiveReporter r;
+	const auto bytes = write_binary(cero::parse(source, r));
+	const auto view = view_binary(bytes, source);
+	REQUIRE(view);
+
+	// replaces the bytes of the node at the given index at the given position within the node, keeping the rest as they are
+	auto with_node_bytes = [&](size_t index, size_t position, auto value) {
+		const auto node_start = reinterpret_cast<const char*>(&view->raw()[index]) - bytes.data();
+		auto changed = bytes;
+		std::memcpy(changed.data() + node_start + position, &value, sizeof(value));
+		return changed;
+	};
+	auto find_node = [&](cero::AstNodeKind kind) {
+		auto it = std::find_if(view->raw().begin(), view->raw().end(), [&](auto& node) { return node.get_kind() == kind; });
+		REQUIRE(it != view->raw().end());
+		return static_cast<size_t>(it - view->raw().begin());
+	};
+
+	// a node starts with its kind, its short count is at byte 2, and its two values are at bytes 8 and 12
+	const auto name_index = find_node(cero::AstNodeKind::NameExpr);
+	const auto call_index = find_node(cero::AstNodeKind::CallExpr);
+	const auto string_index = find_node(cero::AstNodeKind::StringLiteralExpr);
+	const auto function_index = find_node(cero::AstNodeKind::FunctionDefinition);
+	const auto num_kinds = static_cast<uint8_t>(static_cast<uint8_t>(cero::AstNodeKind::FunctionTypeExpr) + 1);
+
+	// unknown kinds of nodes
+	CHECK(!view_binary(with_node_bytes(name_index, 0, num_kinds), source));
+	CHECK(!view_binary(with_node_bytes(name_index, 0, uint8_t(255)), source));
+
+	// names outside the source, string literals outside their values, and function definitions without their other members
+	CHECK(!view_binary(with_node_bytes(name_index, 12, uint32_t(BinarySourceText.length() + 1)), source));
+	CHECK(!view_binary(with_node_bytes(name_index, 8, UINT32_MAX), source));
+	CHECK(!view_binary(with_node_bytes(string_index, 12, uint32_t(1000)), source));
+	CHECK(!view_binary(with_node_bytes(function_index, 12, uint32_t(1)), source));
+
+	// child counts that leave the tree incomplete or that leave nodes outside of it
+	CHECK(!view_binary(with_node_bytes(call_index, 2, uint16_t(view->raw()[call_index].num_children())), source));
+	CHECK(!view_binary(with_node_bytes(call_index, 2, UINT16_MAX), source));
+	CHECK(!view_binary(with_node_bytes(0, 2, uint16_t(0)), source));
+	CHECK(!view_binary(with_node_bytes(0, 0, cero::AstNodeKind::BlockStatement), source));
+	CHECK(!view_binary(with_node_bytes(function_index, 8, uint32_t(0)), source));
+
+	// changing a node in a way that keeps it valid is accepted
+	CHECK(view_binary(with_node_bytes(name_index, 4, view->raw()[name_index].get_offset() + 1), source));
+
+	// the names are only valid for the source that the AST was written for
+	CHECK(!view_binary(bytes, make_test_source(BinarySourceText.substr(0, BinarySourceText.length() / 2))));
+}
+
+} // namespace tests
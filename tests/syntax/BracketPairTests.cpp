@@ -0,0 +1,70 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/TokenCursor.hpp>
+
+namespace tests {
+
+static void check_bracket_pairs(const cero::TokenStream& tokens, std::initializer_list<cero::BracketPair> expected) {
+	// every token that is not given as an opening bracket must have no closing token
+	std::vector<uint32_t> expected_closing(tokens.num_tokens(), cero::BracketPair::Unclosed);
+	for (auto pair : expected) {
+		REQUIRE(cero::is_opening_bracket(tokens.raw()[pair.open].kind));
+		expected_closing[pair.open] = pair.close;
+	}
+
+	auto closing = tokens.raw_closing_brackets();
+	REQUIRE_EQ(closing.size(), expected_closing.size());
+	for (size_t i = 0; i != closing.size(); ++i) {
+		CHECK_EQ(closing[i], expected_closing[i]);
+	}
+}
+
+CERO_TEST(BracketPairsMatchNestedBrackets) {
+	// tokens: f ( a [ b ] ) { { } [ ] } EOF
+	auto source = make_test_source("f(a[b]) { {} [] }");
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	check_bracket_pairs(tokens, {{1, 6}, {3, 5}, {7, 12}, {8, 9}, {10, 11}});
+	CHECK(!tokens.has_unbalanced_brackets());
+
+	CHECK_EQ(tokens.find_closing_bracket(7), 12);
+	CHECK_EQ(tokens.find_closing_bracket(3), 5);
+	CHECK(!tokens.find_closing_bracket(0).has_value());
+	CHECK(!tokens.find_closing_bracket(6).has_value());
+}
+
+CERO_TEST(BracketPairsSkipMismatchedBrackets) {
+	// tokens: { ( ] } ) [ EOF
+	auto source = make_test_source("{ ( ] } ) [");
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+
+	// the closing brace closes the brace opened before the unclosed parenthesis, after which the closing parenthesis and
+	// square bracket match nothing
+	constexpr auto unclosed = cero::BracketPair::Unclosed;
+	check_bracket_pairs(tokens, {{0, 3}, {1, unclosed}, {5, unclosed}});
+	CHECK(tokens.has_unbalanced_brackets());
+	CHECK(!tokens.find_closing_bracket(1).has_value());
+}
+
+CERO_TEST(TokenCursorSkipsBracketedTokens) {
+	auto source = make_test_source("a { b ( c ) } d ( e");
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+
+	cero::TokenCursor c(tokens);
+	CHECK(!c.skip_bracketed());
+	CHECK(c.match(cero::TokenKind::Name));
+	CHECK(c.skip_bracketed());
+	CHECK_EQ(c.get_lexeme(source), "d");
+	CHECK(c.match(cero::TokenKind::Name));
+	CHECK(!c.skip_bracketed());
+	CHECK(c.match(cero::TokenKind::LParen));
+}
+
+} // namespace tests
@@ -0,0 +1,57 @@
+#include "common/Test.hpp"
+
+#include <cero/syntax/Encoding.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace tests {
+
+// searches the range table the way the lookup did before it was expanded into a trie
+static bool search_range_table(std::span<const cero::CodePointRange> table, uint32_t code_point) {
+	auto range = std::ranges::upper_bound(table, code_point, {}, &cero::CodePointRange::begin);
+	return range != table.begin() && code_point <= std::prev(range)->end;
+}
+
+// packs the UTF-8 encoding of the code point into an integer, with the first byte in the lowest bits like the lexer does
+static uint32_t encode_utf8(uint32_t code_point) {
+	uint8_t bytes[4] = {};
+	if (code_point < 0x80) {
+		bytes[0] = static_cast<uint8_t>(code_point);
+	} else if (code_point < 0x800) {
+		bytes[0] = static_cast<uint8_t>(0xc0 | code_point >> 6);
+		bytes[1] = static_cast<uint8_t>(0x80 | (code_point & 0x3f));
+	} else if (code_point < 0x10000) {
+		bytes[0] = static_cast<uint8_t>(0xe0 | code_point >> 12);
+		bytes[1] = static_cast<uint8_t>(0x80 | (code_point >> 6 & 0x3f));
+		bytes[2] = static_cast<uint8_t>(0x80 | (code_point & 0x3f));
+	} else {
+		bytes[0] = static_cast<uint8_t>(0xf0 | code_point >> 18);
+		bytes[1] = static_cast<uint8_t>(0x80 | (code_point >> 12 & 0x3f));
+		bytes[2] = static_cast<uint8_t>(0x80 | (code_point >> 6 & 0x3f));
+		bytes[3] = static_cast<uint8_t>(0x80 | (code_point & 0x3f));
+	}
+
+	uint32_t encoded;
+	std::memcpy(&encoded, bytes, sizeof encoded);
+	return encoded;
+}
+
+CERO_TEST(XidLookupMatchesRangeTables) {
+	const auto start_ranges = cero::get_xid_start_ranges();
+	const auto continue_ranges = cero::get_xid_continue_ranges();
+
+	uint32_t num_start_mismatches = 0;
+	uint32_t num_continue_mismatches = 0;
+	for (uint32_t code_point = 0; code_point <= 0x10ffff; ++code_point) {
+		const auto encoded = encode_utf8(code_point);
+		const bool start_differs = cero::is_utf8_xid_start(encoded) != search_range_table(start_ranges, code_point);
+		const bool continue_differs = cero::is_utf8_xid_continue(encoded) != search_range_table(continue_ranges, code_point);
+		num_start_mismatches += start_differs;
+		num_continue_mismatches += continue_differs;
+	}
+	CHECK(num_start_mismatches == 0);
+	CHECK(num_continue_mismatches == 0);
+}
+
+} // namespace tests
@@ -3,10 +3,10 @@
 
 namespace tests {
 
-CERO_TEST(SourceTooLarge) {
+CERO_TEST(InvalidCharacterBeyondCompactSourceLength) {
 	ExhaustiveReporter r;
-	r.expect(0, 0, cero::Message::SourceInputTooLarge, cero::MessageArgs(cero::MaxSourceLength));
-	build_test_source(r, std::string(cero::MaxSourceLength + 1, ' '));
+	r.expect(5, 1, cero::Message::InvalidCharacter, cero::MessageArgs(0x7));
+	build_test_source(r, "\nmain() {\n}\n" + std::string(2 * cero::SourceSegmentLength, ' ') + "\n\x07() {\n}\n");
 }
 
 CERO_TEST(InvalidCharacter) {
@@ -0,0 +1,70 @@
+#include "common/RecordingReporter.hpp"
+#include "common/SyntaxChecks.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+
+namespace tests {
+
+static void check_parallel_matches_sequential(std::string_view source_text) {
+	auto source = make_test_source(source_text);
+
+	cero::ThreadPool pool(4);
+	for (size_t min_chunk_length : {1u, 7u, 64u, 1000u, 100000u}) {
+		for (auto comment_mode : {cero::CommentMode::Discard, cero::CommentMode::Tokens, cero::CommentMode::Trivia}) {
+			CAPTURE(min_chunk_length);
+			CAPTURE(comment_mode);
+
+			RecordingReporter expected_reporter;
+			auto expected = cero::lex(source, expected_reporter, comment_mode);
+
+			RecordingReporter r;
+			auto tokens = cero::lex_parallel(source, r, comment_mode, pool, min_chunk_length);
+
+			check_same_tokens(expected, tokens);
+			CHECK(expected_reporter.reports == r.reports);
+		}
+	}
+}
+
+CERO_TEST(LexParallelMatchesSequential) {
+	// Each snippet contains something that can make a line beginning a bad place to start lexing.
+	std::string text;
+	for (int i = 0; i != 40; ++i) {
+		text += R"_____(
+foo(int32 a) -> int32 {
+	/* block comment
+	   let x = "not a string;
+	   /* nested
+	   */ still comment
+	*/ return a >> 2..3;
+	let n = 123
+			456
+	.789;
+	let s = "unterminated;
+	let c = 'x;
+	let ü = ö;
+	// line comment */ "
+	return ...;
+}
+)_____";
+	}
+	check_parallel_matches_sequential(text);
+}
+
+CERO_TEST(LexParallelBlockCommentSpanningChunks) {
+	// The comment is longer than the window in which chunks remember where their tokens start, so chunks inside of it can only
+	// be relexed.
+	std::string text = "a /*\n";
+	for (int i = 0; i != 3000; ++i) {
+		text += "let x = \"abc\" + 'd' * 1.5; b\n";
+	}
+	text += "*/ c\n";
+	text += "d /* unterminated\n";
+	for (int i = 0; i != 100; ++i) {
+		text += "e;\n";
+	}
+	check_parallel_matches_sequential(text);
+}
+
+} // namespace tests
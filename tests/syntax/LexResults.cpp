@@ -27,7 +27,7 @@ CERO_TEST(LexEmptySource) {
 	auto source = make_test_source("");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {EndOfFile});
@@ -50,7 +50,7 @@ CERO_TEST(LexIntegerLiterals) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens,
@@ -102,7 +102,7 @@ CERO_TEST(LexFloatLiterals) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {FloatLiteral, Semicolon,		DecIntLiteral, Dot,		  Semicolon,	FloatLiteral, Semicolon,
@@ -150,7 +150,7 @@ CERO_TEST(LexStringLiteralsWithEscapes) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {StringLiteral, StringLiteral, StringLiteral, StringLiteral, StringLiteral, StringLiteral,
@@ -176,7 +176,7 @@ CERO_TEST(LexLineComments) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {LineComment, LineComment, LineComment, LineComment, EndOfFile});
@@ -188,6 +188,36 @@ CERO_TEST(LexLineComments) {
 	CHECK_EQ(next_lexeme(c, source), "// //");
 }
 
+CERO_TEST(LexCommentsAsTrivia) {
+	auto source = make_test_source(R"_____(// first
+a /* second */ b // third
+/* fourth */
+)_____");
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Trivia);
+	CHECK(!tokens.has_errors());
+
+	check_token_kinds(tokens, {Name, Name, EndOfFile});
+
+	auto trivia = tokens.raw_trivia();
+	REQUIRE_EQ(trivia.size(), 4);
+	auto check_trivia = [&](size_t index, cero::TokenKind kind, std::string_view lexeme, uint32_t next_token) {
+		CHECK_EQ(trivia[index].kind, kind);
+		CHECK_EQ(source.get_text().substr(trivia[index].offset, trivia[index].length), lexeme);
+		CHECK_EQ(trivia[index].next_token, next_token);
+	};
+	check_trivia(0, LineComment, "// first", 0);
+	check_trivia(1, BlockComment, "/* second */", 1);
+	check_trivia(2, LineComment, "// third", 2);
+	check_trivia(3, BlockComment, "/* fourth */", 2);
+
+	CHECK_EQ(tokens.get_trivia_before(0).size(), 1);
+	CHECK_EQ(tokens.get_trivia_before(1).size(), 1);
+	CHECK_EQ(tokens.get_trivia_before(2).size(), 2);
+	CHECK_EQ(tokens.get_trivia_before(2)[0].offset, trivia[2].offset);
+}
+
 CERO_TEST(LexBlockComments) {
 	auto source = make_test_source(R"_____(
 /**/
@@ -207,7 +237,7 @@ CERO_TEST(LexBlockComments) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {BlockComment, BlockComment, BlockComment, BlockComment, BlockComment, BlockComment, BlockComment,
@@ -232,7 +262,7 @@ CERO_TEST(LexBracketCaret) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {LBracket, Caret, EndOfFile});
@@ -245,7 +275,7 @@ CERO_TEST(LexUnicodeNames) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {Name, LParen, RParen, LBrace, RBrace, EndOfFile});
@@ -267,7 +297,7 @@ CERO_TEST(LexOperators) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {Bang,   Plus,   Minus,	 Star,	   Slash,		 Percent,	 EqEq,	 BangEq,
@@ -281,10 +311,63 @@ CERO_TEST(LexDotDot) {
 )_____");
 
 	ExhaustiveReporter r;
-	auto tokens = cero::lex(source, r, true);
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
 	CHECK(!tokens.has_errors());
 
 	check_token_kinds(tokens, {Dot, Dot, EndOfFile});
 }
 
+CERO_TEST(LexLexemesWithoutComments) {
+	auto source = make_test_source(R"_____(
+name// comment
+123    /* comment */ .. >>
+)_____");
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	CHECK(!tokens.has_errors());
+
+	check_token_kinds(tokens, {Name, DecIntLiteral, Dot, Dot, RAngle, RAngle, EndOfFile});
+
+	cero::TokenCursor c(tokens);
+	CHECK_EQ(next_lexeme(c, source), "name");
+	CHECK_EQ(next_lexeme(c, source), "123");
+	CHECK_EQ(next_lexeme(c, source), ".");
+	CHECK_EQ(next_lexeme(c, source), ".");
+	CHECK_EQ(next_lexeme(c, source), ">");
+	CHECK_EQ(next_lexeme(c, source), ">");
+	CHECK_EQ(next_lexeme(c, source), "");
+}
+
+CERO_TEST(LexEveryFixedLengthToken) {
+	for (auto kind = Dot; kind != EndOfFile; kind = static_cast<cero::TokenKind>(static_cast<int>(kind) + 1)) {
+		auto lexeme = cero::get_fixed_length_lexeme(kind);
+		CAPTURE(lexeme);
+
+		for (auto text : {std::string(lexeme), std::string(lexeme) + " x"}) {
+			auto source = make_test_source(text);
+
+			ExhaustiveReporter r;
+			auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
+			CHECK(!tokens.has_errors());
+
+			cero::TokenCursor c(tokens);
+			CHECK_EQ(c.peek_kind(), kind);
+			CHECK_EQ(next_lexeme(c, source), lexeme);
+		}
+	}
+}
+
+CERO_TEST(LexKeywordLookalikes) {
+	auto source = make_test_source(R"_____(
+le lets iff n whil While returns uncheck unchecked_ _if breaks
+)_____");
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Tokens);
+	CHECK(!tokens.has_errors());
+
+	check_token_kinds(tokens, {Name, Name, Name, Name, Name, Name, Name, Name, Name, Name, Name, EndOfFile});
+}
+
 } // namespace tests
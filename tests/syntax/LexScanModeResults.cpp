@@ -0,0 +1,64 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+
+namespace tests {
+
+static void check_same_tokens(const cero::TokenStream& expected, const cero::TokenStream& actual) {
+	auto expected_tokens = expected.raw();
+	auto actual_tokens = actual.raw();
+	REQUIRE(expected_tokens.size() == actual_tokens.size());
+
+	for (size_t i = 0; i != expected_tokens.size(); ++i) {
+		CHECK_EQ(expected_tokens[i].kind, actual_tokens[i].kind);
+		CHECK_EQ(expected_tokens[i].offset, actual_tokens[i].offset);
+	}
+	CHECK_EQ(expected.has_errors(), actual.has_errors());
+}
+
+static void check_all_scan_modes(std::string_view source_text) {
+	auto source = make_test_source(source_text);
+
+	ExhaustiveReporter r;
+	auto scalar_tokens = cero::lex(source, r, cero::CommentMode::Tokens, cero::ScanMode::Scalar);
+	CHECK(!scalar_tokens.has_errors());
+
+	for (auto mode : {cero::ScanMode::Sse2, cero::ScanMode::Avx2}) {
+		if (cero::is_scan_mode_supported(mode)) {
+			auto tokens = cero::lex(source, r, cero::CommentMode::Tokens, mode);
+			check_same_tokens(scalar_tokens, tokens);
+		}
+	}
+}
+
+CERO_TEST(LexScanModesProduceSameTokens) {
+	check_all_scan_modes(R"_____(
+foo(int32 a, int32 b) -> int32 {
+	let c = a + b;						    // trailing whitespace of mixed kinds
+	let äöü = a_very_long_identifier_that_spans_more_than_thirty_two_characters + b;
+	let _0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_ = 0x123 456;
+	let 変数 = nameÆending + mixed_ascii変数_ascii;
+	/* block
+	   comment */ return "string   with   spaces", 'c', 1.5;
+}
+)_____");
+}
+
+CERO_TEST(LexScanModesAtBlockBoundaries) {
+	// Exercise runs whose length is right around the vector block sizes, so that every tail handling path is taken.
+	std::string text;
+	for (size_t length = 1; length <= 70; ++length) {
+		text.append(length, ' ');
+		text.append(length, 'x');
+		text.append(length % 5, '\t');
+		text.append(length, '_');
+		text += "ü";
+		text.append(length, '7');
+		text += ";\n";
+	}
+	text.append(64, '\n');
+	check_all_scan_modes(text);
+}
+
+} // namespace tests
@@ -455,4 +455,75 @@ f(int32 a, int32 b, int32 c, int32 d) {
 )_____");
 }
 
+CERO_TEST(RecoverAfterEachError) {
+	ExhaustiveReporter r;
+	r.expect(3, 9, cero::Message::ExpectNameAfterLet, cero::MessageArgs("`=`"));
+	r.expect(4, 9, cero::Message::ExpectExpr, cero::MessageArgs("`;`"));
+	r.expect(5, 10, cero::Message::ExpectExpr, cero::MessageArgs("`;`"));
+	r.expect(6, 17, cero::Message::ExpectExpr, cero::MessageArgs("`;`"));
+	r.expect(10, 15, cero::Message::ExpectParamName, cero::MessageArgs("`)`"));
+
+	build_test_source(r, R"_____(
+public f(int32 a, int32 b) {
+	let = 1;
+	a + ;
+	b(a, ;
+	let c = a & ;
+	return a + b;
+}
+
+public g(int32) {
+	return;
+}
+
+public h() {
+	return;
+}
+)_____");
+}
+
+CERO_TEST(ReportErrorsInGenericArgumentsOnce) {
+	ExhaustiveReporter r;
+	r.expect(3, 13, cero::Message::ExpectNameAfterLet, cero::MessageArgs("`=`"));
+	r.expect(4, 15, cero::Message::ExpectNameAfterLet, cero::MessageArgs("`=`"));
+
+	build_test_source(r, R"_____(
+public f(int32 a, int32 b) {
+	a<{ let = 1; }> c;
+	a < { let = 1; };
+}
+)_____");
+}
+
+CERO_TEST(RecoverAtStatementScopeAfterBrackets) {
+	ExhaustiveReporter r;
+	r.expect(3, 15, cero::Message::ExpectSemicolon, cero::MessageArgs("`{`"));
+
+	// the semicolons and the closing brace inside the block must not end the statement or the function
+	build_test_source(r, R"_____(
+main() {
+	let x = 1 {
+		a;
+		b;
+	};
+	return;
+}
+)_____");
+}
+
+CERO_TEST(RecoverAtDefinitionScopeAfterBrackets) {
+	ExhaustiveReporter r;
+	r.expect(2, 4, cero::Message::ExpectParenAfterFuncName, cero::MessageArgs("`)`"));
+
+	// the keyword inside the body must not be mistaken for the beginning of a definition
+	build_test_source(r, R"_____(
+foo) {
+	struct;
+}
+
+private bar() {
+}
+)_____");
+}
+
 } // namespace tests
@@ -0,0 +1,233 @@
+#include "AstCompare.hpp"
+#include "common/ExhaustiveReporter.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Parse.hpp>
+
+namespace tests {
+
+static std::vector<std::string> make_names(std::string_view prefix, int num_names) {
+	std::vector<std::string> names;
+	for (int i = 0; i < num_names; ++i) {
+		names.emplace_back(fmt::format("{}{}", prefix, i));
+	}
+	return names;
+}
+
+static std::string make_sum(std::span<const std::string> terms) {
+	std::string sum = terms[0];
+	for (auto& term : terms.subspan(1)) {
+		sum += " + " + term;
+	}
+	return sum;
+}
+
+// the comparer only keeps a view of the names, so they must outlive the comparison
+static void compare_sum(AstCompare& c, std::span<const std::string> terms) {
+	if (terms.size() == 1) {
+		c.name_expr(terms[0]);
+		return;
+	}
+	c.binary_expr(cero::BinaryOperator::Add, [&] {
+		compare_sum(c, terms.first(terms.size() - 1));
+		c.name_expr(terms.back());
+	});
+}
+
+// each operator of a left-associative chain becomes the parent of everything parsed before it, which used to make building
+// the AST quadratic in the length of the chain
+CERO_TEST(ParseLongOperatorChain) {
+	constexpr int num_terms = 100'000;
+	auto names = make_names("a", num_terms);
+	auto source_text = fmt::format("f() -> int32 {{\n\treturn {};\n}}\n", make_sum(names));
+	auto source = make_test_source(source_text);
+
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+	CHECK(!ast.has_errors());
+
+	auto nodes = ast.raw();
+	REQUIRE(nodes.size() == 5 + 2 * num_terms - 1);
+	CHECK(nodes[0].get_kind() == cero::AstNodeKind::Root);
+	CHECK(nodes[1].get_kind() == cero::AstNodeKind::FunctionDefinition);
+	CHECK(nodes[2].get_kind() == cero::AstNodeKind::FunctionOutput);
+	CHECK(nodes[3].get_kind() == cero::AstNodeKind::NameExpr);
+	CHECK(nodes[4].get_kind() == cero::AstNodeKind::ReturnExpr);
+
+	auto operators = nodes.subspan(5, num_terms - 1);
+	CHECK(std::ranges::all_of(operators, [](const cero::AstNode& node) {
+		return node.get_kind() == cero::AstNodeKind::BinaryExpr;
+	}));
+
+	auto name_exprs = nodes.subspan(5 + num_terms - 1);
+	bool names_in_order = true;
+	for (int i = 0; i < num_terms; ++i) {
+		auto name_expr = ast.get<cero::AstNameExpr>(name_exprs[static_cast<size_t>(i)]);
+		names_in_order &= name_expr.has_value() && name_expr->name == names[static_cast<size_t>(i)];
+	}
+	CHECK(names_in_order);
+}
+
+CERO_TEST(ParseLongPostfixChain) {
+	constexpr int num_indices = 100'000;
+	std::string indices;
+	for (int i = 0; i < num_indices; ++i) {
+		indices += fmt::format("[{}]", i);
+	}
+	auto source_text = fmt::format("f() -> int32 {{\n\treturn x{};\n}}\n", indices);
+	auto source = make_test_source(source_text);
+
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+	CHECK(!ast.has_errors());
+
+	auto nodes = ast.raw();
+	REQUIRE(nodes.size() == 5 + 2 * num_indices + 1);
+
+	auto index_exprs = nodes.subspan(5, num_indices);
+	CHECK(std::ranges::all_of(index_exprs, [](const cero::AstNode& node) {
+		return node.get_kind() == cero::AstNodeKind::IndexExpr;
+	}));
+	CHECK(nodes[5 + num_indices].get_kind() == cero::AstNodeKind::NameExpr);
+
+	auto literals = nodes.subspan(5 + num_indices + 1);
+	CHECK(std::ranges::all_of(literals, [](const cero::AstNode& node) {
+		return node.get_kind() == cero::AstNodeKind::NumericLiteralExpr;
+	}));
+	CHECK(std::is_sorted(literals.begin(), literals.end(), [](const cero::AstNode& left, const cero::AstNode& right) {
+		return left.get_offset() < right.get_offset();
+	}));
+}
+
+// long chains inside generic arguments are parsed during lookahead, so the nodes of the chain have to be undone properly when
+// the lookahead fails
+CERO_TEST(ParseLongOperatorChainsInGenericLookahead) {
+	constexpr int num_terms = 100;
+	auto b_names = make_names("b", num_terms);
+	auto c_names = make_names("c", num_terms);
+	auto source_text = fmt::format(R"_____(
+f() -> int32 {{
+	return List<{}>(x);
+}}
+
+g() -> bool {{
+	return a < {};
+}}
+)_____",
+								   make_sum(b_names), make_sum(c_names));
+	auto source = make_test_source(source_text);
+
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+	CHECK(!ast.has_errors());
+
+	AstCompare c(ast);
+	c.root();
+	c.function_definition(cero::AccessSpecifier::None, "f", [&] {
+		c.function_output("", [&] {
+			c.name_expr("int32");
+		});
+		c.return_expr([&] {
+			c.call_expr([&] {
+				c.generic_name_expr("List", [&] {
+					compare_sum(c, b_names);
+				});
+				c.name_expr("x");
+			});
+		});
+	});
+	c.function_definition(cero::AccessSpecifier::None, "g", [&] {
+		c.function_output("", [&] {
+			c.name_expr("bool");
+		});
+		c.return_expr([&] {
+			c.binary_expr(cero::BinaryOperator::Less, [&] {
+				c.name_expr("a");
+				compare_sum(c, c_names);
+			});
+		});
+	});
+	c.compare();
+}
+
+// the lookahead from each left angle bracket contains the lookaheads from the ones after it, which used to be repeated every
+// time an enclosing lookahead failed and made parsing exponential in the length of the chain
+CERO_TEST(ParseLongLessThanChain) {
+	constexpr int num_terms = 100;
+	auto names = make_names("a", num_terms);
+	std::string chain = names[0];
+	for (auto& name : std::span(names).subspan(1)) {
+		chain += " < " + name;
+	}
+	auto source_text = fmt::format("f() -> bool {{\n\treturn {};\n}}\n", chain);
+	auto source = make_test_source(source_text);
+
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+	CHECK(!ast.has_errors());
+
+	auto nodes = ast.raw();
+	REQUIRE(nodes.size() == 5 + 2 * num_terms - 1);
+
+	auto operators = nodes.subspan(5, num_terms - 1);
+	CHECK(std::ranges::all_of(operators, [&](const cero::AstNode& node) {
+		auto binary_expr = ast.get<cero::AstBinaryExpr>(node);
+		return binary_expr.has_value() && binary_expr->op == cero::BinaryOperator::Less;
+	}));
+	CHECK(std::ranges::all_of(nodes.subspan(5 + num_terms - 1), [](const cero::AstNode& node) {
+		return node.get_kind() == cero::AstNodeKind::NameExpr;
+	}));
+}
+
+CERO_TEST(ParseDeeplyNestedGenerics) {
+	constexpr int depth = 100;
+	std::string type = "int32";
+	for (int i = 0; i < depth; ++i) {
+		type = "List<" + type + ">";
+	}
+	auto source_text = fmt::format("f() {{\n\t{} x;\n}}\n", type);
+	auto source = make_test_source(source_text);
+
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+	CHECK(!ast.has_errors());
+
+	auto nodes = ast.raw();
+	REQUIRE(nodes.size() == 3 + depth + 1);
+	CHECK(nodes[2].get_kind() == cero::AstNodeKind::BindingStatement);
+	CHECK(std::ranges::all_of(nodes.subspan(3, depth), [&](const cero::AstNode& node) {
+		auto generic_name_expr = ast.get<cero::AstGenericNameExpr>(node);
+		return generic_name_expr.has_value() && generic_name_expr->num_generic_args == 1;
+	}));
+	CHECK(nodes[3 + depth].get_kind() == cero::AstNodeKind::NameExpr);
+}
+
+// the lookahead from the first left angle bracket finds a comparison, so the generics nested in it are parsed again, which
+// must use the outcome of their lookaheads instead of looking ahead from their brackets a second time
+CERO_TEST(ParseNestedGenericsInDiscardedLookahead) {
+	constexpr int depth = 10;
+	std::string type = "int32";
+	for (int i = 0; i < depth; ++i) {
+		type = "List<" + type + ">";
+	}
+	auto source_text = fmt::format("f() {{\n\tg(a < {}(), b > 0);\n}}\n", type);
+	auto source = make_test_source(source_text);
+
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+	CHECK(!ast.has_errors());
+	CHECK(ast.num_generic_lookaheads() == depth + 1);
+
+	auto nodes = ast.raw();
+	auto generic_name_exprs = std::ranges::count_if(nodes, [&](const cero::AstNode& node) {
+		auto generic_name_expr = ast.get<cero::AstGenericNameExpr>(node);
+		return generic_name_expr.has_value() && generic_name_expr->num_generic_args == 1;
+	});
+	CHECK(generic_name_exprs == depth);
+	CHECK(std::ranges::count_if(nodes, [&](const cero::AstNode& node) {
+		auto binary_expr = ast.get<cero::AstBinaryExpr>(node);
+		return binary_expr.has_value() && binary_expr->op == cero::BinaryOperator::Less;
+	}) == 1);
+}
+
+} // namespace tests
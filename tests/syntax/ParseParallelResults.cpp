@@ -0,0 +1,106 @@
+#include "common/RecordingReporter.hpp"
+#include "common/SyntaxChecks.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/Parse.hpp>
+
+namespace tests {
+
+static void check_parallel_matches_sequential(std::string_view source_text) {
+	auto source = make_test_source(source_text);
+
+	RecordingReporter lex_reporter;
+	auto tokens = cero::lex(source, lex_reporter, cero::CommentMode::Discard);
+
+	RecordingReporter expected_reporter;
+	auto expected = cero::parse(tokens, source, expected_reporter);
+
+	cero::ThreadPool pool(4);
+	for (size_t min_chunk_tokens : {1u, 7u, 64u, 1000u, 100000u}) {
+		CAPTURE(min_chunk_tokens);
+
+		RecordingReporter r;
+		auto ast = cero::parse_parallel(tokens, source, r, pool, min_chunk_tokens);
+
+		check_same_ast_and_reports(expected, expected_reporter, ast, r, source);
+	}
+}
+
+CERO_TEST(ParseParallelMatchesSequential) {
+	std::string text;
+	for (int i = 0; i != 40; ++i) {
+		text += fmt::format(R"_____(
+public f{0}(int32 a, List<int32> b) -> int32 {{
+	let x = a + b[0] * {0};
+	if a < b.size() {{
+		return g<int32>(x);
+	}}
+	while x > 0 {{
+		x -= 1;
+	}}
+	return a < x >> 2;
+}}
+
+private g{0}() {{
+	{{ let y = {{ return; }}; }}
+}}
+)_____",
+							i);
+	}
+	check_parallel_matches_sequential(text);
+}
+
+CERO_TEST(ParseParallelRecoversLikeSequential) {
+	// Each snippet contains an error after which the sequential parser resumes somewhere other than after the closing brace
+	// that ends a definition, so that chunks can begin at a token where the sequential parser never begins a definition.
+	std::string text;
+	for (int i = 0; i != 40; ++i) {
+		text += fmt::format(R"_____(
+public a{0}(int32 x) {{
+	let = x;
+	x + ;
+	return x < ;
+}}
+
+b{0}(int32) {{
+	return;
+}}
+
+c{0}() {{
+	return 1;
+}}
+}}
+
+public d{0}() {{
+	if x {{
+		return;
+}}
+
+public e{0}( {{ }} f{0}() {{ }}
+)_____",
+							i);
+	}
+	check_parallel_matches_sequential(text);
+}
+
+CERO_TEST(ParseParallelCutsChunksShortAtUnparsedConstructs) {
+	// The sequential parser skips each function f while recovering from the error in the function before it, so it never gets
+	// to the for-loops, which cannot be parsed yet. Chunks that begin at f must stop there instead of terminating.
+	std::string text;
+	for (int i = 0; i != 40; ++i) {
+		text += fmt::format(R"_____(
+public a{0}(int32 x) {{
+	return x;
+}}
+
+public e{0}( {{ }} f{0}() {{
+	for x in y {{ }}
+}}
+)_____",
+							i);
+	}
+	check_parallel_matches_sequential(text);
+}
+
+} // namespace tests
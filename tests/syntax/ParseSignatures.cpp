@@ -0,0 +1,174 @@
+#include "common/RecordingReporter.hpp"
+#include "common/SyntaxChecks.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/Parse.hpp>
+
+namespace tests {
+
+// returns the index one past the last node in the subtree of the given node
+static size_t find_subtree_end(std::span<const cero::AstNode> nodes, size_t index) {
+	const auto num_children = nodes[index].num_children();
+	++index;
+	for (uint32_t i = 0; i != num_children; ++i) {
+		index = find_subtree_end(nodes, index);
+	}
+	return index;
+}
+
+// checks that parsing the signatures and then every function body yields the same nodes as parsing everything, which only
+// holds without syntax errors, since the nodes of statements that failed to parse are left in the AST
+static void check_signatures_match_full_parse(std::string_view source_text) {
+	auto source = make_test_source(source_text);
+
+	RecordingReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+
+	auto full = cero::parse(tokens, source, r);
+	auto full_nodes = full.raw();
+	REQUIRE(!full.has_errors());
+
+	auto signatures = cero::parse_signatures(tokens, source, r);
+	auto signature_nodes = signatures.raw();
+
+	size_t full_index = 1;
+	size_t signature_index = 1;
+	CHECK_EQ(full_nodes[0].num_children(), signature_nodes[0].num_children());
+	while (full_index != full_nodes.size()) {
+		REQUIRE(signature_index != signature_nodes.size());
+		const auto& node = full_nodes[full_index];
+		if (node.get_kind() != cero::AstNodeKind::FunctionDefinition) {
+			const auto end = find_subtree_end(full_nodes, full_index);
+			const auto size = end - full_index;
+			check_same_nodes(full_nodes.subspan(full_index, size), signature_nodes.subspan(signature_index, size));
+			full_index = end;
+			signature_index += size;
+			continue;
+		}
+
+		const auto definition = full.as<cero::AstFunctionDefinition>(node);
+		const auto signature = signatures.as<cero::AstFunctionDefinition>(signature_nodes[signature_index]);
+		CHECK_EQ(definition.header.offset, signature.header.offset);
+		CHECK_EQ(definition.num_parameters, signature.num_parameters);
+		CHECK_EQ(definition.num_outputs, signature.num_outputs);
+		CHECK(signature.num_statements == 0);
+
+		// parameters and outputs are parsed along with the signatures
+		auto begin = full_index + 1;
+		auto end = begin;
+		for (uint32_t i = 0; i != definition.num_parameters + definition.num_outputs; ++i) {
+			end = find_subtree_end(full_nodes, end);
+		}
+		check_same_nodes(full_nodes.subspan(begin, end - begin), signature_nodes.subspan(signature_index + 1, end - begin));
+		signature_index += 1 + end - begin;
+
+		begin = end;
+		for (uint32_t i = 0; i != definition.num_statements; ++i) {
+			end = find_subtree_end(full_nodes, end);
+		}
+		full_index = end;
+
+		CHECK(signatures.has_skipped_body(signature));
+		auto body = cero::parse_function_body(signatures, signature, tokens, source, r);
+		REQUIRE(body.has_value());
+
+		auto body_nodes = body->raw();
+		REQUIRE(!body_nodes.empty());
+		CHECK_EQ(body_nodes[0].get_kind(), cero::AstNodeKind::BlockStatement);
+		CHECK_EQ(body_nodes[0].num_children(), definition.num_statements);
+		check_same_nodes(full_nodes.subspan(begin, end - begin), body_nodes.subspan(1));
+	}
+	CHECK_EQ(signature_index, signature_nodes.size());
+	CHECK(r.reports.empty());
+}
+
+CERO_TEST(ParseSignaturesMatchesFullParse) {
+	check_signatures_match_full_parse(R"_____(
+public f(int32 a, List<int32> b) -> int32 {
+	let x = a + b[0];
+	if a < b.size() {
+		return g<int32>(x);
+	}
+	while x > 0 {
+		x -= 1;
+		{ let y = x; }
+	}
+	return a;
+}
+
+private g() {
+}
+
+h(int32 c) -> int32, bool {
+	return c, c > 0;
+}
+)_____");
+}
+
+CERO_TEST(ParseSignaturesDefersErrorsInBodies) {
+	auto source_text = R"_____(
+f() {
+	let = 1;
+}
+
+g() -> int32 {
+	return 1 + ;
+}
+)_____";
+	auto source = make_test_source(source_text);
+
+	RecordingReporter lex_reporter;
+	auto tokens = cero::lex(source, lex_reporter, cero::CommentMode::Discard);
+
+	RecordingReporter full_reporter;
+	std::ignore = cero::parse(tokens, source, full_reporter);
+	CHECK(full_reporter.reports.size() == 2);
+
+	RecordingReporter r;
+	auto signatures = cero::parse_signatures(tokens, source, r);
+	CHECK(!signatures.has_errors());
+	CHECK(r.reports.empty());
+
+	for (const auto& node : signatures.raw()) {
+		if (node.get_kind() != cero::AstNodeKind::FunctionDefinition) {
+			continue;
+		}
+		const auto definition = signatures.as<cero::AstFunctionDefinition>(node);
+		auto body = cero::parse_function_body(signatures, definition, tokens, source, r);
+		REQUIRE(body.has_value());
+		CHECK(body->has_errors());
+	}
+	CHECK(full_reporter.reports == r.reports);
+}
+
+CERO_TEST(ParseSignaturesParsesUnclosedBody) {
+	auto source_text = R"_____(
+f() {
+}
+
+g() {
+	{ return;
+)_____";
+	auto source = make_test_source(source_text);
+
+	RecordingReporter lex_reporter;
+	auto tokens = cero::lex(source, lex_reporter, cero::CommentMode::Discard);
+
+	RecordingReporter full_reporter;
+	auto full = cero::parse(tokens, source, full_reporter);
+
+	RecordingReporter r;
+	auto signatures = cero::parse_signatures(tokens, source, r);
+	CHECK(signatures.has_errors());
+	CHECK(full_reporter.reports == r.reports);
+
+	const auto closed = signatures.as<cero::AstFunctionDefinition>(signatures.raw()[1]);
+	const auto unclosed = signatures.as<cero::AstFunctionDefinition>(signatures.raw()[2]);
+	CHECK(signatures.has_skipped_body(closed));
+	CHECK(!signatures.has_skipped_body(unclosed));
+	CHECK(!cero::parse_function_body(signatures, unclosed, tokens, source, r).has_value());
+	CHECK_EQ(full.to_string(source), signatures.to_string(source));
+}
+
+} // namespace tests
@@ -0,0 +1,128 @@
+#include "common/RecordingReporter.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+
+#include <random>
+
+namespace tests {
+
+static void check_streams_equal(const cero::TokenStream& expected, const cero::TokenStream& actual) {
+	auto expected_tokens = expected.raw();
+	auto actual_tokens = actual.raw();
+	REQUIRE_EQ(expected_tokens.size(), actual_tokens.size());
+	for (size_t i = 0; i != expected_tokens.size(); ++i) {
+		CHECK_EQ(expected_tokens[i].kind, actual_tokens[i].kind);
+		CHECK_EQ(expected_tokens[i].offset, actual_tokens[i].offset);
+		CHECK_EQ(expected.raw_lengths()[i], actual.raw_lengths()[i]);
+	}
+	auto expected_trivia = expected.raw_trivia();
+	auto actual_trivia = actual.raw_trivia();
+	REQUIRE_EQ(expected_trivia.size(), actual_trivia.size());
+	for (size_t i = 0; i != expected_trivia.size(); ++i) {
+		CHECK_EQ(expected_trivia[i].offset, actual_trivia[i].offset);
+		CHECK_EQ(expected_trivia[i].length, actual_trivia[i].length);
+		CHECK_EQ(expected_trivia[i].next_token, actual_trivia[i].next_token);
+	}
+	auto expected_closing = expected.raw_closing_brackets();
+	auto actual_closing = actual.raw_closing_brackets();
+	REQUIRE_EQ(expected_closing.size(), actual_closing.size());
+	for (size_t i = 0; i != expected_closing.size(); ++i) {
+		CHECK_EQ(expected_closing[i], actual_closing[i]);
+	}
+	CHECK_EQ(expected.has_unbalanced_brackets(), actual.has_unbalanced_brackets());
+	CHECK_EQ(expected.has_errors(), actual.has_errors());
+}
+
+/// Applies the edit to the text and checks that relexing after the edit gives the same result as lexing the edited text.
+static cero::TokenStream check_relex_matches_lex(const cero::TokenStream& old_stream,
+												 std::string& text,
+												 cero::SourceEdit edit,
+												 std::string_view replacement,
+												 cero::CommentMode comment_mode) {
+	text.replace(edit.offset, edit.old_length, replacement);
+	auto source = make_test_source(text);
+
+	RecordingReporter expected_reporter;
+	auto expected = cero::lex(source, expected_reporter, comment_mode);
+
+	RecordingReporter r;
+	auto relexed = cero::relex(old_stream, source, edit, r, comment_mode);
+	check_streams_equal(expected, relexed);
+
+	// only the diagnostics from the relexed range are reported again
+	for (auto& report : r.reports) {
+		CHECK(std::find(expected_reporter.reports.begin(), expected_reporter.reports.end(), report)
+			  != expected_reporter.reports.end());
+	}
+	return relexed;
+}
+
+CERO_TEST(RelexOpeningAndClosingBlockComment) {
+	const auto comment_mode = cero::CommentMode::Trivia;
+	std::string text = "a b c d e f g h";
+	RecordingReporter r;
+	auto stream = cero::lex(make_test_source(text), r, comment_mode);
+
+	stream = check_relex_matches_lex(stream, text, {4, 0, 2}, "/*", comment_mode);
+	CHECK_EQ(stream.num_tokens(), 3u);
+	CHECK(stream.has_errors());
+
+	stream = check_relex_matches_lex(stream, text, {10, 0, 2}, "*/", comment_mode);
+	CHECK_EQ(stream.num_tokens(), 7u);
+	CHECK(!stream.has_errors());
+
+	stream = check_relex_matches_lex(stream, text, {4, 2, 0}, "", comment_mode);
+	CHECK_EQ(stream.num_tokens(), 11u);
+	CHECK(!stream.has_errors());
+}
+
+CERO_TEST(RelexOpeningAndClosingString) {
+	const auto comment_mode = cero::CommentMode::Discard;
+	std::string text = "let s = x + y;\nlet t = z;\n";
+	RecordingReporter r;
+	auto stream = cero::lex(make_test_source(text), r, comment_mode);
+
+	stream = check_relex_matches_lex(stream, text, {8, 0, 1}, "\"", comment_mode);
+	CHECK(stream.has_errors());
+
+	stream = check_relex_matches_lex(stream, text, {14, 0, 1}, "\"", comment_mode);
+	CHECK(!stream.has_errors());
+}
+
+CERO_TEST(RelexRandomEdits) {
+	// Fragments are chosen so that edits often merge or split tokens, or change how far a token looks ahead.
+	constexpr std::string_view fragments[] {
+		"a",  "let", "ü",  " ",	 "\n", "\t", "1", "23", " . ", ".",	 "..", "5",	 "0x",	"\"", "'", "\\",
+		"/*", "*/",	 "//", "/",	 "*",  ">>", ">", "=",	"+=",  "(",	 ")",  ";",	 "<<=", "{",  "}", "x.y",
+	};
+
+	std::mt19937 random(12345);
+	auto pick_fragments = [&](size_t count) {
+		std::string str;
+		for (size_t i = 0; i != count; ++i) {
+			str += fragments[random() % std::size(fragments)];
+		}
+		return str;
+	};
+
+	for (auto comment_mode : {cero::CommentMode::Discard, cero::CommentMode::Tokens, cero::CommentMode::Trivia}) {
+		for (int run = 0; run != 20; ++run) {
+			std::string text = pick_fragments(100);
+			RecordingReporter r;
+			auto stream = cero::lex(make_test_source(text), r, comment_mode);
+
+			for (int edit_index = 0; edit_index != 50; ++edit_index) {
+				CAPTURE(text);
+				const auto offset = static_cast<cero::SourceOffset>(random() % (text.length() + 1));
+				const auto old_length = static_cast<uint32_t>(random() % std::min<size_t>(text.length() - offset + 1, 8));
+				const auto replacement = pick_fragments(random() % 4);
+
+				cero::SourceEdit edit {offset, old_length, static_cast<uint32_t>(replacement.length())};
+				stream = check_relex_matches_lex(stream, text, edit, replacement, comment_mode);
+			}
+		}
+	}
+}
+
+} // namespace tests
@@ -0,0 +1,100 @@
+#include "common/RecordingReporter.hpp"
+#include "common/SyntaxChecks.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/Parse.hpp>
+
+#include <memory>
+#include <random>
+
+namespace tests {
+
+/// Applies the edit to a copy of the text and checks that reparsing after the edit gives the same AST as parsing the edited
+/// text. The reparsed AST and the relexed token stream replace the old ones, and the names in the AST refer to the copy.
+static void check_reparse_matches_parse(cero::Ast& ast,
+										cero::TokenStream& stream,
+										std::unique_ptr<std::string>& text,
+										cero::SourceEdit edit,
+										std::string_view replacement) {
+	const auto old_source = make_test_source(*text);
+	auto new_text = std::make_unique<std::string>(*text);
+	new_text->replace(edit.offset, edit.old_length, replacement);
+	const auto source = make_test_source(*new_text);
+
+	RecordingReporter lex_reporter;
+	auto new_stream = cero::relex(stream, source, edit, lex_reporter, cero::CommentMode::Discard);
+
+	RecordingReporter expected_reporter;
+	auto expected = cero::parse(new_stream, source, expected_reporter);
+
+	RecordingReporter r;
+	auto reparsed = cero::reparse(ast, stream, old_source, new_stream, source, edit, r);
+
+	check_same_ast(expected, reparsed, source);
+
+	// only the diagnostics from the reparsed definitions are reported again
+	for (auto& report : r.reports) {
+		CHECK(std::find(expected_reporter.reports.begin(), expected_reporter.reports.end(), report)
+			  != expected_reporter.reports.end());
+	}
+
+	ast = std::move(reparsed);
+	stream = std::move(new_stream);
+	text = std::move(new_text);
+}
+
+CERO_TEST(ReparseRandomEdits) {
+	// The letters o, m and s are left out of the text and the fragments, so that edits cannot form the keywords of constructs
+	// that the parser does not support yet.
+	constexpr std::string_view definition = R"_____(
+public f(int32 a, Lit<int32> b) -> int32 {
+	let x = a + b[0] * 2;
+	if a < b.length() {
+		return g<int32>(x);
+	}
+	while x > 0 {
+		x -= 1;
+	}
+	return a < x >> 2;
+}
+
+private g(int32) {
+	{ let y = { return; }; }
+	return ;
+}
+)_____";
+
+	constexpr std::string_view fragments[] {
+		"a",  "x",	 "f",  "int32 ", " ",	"\n", "1",	"(",  ")",	 "{",  "}", ";",	  ",",		 "<", ">",
+		"<<", ">>", "=",	"+",	  "->",	"[",  "]",	".",  "let ", "if ", "return ", "public ", "private ",
+	};
+
+	std::mt19937 random(12345);
+	for (int run = 0; run != 10; ++run) {
+		auto text = std::make_unique<std::string>();
+		for (int i = 0; i != 8; ++i) {
+			*text += definition;
+		}
+
+		RecordingReporter r;
+		auto stream = cero::lex(make_test_source(*text), r, cero::CommentMode::Discard);
+		auto ast = cero::parse(stream, make_test_source(*text), r);
+
+		for (int edit_index = 0; edit_index != 50; ++edit_index) {
+			CAPTURE(*text);
+			const auto offset = static_cast<cero::SourceOffset>(random() % (text->length() + 1));
+			const auto old_length = static_cast<uint32_t>(random() % std::min<size_t>(text->length() - offset + 1, 8));
+
+			std::string replacement;
+			for (auto count = random() % 4; count != 0; --count) {
+				replacement += fragments[random() % std::size(fragments)];
+			}
+
+			cero::SourceEdit edit {offset, old_length, static_cast<uint32_t>(replacement.length())};
+			check_reparse_matches_parse(ast, stream, text, edit, replacement);
+		}
+	}
+}
+
+} // namespace tests
@@ -0,0 +1,144 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/RecordingReporter.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Parse.hpp>
+#include <cero/syntax/StreamingTokenCursor.hpp>
+#include <cero/syntax/TokenCursor.hpp>
+
+namespace tests {
+
+static void check_cursors_agree(cero::TokenCursor& expected, cero::StreamingTokenCursor& actual, uint32_t num_tokens) {
+	for (uint32_t i = 0; i != num_tokens; ++i) {
+		CHECK_EQ(expected.peek_ahead().offset, actual.peek_ahead().offset);
+		auto expected_token = expected.next();
+		auto actual_token = actual.next();
+		CHECK_EQ(expected_token.kind, actual_token.kind);
+		CHECK_EQ(expected_token.offset, actual_token.offset);
+	}
+}
+
+CERO_TEST(StreamingTokenCursorSlidesOverSource) {
+	std::string text;
+	for (int i = 0; i != 5000; ++i) {
+		text += "let abc = 1.5 + x; // comment\n";
+	}
+	auto source = make_test_source(text);
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	cero::TokenWindow window(source, r);
+
+	cero::TokenCursor expected(tokens);
+	cero::StreamingTokenCursor actual(window);
+	check_cursors_agree(expected, actual, tokens.num_tokens());
+	CHECK_EQ(actual.peek_kind(), cero::TokenKind::EndOfFile);
+	CHECK_EQ(actual.get_lexeme(source), "");
+
+	// a single cursor only ever needs the window to hold a few tokens
+	CHECK_EQ(window.get_capacity(), cero::TokenWindow::MinCapacity);
+}
+
+CERO_TEST(StreamingTokenCursorKeepsTokensForCopies) {
+	std::string text;
+	for (int i = 0; i != 5000; ++i) {
+		text += "a.b ";
+	}
+	auto source = make_test_source(text);
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	cero::TokenWindow window(source, r);
+
+	cero::TokenCursor expected(tokens);
+	cero::StreamingTokenCursor actual(window);
+	check_cursors_agree(expected, actual, 10);
+
+	auto expected_saved = expected;
+	auto actual_saved = actual;
+	check_cursors_agree(expected, actual, 3000);
+	CHECK_GT(window.get_capacity(), 3000u);
+
+	expected = expected_saved;
+	actual = actual_saved;
+	CHECK_EQ(actual.get_lexeme(source), expected.get_lexeme(source));
+	check_cursors_agree(expected, actual, tokens.num_tokens() - 10);
+}
+
+CERO_TEST(ParseStreamingMatchesTokenStream) {
+	// Long generic argument lists make the parser look far ahead before it goes back to where the list began.
+	std::string arguments = "int32";
+	for (int i = 0; i != 400; ++i) {
+		arguments += ", List<int32>";
+	}
+
+	std::string text;
+	for (int i = 0; i != 100; ++i) {
+		text += "f() -> bool {\n";
+		text += "\tlet a = Map<" + arguments + ">(1, 2);\n";
+		text += "\tlet b = x < y;\n";
+		text += "\treturn g(x < " + arguments + ", y > 5);\n";
+		text += "}\n";
+	}
+	auto source = make_test_source(text);
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	auto expected = cero::parse(tokens, source, r);
+	auto actual = cero::parse(source, r);
+	CHECK_EQ(expected.to_string(source), actual.to_string(source));
+}
+
+CERO_TEST(ParseStreamingReportsInSameOrder) {
+	// Syntax errors come before and after lexical errors, which are reported first when the tokens are lexed in full.
+	std::string text;
+	for (int i = 0; i != 200; ++i) {
+		text += "f() {\n";
+		text += "\tlet = 1;\n";
+		text += "\tlet c = 'x;\n";
+		text += "\treturn (;\n";
+		text += "}\n";
+	}
+	auto source = make_test_source(text);
+
+	RecordingReporter expected_reporter;
+	auto tokens = cero::lex(source, expected_reporter, cero::CommentMode::Discard);
+	auto expected = cero::parse(tokens, source, expected_reporter);
+
+	RecordingReporter r;
+	auto actual = cero::parse(source, r);
+	CHECK_EQ(expected.to_string(source), actual.to_string(source));
+	CHECK(expected_reporter.reports == r.reports);
+	CHECK_EQ(r.reports.size(), 600u);
+}
+
+CERO_TEST(ParseStreamingRecoversLikeTokenStream) {
+	// Recovering jumps over blocks far longer than the window is at first, and over brackets that are never closed.
+	std::string block;
+	for (int i = 0; i != 300; ++i) {
+		block += "\t\ta;\n";
+	}
+
+	std::string text;
+	for (int i = 0; i != 20; ++i) {
+		text += "f) {\n\tstruct;\n" + block + "}\n";
+		text += "public g() {\n";
+		text += "\tlet x = 1 {\n" + block + "\t};\n";
+		text += "\tlet y = 1 (a;\n";
+		text += "\treturn [b};\n";
+		text += "}\n";
+	}
+	auto source = make_test_source(text);
+
+	RecordingReporter expected_reporter;
+	auto tokens = cero::lex(source, expected_reporter, cero::CommentMode::Discard);
+	auto expected = cero::parse(tokens, source, expected_reporter);
+
+	RecordingReporter r;
+	auto actual = cero::parse(source, r);
+	CHECK_EQ(expected.to_string(source), actual.to_string(source));
+	CHECK(expected_reporter.reports == r.reports);
+	CHECK(!r.reports.empty());
+}
+
+} // namespace tests
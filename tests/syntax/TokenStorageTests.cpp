@@ -0,0 +1,51 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/TokenCursor.hpp>
+
+namespace tests {
+
+CERO_TEST(TokenStorageGrowsForDenseSource) {
+	// two bytes per token is far denser than the reservation expects, so the stream needs several segments
+	std::string text;
+	for (int i = 0; i != 5000; ++i) {
+		text += "a;";
+	}
+	auto source = make_test_source(text);
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	REQUIRE_EQ(tokens.num_tokens(), 10001);
+
+	cero::TokenCursor c(tokens);
+	for (uint32_t i = 0; i != 5000; ++i) {
+		CHECK_EQ(c.peek_offset(), 2 * i);
+		CHECK_EQ(c.get_lexeme(source), "a");
+		CHECK(c.match(cero::TokenKind::Name));
+		CHECK_EQ(c.get_lexeme(source), ";");
+		CHECK(c.match(cero::TokenKind::Semicolon));
+	}
+	CHECK(c.match(cero::TokenKind::EndOfFile));
+
+	auto stats = tokens.get_storage_stats();
+	CHECK_EQ(stats.used_bytes, 10001 * (sizeof(cero::Token) + sizeof(uint32_t)));
+	CHECK_EQ(stats.reserved_bytes, stats.used_bytes);
+	CHECK_GT(stats.peak_reserved_bytes, stats.reserved_bytes);
+}
+
+CERO_TEST(TokenStorageShrinksForSparseSource) {
+	std::string text(10000, ' ');
+	text += "a";
+	auto source = make_test_source(text);
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Discard);
+	REQUIRE_EQ(tokens.num_tokens(), 2);
+
+	auto stats = tokens.get_storage_stats();
+	CHECK_EQ(stats.used_bytes, 2 * (sizeof(cero::Token) + sizeof(uint32_t)));
+	CHECK_LT(stats.reserved_bytes, stats.peak_reserved_bytes);
+}
+
+} // namespace tests
@@ -0,0 +1,102 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/SyntaxChecks.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/TokenStreamBinary.hpp>
+
+#include <cstring>
+#include <optional>
+
+namespace tests {
+
+static constexpr std::string_view BinarySourceText = R"_____(
+// a comment
+f(int32 a) -> int32 {
+	return g((a + 1) * [2][0]);
+}
+)_____";
+
+/// Writes the token stream in the binary format.
+static std::string write_binary(const cero::TokenStream& stream) {
+	cero::BinaryWriter writer;
+	cero::write_binary_token_stream(writer, stream);
+	return std::string(writer.get_bytes());
+}
+
+static std::optional<cero::TokenStreamBinaryView> view_binary(std::string_view bytes) {
+	cero::BinaryReader reader(bytes);
+	auto view = cero::TokenStreamBinaryView::from(reader);
+	if (view && reader.num_remaining_bytes() != 0) {
+		return std::nullopt;
+	}
+	return view;
+}
+
+CERO_TEST(TokenStreamBinaryRoundTrip) {
+	auto source = make_test_source(BinarySourceText);
+	ExhaustiveReporter r;
+	auto stream = cero::lex(source, r, cero::CommentMode::Trivia);
+
+	const auto bytes = write_binary(stream);
+	auto view = view_binary(bytes);
+	REQUIRE(view);
+	CHECK_EQ(view->num_tokens(), stream.num_tokens());
+	CHECK_EQ(view->has_errors(), stream.has_errors());
+	check_same_tokens(stream, view->to_token_stream());
+
+	// the tokens are read in place instead of being decoded
+	CHECK_GE(view->raw().data(), static_cast<const void*>(bytes.data()));
+	CHECK_LE(static_cast<const void*>(view->raw().data() + view->num_tokens()), bytes.data() + bytes.size());
+}
+
+CERO_TEST(TokenStreamBinaryRejectsInvalidBytes) {
+	auto source = make_test_source(BinarySourceText);
+	ExhaustiveReporter r;
+	const auto stream = cero::lex(source, r, cero::CommentMode::Trivia);
+	const auto bytes = write_binary(stream);
+	const auto view = view_binary(bytes);
+	REQUIRE(view);
+
+	for (size_t length = 0; length < bytes.size(); length += 5) {
+		CHECK(!view_binary(std::string_view(bytes).substr(0, length)));
+	}
+
+	auto wrong_version = bytes;
+	wrong_version[offsetof(cero::TokenStreamBinaryHeader, format_version)] += 1;
+	CHECK(!view_binary(wrong_version));
+
+	std::string misaligned = ' ' + bytes;
+	CHECK(!view_binary(std::string_view(misaligned).substr(1)));
+
+	// replaces the value at the given address within the bytes of the view, keeping the rest as they are
+	auto with_value = [&](const void* address, auto value) {
+		auto changed = bytes;
+		std::memcpy(changed.data() + (static_cast<const char*>(address) - bytes.data()), &value, sizeof(value));
+		return changed;
+	};
+	const auto tokens = view->raw();
+	const auto closing = view->raw_closing_brackets();
+	const auto open_index = static_cast<size_t>(std::find_if(tokens.begin(), tokens.end(), [](cero::Token token) {
+		return token.kind == cero::TokenKind::LParen;
+	}) - tokens.begin());
+	REQUIRE_NE(closing[open_index], cero::BracketPair::Unclosed);
+
+	// unknown kinds of tokens, and end-of-file tokens anywhere but at the end
+	CHECK(!view_binary(with_value(&tokens[0], uint8_t(255))));
+	CHECK(!view_binary(with_value(&tokens[0], cero::TokenKind::EndOfFile)));
+	CHECK(!view_binary(with_value(&tokens.back(), cero::TokenKind::Semicolon)));
+
+	// closing tokens that come before their bracket, at or after the end-of-file token, or for tokens that are no bracket
+	CHECK(!view_binary(with_value(&closing[open_index], uint32_t(open_index))));
+	CHECK(!view_binary(with_value(&closing[open_index], view->num_tokens() - 1)));
+	CHECK(!view_binary(with_value(&closing[open_index + 1], closing[open_index])));
+
+	// trivia followed by no token
+	CHECK(!view_binary(with_value(&view->raw_trivia()[0].next_token, view->num_tokens())));
+
+	// changing a token in a way that keeps the stream valid is accepted
+	CHECK(view_binary(with_value(&view->raw_lengths()[0], uint32_t(7))));
+}
+
+} // namespace tests
@@ -0,0 +1,79 @@
+#include "common/ExhaustiveReporter.hpp"
+#include "common/Test.hpp"
+
+#include <cero/syntax/Lex.hpp>
+#include <cero/syntax/Parse.hpp>
+#include <cero/syntax/TokenCursor.hpp>
+#include <cero/syntax/TokenStreamBinary.hpp>
+
+namespace tests {
+
+constexpr cero::SourceOffset SegmentLength = cero::SourceSegmentLength;
+
+CERO_TEST(LexWideOffsets) {
+	// The second source segment holds no token at all, so the third one begins with the same token.
+	std::string text = "a /* x */\n" + std::string(SegmentLength, ' ') + "bb // y\n" + std::string(2 * SegmentLength, ' ')
+					   + "ccc";
+	auto source = make_test_source(text);
+
+	ExhaustiveReporter r;
+	auto tokens = cero::lex(source, r, cero::CommentMode::Trivia);
+	REQUIRE_EQ(tokens.num_tokens(), 4u);
+
+	const auto segment_starts = tokens.raw_source_segment_starts();
+	REQUIRE_EQ(segment_starts.size(), 3u);
+	CHECK_EQ(segment_starts[0], 1u);
+	CHECK_EQ(segment_starts[1], 2u);
+	CHECK_EQ(segment_starts[2], 2u);
+
+	const cero::SourceOffset expected_offsets[] {0, SegmentLength + 10, 3 * SegmentLength + 18, 3 * SegmentLength + 21};
+	const std::string_view expected_lexemes[] {"a", "bb", "ccc", ""};
+
+	cero::TokenCursor cursor(tokens);
+	for (uint32_t i = 0; i != tokens.num_tokens(); ++i) {
+		CHECK_EQ(tokens.get_offset(i), expected_offsets[i]);
+		CHECK_EQ(cursor.get_lexeme(source), expected_lexemes[i]);
+		CHECK_EQ(cursor.next().offset, expected_offsets[i]);
+	}
+
+	const auto trivia = tokens.raw_trivia();
+	REQUIRE_EQ(trivia.size(), 2u);
+	CHECK_EQ(trivia[1].offset, SegmentLength + 13);
+	CHECK_EQ(trivia[1].next_token, 2u);
+
+	// the binary format stores the source segments along with the tokens
+	cero::BinaryWriter writer;
+	cero::write_binary_token_stream(writer, tokens);
+	cero::BinaryReader reader(writer.get_bytes());
+	auto view = cero::TokenStreamBinaryView::from(reader);
+	REQUIRE(view);
+	auto read_tokens = view->to_token_stream();
+	CHECK(std::ranges::equal(read_tokens.raw_source_segment_starts(), segment_starts));
+	CHECK_EQ(read_tokens.to_string(source), tokens.to_string(source));
+}
+
+CERO_TEST(ParseWideOffsets) {
+	const std::string text = "a() {\n}\n" + std::string(SegmentLength, ' ') + "\nb() {\n\treturn 1;\n}\n";
+	auto source = make_test_source(text);
+
+	ExhaustiveReporter r;
+	auto ast = cero::parse(source, r);
+	CHECK(!ast.has_errors());
+
+	auto str = ast.to_string(source);
+	auto expected = R"_____(AST for ParseWideOffsets (5 nodes)
+├── function `a` [1:1]
+│   ├── parameters
+│   ├── outputs
+│   └── statements
+└── function `b` [4:1]
+    ├── parameters
+    ├── outputs
+    └── statements
+        └── return [5:5]
+            └── decimal literal ` ---TODO--- ` [5:12]
+)_____";
+	CHECK_EQ(str, expected);
+}
+
+} // namespace tests
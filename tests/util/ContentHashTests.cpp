@@ -0,0 +1,84 @@
+#include "common/Test.hpp"
+
+#include <cero/driver/CacheKey.hpp>
+#include <cero/util/ContentHash.hpp>
+
+namespace tests {
+
+CERO_TEST(ContentHashMatchesXxh3) {
+	// the sanity test vectors of xxHash, whose input is generated from a fixed start value
+	std::string input(2367, '\0');
+	uint64_t generator = 2654435761u;
+	for (char& c : input) {
+		c = static_cast<char>(generator >> 56);
+		generator *= 11400714785074694797u;
+	}
+
+	struct Vector {
+		size_t length;
+		cero::ContentHash unseeded;
+		cero::ContentHash seeded;
+	};
+	const Vector vectors[] {
+		{0, {0x6001c324468d497f, 0x99aa06d3014798d8}, {0xa986dfc5d7605bfe, 0x00feaa732a3ce25e}},
+		{1, {0xc44bdff4074eecdb, 0xa6cd5e9392000f6a}, {0x032be332dd766ef8, 0x20e49abcc53b3842}},
+		{6, {0x3e7039bdda43cfc6, 0x082afe0b8162d12a}, {0xc5b54d56038e4e40, 0x014bd95a51ca5ddb}},
+		{12, {0x061a192713f69ad9, 0x6e3efd8fc7802b18}, {0x5d92b5d7190b12d1, 0xff0d60acd02ed401}},
+		{24, {0x1e7044d28b1b901d, 0x0ce966e4678d3761}, {0xc6cbf92a70680b19, 0xd7895ded1f62559d}},
+		{48, {0xf942219aed80f67b, 0xa002ac4e5478227e}, {0x3a94d91333ed395a, 0xbc689f4c0152fb44}},
+		{80, {0x454ae6bf7a8a532d, 0xfdf2cefde9eaac8a}, {0xa5eac764d1ff1166, 0x19bf02d69bc56833}},
+		{195, {0x3fb593c086a66075, 0x7729543a26b207ee}, {0xcf9d9ec2c8c9913f, 0x0326104c4d4849e7}},
+		{222, {0xf1aebd597cec6b3a, 0x337e09641b948717}, {0xc5871b3be4506a30, 0x4740af1ae0618b49}},
+		{403, {0xcdeb804d65c6dea4, 0x1b6de21e332dd73d}, {0x6259f6ecfd6443fd, 0xbed311971e0be8f2}},
+		{512, {0x617e49599013cb6b, 0x18d2d110dcc9bca1}, {0x3ce457de14c27708, 0x925d06b8ec5b8040}},
+		{2048, {0xdd59e2c3a5f038e0, 0xf736557fd47073a5}, {0x66f81670669ababc, 0x23cc3a2e75ebaaea}},
+		{2240, {0x6e73a90539cf2948, 0xccb134fbfa7ce49d}, {0x757ba8487d1b5247, 0xe40842f585875ba9}},
+		{2367, {0xcb37aeb9e5d361ed, 0xe89c0f6ff369b427}, {0xd2db3415b942b42a, 0xccb7a94cca1a6496}},
+	};
+	for (auto& vector : vectors) {
+		const auto bytes = std::string_view(input).substr(0, vector.length);
+		CHECK_EQ(cero::ContentHash::of(bytes), vector.unseeded);
+		CHECK_EQ(cero::ContentHash::of(bytes, 0x9E3779B185EBCA8D), vector.seeded);
+	}
+	CHECK_EQ(cero::ContentHash::of("main() {}").to_string(), "2f93c8954639a6b032644e20eecbd223");
+}
+
+CERO_TEST(ContentHashDistinguishesSimilarInputs) {
+	std::string text(3000, 'x');
+	std::vector<cero::ContentHash> hashes;
+	for (size_t length : {0u, 1u, 63u, 64u, 65u, 1023u, 1024u, 1025u, 3000u}) {
+		hashes.emplace_back(cero::ContentHash::of(std::string_view(text).substr(0, length)));
+	}
+
+	// flipping a single bit anywhere, or padding with zero bytes, must change the hash
+	for (size_t i : {0u, 7u, 8u, 63u, 64u, 1500u, 2999u}) {
+		auto changed = text;
+		changed[i] ^= 1;
+		hashes.emplace_back(cero::ContentHash::of(changed));
+	}
+	hashes.emplace_back(cero::ContentHash::of(std::string_view("\0", 1)));
+	hashes.emplace_back(cero::ContentHash::of(text + std::string(64, '\0')));
+
+	for (size_t i = 0; i != hashes.size(); ++i) {
+		for (size_t j = i + 1; j != hashes.size(); ++j) {
+			CHECK_NE(hashes[i], hashes[j]);
+		}
+	}
+}
+
+CERO_TEST(CacheKeyDependsOnContentAndOptions) {
+	cero::Configuration config;
+	auto a = make_test_source("main() {}", config);
+	auto b = make_test_source("main() { }", config);
+	const auto key = cero::CacheKey::of(a, config);
+	CHECK_EQ(key, cero::CacheKey::of(make_test_source("main() {}", config), config));
+	CHECK_NE(key, cero::CacheKey::of(b, config));
+
+	// printing options do not affect what would be cached, but the tab size affects diagnostic locations
+	config.print_ast = true;
+	CHECK_EQ(key, cero::CacheKey::of(a, config));
+	config.tab_size = 8;
+	CHECK_NE(key, cero::CacheKey::of(a, config));
+}
+
+} // namespace tests
@@ -0,0 +1,63 @@
+#include "common/Test.hpp"
+
+#include <cero/util/ThreadPool.hpp>
+
+namespace tests {
+
+CERO_TEST(ThreadPoolRunsEveryIndexOnce) {
+	cero::ThreadPool pool(4);
+	CHECK_EQ(pool.num_threads(), 4);
+
+	for (uint32_t num_tasks : {0u, 1u, 3u, 100u, 1000u}) {
+		std::vector<std::atomic<uint32_t>> counts(num_tasks);
+		pool.for_each_index(num_tasks, [&](uint32_t index) {
+			++counts[index];
+		});
+
+		for (auto& count : counts) {
+			CHECK_EQ(count.load(), 1);
+		}
+	}
+}
+
+CERO_TEST(ThreadPoolWithoutWorkers) {
+	cero::ThreadPool pool(1);
+	CHECK_EQ(pool.num_threads(), 1);
+
+	uint32_t sum = 0;
+	pool.for_each_index(10, [&](uint32_t index) {
+		sum += index;
+	});
+	CHECK_EQ(sum, 45);
+}
+
+CERO_TEST(ThreadPoolRethrowsExceptionOfTask) {
+	cero::ThreadPool pool(4);
+
+	// whichever thread the throwing index runs on, the exception must reach the submitting thread
+	for (uint32_t throwing_index : {0u, 1u, 57u, 99u}) {
+		bool caught = false;
+		try {
+			pool.for_each_index(100, [&](uint32_t index) {
+				if (index == throwing_index) {
+					throw std::runtime_error("task failed");
+				}
+			});
+		} catch (const std::runtime_error& error) {
+			caught = true;
+			CHECK_EQ(std::string_view(error.what()), "task failed");
+		}
+		CHECK(caught);
+	}
+
+	// the pool must still be usable after a batch failed
+	std::vector<std::atomic<uint32_t>> counts(100);
+	pool.for_each_index(100, [&](uint32_t index) {
+		++counts[index];
+	});
+	for (auto& count : counts) {
+		CHECK_EQ(count.load(), 1);
+	}
+}
+
+} // namespace tests